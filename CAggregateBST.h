@@ -0,0 +1,193 @@
+// ============================================================================
+// File: CAggregateBST.h
+// ============================================================================
+// Header file for the class CAggregateBST (CBST answering range aggregates)
+// and the aggregate policies it is used with.
+// ============================================================================
+
+#ifndef CAGGREGATEBST_HEADER
+#define CAGGREGATEBST_HEADER
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include "CBST.h"
+
+// =========================================================================
+//      Aggregate policies
+// =========================================================================
+//
+// An aggregate policy is a monoid over a projection of the items:
+//
+//		ResultType							the type of an aggregate
+//		static ResultType Identity()		the aggregate of no items
+//		static ResultType Lift(item)		the aggregate of one item
+//		static ResultType Combine(a, b)		the aggregate of two adjacent runs
+//
+// Combine must be associative; it does not have to be commutative.
+// =========================================================================
+
+/** Sums Project(item) over the items. */
+template<class ItemType, class ValueType,
+         ValueType (*Project)(const ItemType &item)>
+struct CSumAggregate
+{
+   typedef ValueType ResultType;
+
+   static ResultType Identity() { return ResultType(); }
+   static ResultType Lift(const ItemType &item) { return Project(item); }
+   static ResultType Combine(const ResultType &lhs, const ResultType &rhs)
+   {
+      return lhs + rhs;
+   }
+};
+
+/** Finds the smallest Project(item) over the items. */
+template<class ItemType, class ValueType,
+         ValueType (*Project)(const ItemType &item)>
+struct CMinAggregate
+{
+   typedef ValueType ResultType;
+
+   static ResultType Identity()
+   {
+      return std::numeric_limits<ValueType>::max();
+   }
+   static ResultType Lift(const ItemType &item) { return Project(item); }
+   static ResultType Combine(const ResultType &lhs, const ResultType &rhs)
+   {
+      return (rhs < lhs) ? rhs : lhs;
+   }
+};
+
+/** Finds the largest Project(item) over the items. */
+template<class ItemType, class ValueType,
+         ValueType (*Project)(const ItemType &item)>
+struct CMaxAggregate
+{
+   typedef ValueType ResultType;
+
+   static ResultType Identity()
+   {
+      return std::numeric_limits<ValueType>::lowest();
+   }
+   static ResultType Lift(const ItemType &item) { return Project(item); }
+   static ResultType Combine(const ResultType &lhs, const ResultType &rhs)
+   {
+      return (lhs < rhs) ? rhs : lhs;
+   }
+};
+
+template<class ItemType, class Aggregate>
+class CAggregateBST : public CBST<ItemType>
+{
+public:
+   typedef typename CBST<ItemType>::KeyType KeyType;
+   typedef typename Aggregate::ResultType ResultType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree. */
+   CAggregateBST();
+
+   /** Copy constructor.  The aggregates are rebuilt on first use. */
+   CAggregateBST(const CAggregateBST<ItemType, Aggregate> &tree);
+
+   /** Destructor. */
+   virtual ~CAggregateBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Combines Aggregate over every item whose key lies in the closed range
+       [low, high], in key order.  Runs in O(log n); the first call after
+       the tree changes first rebuilds the aggregates in O(n), which is the
+       same order of work as the CBST rebuild that the change triggered.
+       Like every const CBST read, it is safe to call from several threads
+       at once; the rebuild is done by one of them.
+    @param low: The smallest key to include.
+    @param high: The largest key to include.
+    @return  The aggregate, or Aggregate::Identity() if no key is in range. */
+   ResultType AggregateRange(const KeyType &low, const KeyType &high) const;
+
+   /** Combines Aggregate over every item in the tree.
+    @param Nothing.
+    @return  The aggregate of the whole tree. */
+   ResultType AggregateAll() const;
+
+   /** Overloaded assignment operator.
+    @param rhs: A const CAggregateBST reference object.
+    @return  CAggregateBST reference object. */
+   CAggregateBST<ItemType, Aggregate>& operator=(
+                           const CAggregateBST<ItemType, Aggregate> &rhs);
+
+protected:
+   // =========================================================================
+   //      Protected Member Functions
+   // =========================================================================
+
+   /** Marks the aggregates as stale.
+    @return  nothing */
+   void OnContentsChanged() override;
+
+private:
+   // Receives the items from CBST::ExportColumns: their keys go to m_keys
+   // and their lifted aggregates to the front of m_nodes, so no item is
+   // copied
+   struct CLiftColumns
+   {
+      void Clear()
+      {
+         m_keys.clear();
+         m_leaves.clear();
+      }
+
+      void Append(const ItemType &item)
+      {
+         m_keys.push_back(CKeyTraits<ItemType>::GetKey(item));
+         m_leaves.push_back(Aggregate::Lift(item));
+      }
+
+      std::vector<KeyType>      &m_keys;
+      std::vector<ResultType>   &m_leaves;
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Rebuilds the sorted keys and the aggregate tree if the items changed
+       since they were last built.
+    @return  nothing */
+   void Refresh() const;
+
+   /** Rebuilds the sorted keys and the aggregate tree from the items.
+    @return  nothing */
+   void Rebuild() const;
+
+   /** Combines the leaves in positions [first, last) of the aggregate tree.
+    @param first: The first sorted position to include.
+    @param last: One past the last sorted position to include.
+    @return  The aggregate of the positions. */
+   ResultType Query(size_t first, size_t last) const;
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   // Both arrays are derived from the items and rebuilt lazily, so they are
+   // mutable to let the const queries refresh them.  Concurrent queries
+   // rebuild them under m_rebuildLock; m_stale is read without it.
+   mutable std::vector<KeyType>      m_keys;       // Keys in sorted order
+   mutable std::vector<ResultType>   m_nodes;      // Implicit aggregate tree
+   mutable std::atomic<bool>         m_stale;      // Items changed since
+   mutable std::mutex                m_rebuildLock;
+}; // end CAggregateBST
+
+#include "CAggregateBST.tpp"
+
+#endif  // CAGGREGATEBST_HEADER
@@ -0,0 +1,278 @@
+// ============================================================================
+// File: CAggregateBST.tpp
+// ============================================================================
+// This is the implementation file for the class CAggregateBST.  Every item
+// is lifted into the aggregate and stored, in key order, in the leaves of an
+// implicit binary tree (leaf i at m_nodes[n + i], node k combining 2k and
+// 2k + 1).  Any key range is a run of consecutive leaves, so it is answered
+// by combining O(log n) nodes.
+// ============================================================================
+
+#include <algorithm>
+#include "CAggregateBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+CAggregateBST<ItemType, Aggregate>::CAggregateBST() : m_stale(true)
+{
+
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the items of the tree.  The aggregates are rebuilt on first use.
+//
+// Input:
+//		tree	[IN] - a const CAggregateBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+CAggregateBST<ItemType, Aggregate>::CAggregateBST(
+			const CAggregateBST<ItemType, Aggregate> &tree) :
+			CBST<ItemType>(tree), m_stale(true)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST releases.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+CAggregateBST<ItemType, Aggregate>::~CAggregateBST()
+{
+
+}
+
+
+
+// ==== AggregateRange ========================================================
+//
+// Combines Aggregate over every item whose key lies in [low, high].
+//
+// Input:
+//		low		[IN] - the smallest key to include
+//		high	[IN] - the largest key to include
+//
+// Output:
+//		ResultType  -  the aggregate, or Identity() if no key is in range
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+typename CAggregateBST<ItemType, Aggregate>::ResultType
+CAggregateBST<ItemType, Aggregate>::AggregateRange(const KeyType &low,
+												   const KeyType &high) const
+{
+	Refresh();
+
+	if (high < low)
+	{
+		return Aggregate::Identity();
+	}
+
+	size_t first = std::lower_bound(m_keys.begin(), m_keys.end(), low) -
+				   m_keys.begin();
+	size_t last = std::upper_bound(m_keys.begin(), m_keys.end(), high) -
+				  m_keys.begin();
+
+	return Query(first, last);
+}
+
+
+
+// ==== AggregateAll ==========================================================
+//
+// Combines Aggregate over every item in the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		ResultType  -  the aggregate of the whole tree
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+typename CAggregateBST<ItemType, Aggregate>::ResultType
+CAggregateBST<ItemType, Aggregate>::AggregateAll() const
+{
+	Refresh();
+
+	return Query(0, m_keys.size());
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the items of rhs.  CBST's assignment reports the change through
+// OnContentsChanged, so the aggregates are rebuilt on first use.
+//
+// Input:
+//		rhs	[IN] - A const CAggregateBST reference object.
+//
+// Output:
+//		CAggregateBST - a CAggregateBST reference object
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+CAggregateBST<ItemType, Aggregate>&
+CAggregateBST<ItemType, Aggregate>::operator=(
+						const CAggregateBST<ItemType, Aggregate> &rhs)
+{
+	CBST<ItemType>::operator=(rhs);
+
+	return *this;
+}
+
+
+
+// ==== OnContentsChanged =====================================================
+//
+// Marks the aggregates as stale.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+void CAggregateBST<ItemType, Aggregate>::OnContentsChanged()
+{
+	m_stale.store(true, std::memory_order_release);
+}
+
+
+
+// ==== Refresh ===============================================================
+//
+// Rebuilds the aggregates if the items changed since they were last built.
+// A query that finds them stale takes m_rebuildLock and checks again, so
+// of several concurrent queries only the first rebuilds and the others
+// wait for it; once they are fresh no lock is taken.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+void CAggregateBST<ItemType, Aggregate>::Refresh() const
+{
+	if (!m_stale.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_rebuildLock);
+	if (m_stale.load(std::memory_order_relaxed))
+	{
+		Rebuild();
+		m_stale.store(false, std::memory_order_release);
+	}
+}
+
+
+
+// ==== Rebuild ===============================================================
+//
+// Rebuilds the sorted keys and the aggregate tree from the items in one
+// in-order pass over the nodes plus one bottom-up pass.  The pass lifts
+// each item where it lies into the front of m_nodes, and the leaves are
+// then moved up to their place in the back half.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+void CAggregateBST<ItemType, Aggregate>::Rebuild() const
+{
+	CLiftColumns columns = {m_keys, m_nodes};
+	CBST<ItemType>::ExportColumns(columns);
+
+	size_t count = m_keys.size();
+	m_nodes.resize(2 * count, Aggregate::Identity());
+	std::copy(m_nodes.begin(), m_nodes.begin() + count,
+			  m_nodes.begin() + count);
+
+	for (size_t node = count - 1; count > 0 && node > 0; --node)
+	{
+		m_nodes[node] = Aggregate::Combine(m_nodes[2 * node],
+										   m_nodes[2 * node + 1]);
+	}
+}
+
+
+
+// ==== Query =================================================================
+//
+// Combines the leaves in positions [first, last).  The left and right edges
+// are accumulated separately so the result keeps key order even when
+// Combine is not commutative.
+//
+// Input:
+//		first	[IN] - the first sorted position to include
+//		last	[IN] - one past the last sorted position to include
+//
+// Output:
+//		ResultType  -  the aggregate of the positions
+//
+// ============================================================================
+template<class ItemType, class Aggregate>
+typename CAggregateBST<ItemType, Aggregate>::ResultType
+CAggregateBST<ItemType, Aggregate>::Query(size_t first, size_t last) const
+{
+	ResultType leftResult = Aggregate::Identity();
+	ResultType rightResult = Aggregate::Identity();
+	size_t count = m_keys.size();
+
+	for (first += count, last += count; first < last;
+		 first = first / 2, last = last / 2)
+	{
+		if (first & 1)
+		{
+			leftResult = Aggregate::Combine(leftResult, m_nodes[first]);
+			++first;
+		}
+		if (last & 1)
+		{
+			--last;
+			rightResult = Aggregate::Combine(m_nodes[last], rightResult);
+		}
+	}
+
+	return Aggregate::Combine(leftResult, rightResult);
+}
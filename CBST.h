@@ -12,11 +12,24 @@
 #include "CBinaryNodeTree.h"
 #include "NotFoundException.h"
 #include "PrecondViolatedExcept.h"
+#include "CSnapshotIO.h"
+#include "CDumpWriter.h"
+#include "CKeyTraits.h"
+#include "CTreeInstrument.h"
+
+#include <string>
+#include <vector>
+
+// Number of keys ContainsBatch and GetEntryBatch walk down the tree together
+const int BST_BATCH_LANES = 32;
 
 template<class ItemType>
 class CBST : public CBinaryNodeTree<ItemType>
 {
 public:
+   /** The part of an item that the tree is ordered by (see CKeyTraits). */
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
    // =========================================================================
    //      Constructors and Destructor
    // =========================================================================
@@ -44,7 +57,7 @@ public:
    /** Checks if m_rootPtr is nullptr
     @param Nothing.
     @return  True if it is empty, or false if it is not. */
-   bool IsEmpty() const override;
+   bool IsEmpty() const noexcept override;
 
    /** Counts the height of the tree by calling the inherited method 
        GetHeightHelper.
@@ -58,18 +71,24 @@ public:
     @return  An int value representing the number of nodes the tree has. */
    int GetNumberOfNodes() const override;
 
+   /** Reports the shape of the tree and the memory its nodes use by calling
+       the inherited function StatsHelper.
+    @param Nothing.
+    @return  A CTreeStats describing the tree. */
+   CTreeStats Stats() const override;
+
    /** Gets the item at root location.
     @param Nothing.
     @return  An ItemType that is located at the root.
     @throw  PrecondViolatedExcept if the tree is empty. */
-   ItemType GetRootData() const throw(PrecondViolatedExcept) override;
+   ItemType GetRootData() const override;
 
    /** Throws an error that you "Cannot change root value in a CBST".
     @param newData: An ItemType that will be assigned/initialzed at the root
                     location.
     @return  Nothing.
     @throw  PrecondViolatedExcept if you call this function. */
-   void SetRootData(const ItemType &newData) const throw(PrecondViolatedExcept);
+   void SetRootData(const ItemType &newData) const;
 
    /** Adds a new node to the tree.  Allocate the new node first and then call
        the function PlaceNode to add the new node to the tree.
@@ -88,17 +107,103 @@ public:
     @return  Nothing. */
    void Clear() override;
 
-   /** Retrieves an entry from the tree.  This function calls FindNode.
+   /** Retrieves an entry from the tree.  This function calls FindOrNull.
     @param anEntry: An ItemType that will be used to retrieve an item.
     @return  Returns an ItemType (the entry if it exists.
     @throw   NotFoundException if the entry does not exists. */
-   ItemType GetEntry(const ItemType &anEntry) const throw(NotFoundException) override;
+   ItemType GetEntry(const ItemType &anEntry) const override;
 
-   /** Checks if an item exists in the tree.  This function calls FindNode.
+   /** Checks if an item exists in the tree.  This function calls FindOrNull.
     @param anEntry: An ItemType that will be used to check if it exists.
     @return  True if found, or false if it is not. */
-   bool Contains(const ItemType &anEntry) const override;
+   bool Contains(const ItemType &anEntry) const noexcept override;
+
+   /** Finds an item in the tree without throwing.  This function calls
+       FindNode.  GetEntry, Contains and TryGetEntry all go through it, so
+       classes that look items up differently only override this.
+    @param anEntry: An ItemType that will be used to find an item.
+    @return  A pointer to the item in the tree, valid until the tree next
+             changes, or nullptr if it is not found. */
+   const ItemType* FindOrNull(const ItemType &anEntry) const noexcept override;
+
+   /** Finds an item with the greatest key not greater than key.
+    @param key: The key to search below.
+    @return  A pointer to the item in the tree, valid until the tree next
+             changes, or nullptr if every key is greater. */
+   const ItemType* Floor(const KeyType &key) const;
+
+   /** Finds an item with the least key not less than key.
+    @param key: The key to search above.
+    @return  A pointer to the item in the tree, or nullptr if every key is
+             less. */
+   const ItemType* Ceiling(const KeyType &key) const;
+
+   /** Finds an item with the greatest key less than key.
+    @param key: The key to search below.
+    @return  A pointer to the item in the tree, or nullptr if there is no
+             smaller key. */
+   const ItemType* Predecessor(const KeyType &key) const;
+
+   /** Finds an item with the least key greater than key.
+    @param key: The key to search above.
+    @return  A pointer to the item in the tree, or nullptr if there is no
+             greater key. */
+   const ItemType* Successor(const KeyType &key) const;
+
+   /** Finds the least item of the tree.
+    @param Nothing.
+    @return  A pointer to the item in the tree, or nullptr if it is empty. */
+   const ItemType* Min() const;
+
+   /** Finds the greatest item of the tree.
+    @param Nothing.
+    @return  A pointer to the item in the tree, or nullptr if it is empty. */
+   const ItemType* Max() const;
+
+   /** Removes and returns the least item of the tree.  Unlike Remove it
+       does not rebalance the tree, so it takes time in the height of the
+       tree, which it never increases.
+    @param Nothing.
+    @return  The item removed.
+    @throw   PrecondViolatedExcept if the tree is empty. */
+   ItemType PopMin();
+
+   /** Removes and returns the greatest item of the tree, the same way as
+       PopMin.
+    @param Nothing.
+    @return  The item removed.
+    @throw   PrecondViolatedExcept if the tree is empty. */
+   ItemType PopMax();
+
+   /** Visits the items lazily in order, starting from the first whose key
+       is not less than key; each step to the next item takes constant time
+       amortized.  See CTreeGenerator.
+    @param key: The least key to visit.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> InorderFrom(const KeyType &key) const;
    
+   /** Checks, for every key of a batch, if the tree holds an item with that
+       key.  The keys are walked down the tree BST_BATCH_LANES at a time, one
+       level per round, and the next node of every key is prefetched before
+       the round moves on, so the cache misses of the keys in flight overlap
+       instead of being paid one after another.
+    @param keys: The keys to look up.
+    @param count: The number of keys.
+    @param results: Receives, for every key, true if it was found.
+    @return  Nothing. */
+   void ContainsBatch(const KeyType keys[], int count, bool results[]) const;
+
+   /** Retrieves, for every key of a batch, an item with that key.  Walks the
+       tree the same way as ContainsBatch.
+    @param keys: The keys to look up.
+    @param count: The number of keys.
+    @param entries: Receives, for every key found, an item with that key
+                    (entries of keys not found are left unchanged).
+    @param found: Receives, for every key, true if it was found.
+    @return  Nothing. */
+   void GetEntryBatch(const KeyType keys[], int count, ItemType entries[],
+                      bool found[]) const;
+
    /** A function used to transverse the tree in preorder.  Calls the inherited
        function Preorder.
     @param Visit: A function that is a void return type and takes an argument
@@ -123,6 +228,84 @@ public:
     @return  Nothing. */
    void PostorderTraverse(void Visit(ItemType &item)) const override;
 
+   /** Visits the items lazily in preorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Preorder() const;
+
+   /** Visits the items lazily in inorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Inorder() const;
+
+   /** Visits the items lazily in postorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Postorder() const;
+
+   /** Visits the items lazily in level order; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> LevelOrder() const;
+
+   /** Calls Visit on every item, spreading the items over the workers of a
+       pool; see CWorkPool.  Visit is called from several threads at once
+       and in no particular order.  It may change the item it is given but
+       not its key.  Calls the inherited function ParallelWalk.
+    @param Visit: A function or function object taking an ItemType&.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  Nothing. */
+   template<class VisitType>
+   void ParallelForEach(VisitType Visit, int grainSize = PARALLEL_GRAIN_SIZE,
+                        CWorkPool &pool = DefaultWorkPool());
+
+   /** Combines Map(item) over every item, spreading the items over the
+       workers of a pool.  Combine must be associative and commutative.
+       Calls the inherited function ParallelReduceHelper.
+    @param Map: A function or function object taking a const ItemType&.
+    @param Combine: Combines two results into one.
+    @param identity: The result of no items.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  The combined result. */
+   template<class ResultType, class MapType, class CombineType>
+   ResultType ParallelReduce(MapType Map, CombineType Combine,
+                             const ResultType &identity,
+                             int grainSize = PARALLEL_GRAIN_SIZE,
+                             CWorkPool &pool = DefaultWorkPool()) const;
+
+   /** A function used to transverse, in order, only the items whose key lies
+       in the closed range [low, high].  Subtrees that cannot hold such a key
+       are skipped.
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that is a void return type and takes an argument
+                  of ItemType.
+    @return  Nothing. */
+   void RangeTraverse(const KeyType &low, const KeyType &high,
+                      void Visit(ItemType &item)) const;
+
+   /** Copies every item of the tree, in order, into a vector.
+    @param items: Receives the items from least to greatest.
+    @return  Nothing. */
+   void GetSortedItems(std::vector<ItemType> &items) const;
+
+   /** Writes every item of the tree, in order, to a set of columns in one
+       pass, after clearing them.  CPersonColumns is such a set for
+       CPersonInfo items.
+    @param columns: Any object with Clear() and Append(const ItemType&).
+    @return  Nothing. */
+   template<class ColumnsType>
+   void ExportColumns(ColumnsType &columns) const;
+
+   /** Writes every item of the tree, in order, to a dump in one pass, with
+       the DumpWrite overload for ItemType, and flushes the writer.
+    @param writer: The writer to write to.
+    @param format: DUMP_TEXT or DUMP_CSV.
+    @return  True if every write succeeded. */
+   bool Dump(CDumpWriter &writer, CDumpFormat format) const;
+
    /** This function recursively creates a array from a tree
     @param treePtr: A pointer of CBinaryNode type for the root of the tree.
     @param arr: An array whose size is the same as the number of nodes in
@@ -135,7 +318,7 @@ public:
 
    /** This creates a balanced BST by calling TreeToArray to create an
    	   array representing the tree then call ArrayToTreeHelper to convert that
-   	   array back to a tree but balanced.
+   	   array back to a tree but balanced.  Calls OnContentsChanged.
     @return  nothing */
    void ArrayToTree();
 
@@ -146,6 +329,91 @@ public:
     @return  A CBST pointer. */
    CBinaryNode<ItemType>* ArrayToTreeHelper(ItemType arr[], int start, int end);
 
+   /** Replaces the contents of the tree with a balanced tree built straight
+       from an array that is already sorted, without going through Add.
+    @param arr: A sorted array from least to greatest.
+    @param count: The number of items in arr.
+    @return  nothing */
+   void BuildFromSortedArray(ItemType arr[], int count);
+
+   /** Adds a batch of items with one rebuild.  The batch is sorted by key
+       and merged with the items already in the tree, and the merged run
+       becomes a balanced tree in one pass, so the cost is O(n + k log k)
+       instead of the O(n) rebuild per item that k calls to Add pay.  An
+       item that shares a key with items already in the tree goes after
+       them, as it would with Add.
+    @param arr: The items to add, in any order.
+    @param count: The number of items in arr.
+    @return  nothing */
+   void AddBatch(const ItemType arr[], int count);
+
+   /** Removes, for every item of a batch, one item of the tree that is ==
+       to it, with one rebuild.  The batch is sorted by key and matched
+       against the in-order run of the tree key by key.
+    @param arr: The items to remove, in any order.
+    @param count: The number of items in arr.
+    @return  The number of items removed. */
+   int RemoveBatch(const ItemType arr[], int count);
+
+   /** Moves every item of this tree into two trees: items whose key is less
+       than key go to left, the rest to right.  Nodes are relinked, not
+       copied, along one root-to-leaf path, so it runs in O(log n).  Neither
+       result is taller than this tree was.  This tree is left empty.
+    @param key: The first key that goes to right.
+    @param left: Receives the items below key (its old items are cleared).
+    @param right: Receives the other items (its old items are cleared).
+                  Must not be the same tree as left.
+    @return  nothing */
+   void Split(const KeyType &key, CBST<ItemType> &left,
+              CBST<ItemType> &right);
+
+   /** Moves every item of right into this tree, where no key of this tree
+       may be greater than any key of right.  The largest node of this tree
+       becomes the new root, so it runs in O(log n) and the result is at
+       most one level taller than the taller tree.  right is left empty.
+    @param right: The tree to move in.
+    @return  nothing
+    @throw  PrecondViolatedExcept if a key of this tree is greater than a
+            key of right (both trees are then unchanged). */
+   void Join(CBST<ItemType> &right);
+
+   /** Moves every item of other into this tree, keeping duplicates the way
+       Add does.  Built on splitting other around each node of this tree, it
+       relinks nodes without copying them and visits O(m log(n/m + 1))
+       nodes when other holds m items.  other is left empty.
+    @param other: The tree to move in.  Must not be this tree.
+    @return  nothing */
+   void Union(CBST<ItemType> &other);
+
+   /** Removes from this tree every item whose key appears in other, by
+       splitting this tree around each node of other and joining what is
+       left.  other is not changed.
+    @param other: The keys to remove.  Must not be this tree.
+    @return  nothing */
+   void Difference(const CBST<ItemType> &other);
+
+   /** Relinks the nodes of the tree into a perfectly balanced shape in O(n)
+       without copying any item or allocating any node.  Split, Join, Union
+       and Difference leave the balancing to this (or to the rebuild of the
+       next Add or Remove).
+    @param Nothing.
+    @return  nothing */
+   void Rebalance();
+
+   /** Writes the tree to a binary snapshot file: a versioned header, every
+       item in in-order sequence and a checksum of the items.
+    @param path: The file to write.  It is replaced atomically.
+    @return  True if the snapshot was written, or false if it could not be. */
+   bool Save(const std::string &path) const;
+
+   /** Replaces the tree with the contents of a snapshot written by Save.
+       Because the items are stored in order, the balanced tree is built
+       directly by ArrayToTreeHelper without any comparisons.
+    @param path: The file to read.
+    @return  True if the snapshot was loaded, or false if the file could not
+             be read or failed validation (the tree is then unchanged). */
+   bool Load(const std::string &path);
+
    /** Overloaded assignment operator.  Used to check if two CBST's are the
       same.
     @param rhs: A const CBST reference object.
@@ -191,6 +459,23 @@ protected:
 
    CBinaryNode<ItemType>* RemoveLeftmostNode(CBinaryNode<ItemType> *subTreePtr,
                                              ItemType &inorderSuccessor);
+
+   /** Removes the rightmost node of a subtree.
+    @param subTreePtr: A pointer of CBinaryNode type for the root of the tree.
+    @param rightmostItem: Receives the item of the removed node.
+    @return  Returns a CBinaryNode pointer to the revised subtree. */
+   CBinaryNode<ItemType>* RemoveRightmostNode(CBinaryNode<ItemType> *subTreePtr,
+                                              ItemType &rightmostItem);
+
+   /** Finds the node with the greatest key below key (below is true) or the
+       least key above it (below is false), for Floor, Ceiling, Predecessor
+       and Successor.
+    @param key: The key to search from.
+    @param below: True to search below key, false to search above it.
+    @param inclusive: True if a node with key itself will do.
+    @return  The node, or nullptr if there is none. */
+   CBinaryNode<ItemType>* FindBoundNode(const KeyType &key, bool below,
+                                        bool inclusive) const;
    
    /** This function returns a pointer to the node containing the given value,
        or nullptr if not found.
@@ -203,6 +488,133 @@ protected:
 
    CBinaryNode<ItemType>* FindParent(CBinaryNode<ItemType> *treePtr,
                                   const ItemType& target);
+
+   /** Finds, for every key of a batch, a node holding an item with that
+       key.  Shared by ContainsBatch and GetEntryBatch.
+    @param keys: The keys to look up.
+    @param count: The number of keys.
+    @param nodes: Receives, for every key, its node or nullptr.
+    @return  nothing */
+   void FindBatch(const KeyType keys[], int count,
+                  const CBinaryNode<ItemType> *nodes[]) const;
+
+   /** Recursive helper for Split: cuts a subtree along the path of key.
+    @param treePtr: The root of the subtree.
+    @param key: The key to split at.
+    @param equalGoesLeft: True to send items equal to key to the left part.
+    @param leftPtr: Receives the part below key.
+    @param rightPtr: Receives the part above key.
+    @return  nothing */
+   void SplitHelper(CBinaryNode<ItemType> *treePtr, const KeyType &key,
+                    bool equalGoesLeft, CBinaryNode<ItemType> *&leftPtr,
+                    CBinaryNode<ItemType> *&rightPtr) const;
+
+   /** Joins two subtrees where no key of the first is greater than any key
+       of the second, using the largest node of the first as the root.
+    @param leftPtr: The subtree with the smaller keys.
+    @param rightPtr: The subtree with the larger keys.
+    @return  The root of the joined subtree. */
+   CBinaryNode<ItemType>* JoinHelper(CBinaryNode<ItemType> *leftPtr,
+                                     CBinaryNode<ItemType> *rightPtr) const;
+
+   /** Recursive helper for Union.
+    @param treePtr: The subtree whose nodes stay roots.
+    @param otherPtr: The subtree split around them.
+    @return  The root of the union. */
+   CBinaryNode<ItemType>* UnionHelper(CBinaryNode<ItemType> *treePtr,
+                                      CBinaryNode<ItemType> *otherPtr) const;
+
+   /** Recursive helper for Difference.
+    @param treePtr: The subtree to remove keys from.
+    @param otherPtr: The subtree holding the keys to remove.
+    @param removedCount: Incremented by the number of items removed.
+    @return  The root of what is left. */
+   CBinaryNode<ItemType>* DifferenceHelper(CBinaryNode<ItemType> *treePtr,
+                                    const CBinaryNode<ItemType> *otherPtr,
+                                    int &removedCount);
+
+   /** Appends the nodes of a subtree, in order, to a vector.
+    @param treePtr: The root of the subtree.
+    @param nodes: The vector to append to.
+    @return  nothing */
+   void CollectNodes(CBinaryNode<ItemType> *treePtr,
+                     std::vector<CBinaryNode<ItemType>*> &nodes) const;
+
+   /** Links sorted nodes into a perfectly balanced subtree.
+    @param nodes: The nodes in order.
+    @param start: First position to use.
+    @param end: Last position to use.
+    @return  The root of the subtree. */
+   CBinaryNode<ItemType>* RelinkHelper(
+                  const std::vector<CBinaryNode<ItemType>*> &nodes,
+                  int start, int end) const;
+
+   /** Recursive traversal helper method for RangeTraverse.
+    @param treePtr: A pointer of CBinaryNode type for the root of the tree.
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that processes an ItemType object.
+    @return  nothing */
+   void RangeHelper(const CBinaryNode<ItemType> *treePtr, const KeyType &low,
+                    const KeyType &high, void Visit(ItemType &item)) const;
+
+   /** Recursive traversal helper method for GetSortedItems.
+    @param treePtr: A pointer of CBinaryNode type for the root of the tree.
+    @param items: The vector to append to.
+    @return  nothing */
+   void GetSortedItemsHelper(const CBinaryNode<ItemType> *treePtr,
+                             std::vector<ItemType> &items) const;
+
+   /** Recursive traversal helper method for ExportColumns.
+    @param treePtr: A pointer of CBinaryNode type for the root of the tree.
+    @param columns: The columns to append to.
+    @return  nothing */
+   template<class ColumnsType>
+   void ExportColumnsHelper(const CBinaryNode<ItemType> *treePtr,
+                            ColumnsType &columns) const;
+
+   /** Gives subclasses read access to the root of the tree.
+    @return  A pointer to the root node, or nullptr if the tree is empty. */
+   CBinaryNode<ItemType>* GetRootPtr() const;
+
+   /** Lets subclasses that restructure the tree themselves install a new
+       root.  The caller reports the change through OnContentsChanged if the
+       items changed.
+    @param rootPtr: The new root node.
+    @return  nothing */
+   void SetRootPtr(CBinaryNode<ItemType> *rootPtr);
+
+   /** Called once after every operation that changes which items the tree
+       holds (Add, Remove, Clear, BuildFromSortedArray, Load and
+       assignment).
+       Classes that keep data derived from the items override it to know
+       when that data has gone stale.  Does nothing by default.
+    @return  nothing */
+   virtual void OnContentsChanged();
+
+   /** Called instead of OnContentsChanged after an operation that only
+       removed items (RemoveBatch, Difference, PopMin and PopMax), for
+       classes that can account for a removal more cheaply than for any
+       change.  Calls OnContentsChanged by default.
+    @param count: The number of items removed.
+    @return  nothing */
+   virtual void OnItemsRemoved(int count);
+
+   /** Called instead of OnContentsChanged after Join or Union moved every
+       item of other into this tree, and before other reports that it was
+       emptied, so whatever other derived from its items can still be read.
+       Calls OnContentsChanged by default.
+    @param other: The tree the items came from.
+    @return  nothing */
+   virtual void OnTreeMerged(const CBST<ItemType> &other);
+
+   /** This function recursively appends the items of a subtree, in order, to
+       a snapshot buffer.
+    @param treePtr: A pointer of CBinaryNode type for the root of the tree.
+    @param buffer: The snapshot buffer to append to.
+    @return  nothing */
+   void SaveHelper(const CBinaryNode<ItemType> *treePtr,
+                   std::string &buffer) const;
    
 
 private:
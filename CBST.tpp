@@ -5,7 +5,12 @@
 // search tree
 // ============================================================================
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
+#include <iterator>
+#include <cstring>
+#include <vector>
 #include "CBST.h"
 using namespace std;
 
@@ -67,7 +72,6 @@ template<class ItemType>
 CBST<ItemType>::CBST(const CBST<ItemType> &tree) :
 											CBinaryNodeTree<ItemType> (tree)
 {
-	Clear();
 	m_rootPtr = CBinaryNodeTree<ItemType>::CopyTree(tree.m_rootPtr);
 }
 
@@ -111,7 +115,7 @@ CBST<ItemType>::~CBST()
 //
 // ============================================================================
 template<class ItemType>
-bool CBST<ItemType>::IsEmpty() const
+bool CBST<ItemType>::IsEmpty() const noexcept
 {
 	if (m_rootPtr == nullptr)
 	{
@@ -163,6 +167,26 @@ int CBST<ItemType>::GetNumberOfNodes() const
 
 
 
+// ==== Stats =================================================================
+//
+// Reports the shape of the tree and the memory its nodes use by calling the
+// inherited function StatsHelper.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeStats  -  the report
+//
+// ============================================================================
+template<class ItemType>
+CTreeStats CBST<ItemType>::Stats() const
+{
+	return CBinaryNodeTree<ItemType>::StatsHelper(m_rootPtr);
+}
+
+
+
 // ==== GetRootData ===========================================================
 //
 // Gets the item at root location.
@@ -177,7 +201,7 @@ int CBST<ItemType>::GetNumberOfNodes() const
 //
 // ============================================================================
 template<class ItemType>
-ItemType CBST<ItemType>::GetRootData() const throw(PrecondViolatedExcept)
+ItemType CBST<ItemType>::GetRootData() const
 {
 	if (m_rootPtr != nullptr)
 	{
@@ -207,8 +231,7 @@ ItemType CBST<ItemType>::GetRootData() const throw(PrecondViolatedExcept)
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::SetRootData(const ItemType &newData)
-									const throw(PrecondViolatedExcept)
+void CBST<ItemType>::SetRootData(const ItemType &newData) const
 {
 	PrecondViolatedExcept exception("Cannot change root value in a CBST");
 	throw exception;
@@ -232,6 +255,8 @@ void CBST<ItemType>::SetRootData(const ItemType &newData)
 template<class ItemType>
 bool CBST<ItemType>::Add(const ItemType &newEntry)
 {
+	BST_TIME(TREE_OP_ADD);
+
 	//create new node and alocate the item
 	CBinaryNode<ItemType> *newNode = new CBinaryNode<ItemType>;
 	newNode->SetItem(newEntry);
@@ -248,12 +273,11 @@ bool CBST<ItemType>::Add(const ItemType &newEntry)
 
 // ==== Remove ================================================================
 //
-// Removes a node from the tree.  This function calls the function RemoveValue.
-// Remove value will remove any node except a leaf node as it needs its parent
-// It is much more convienent to take care of this case here.
+// Removes a node from the tree.  This function calls the function RemoveValue
+// and rebalances the tree if a node was removed.
 //
 // Input:
-//		asEntry	[IN] - An ItemType that will be used to find the node to delete
+//		anEntry	[IN] - An ItemType that will be used to find the node to delete
 //
 // Output:
 //		bool  -  True if removal was successful, false if it is not
@@ -263,71 +287,22 @@ bool CBST<ItemType>::Add(const ItemType &newEntry)
 template<class ItemType>
 bool CBST<ItemType>::Remove(const ItemType &anEntry)
 {
-	if (!Contains(anEntry))
-	{
-		return false;
-	}
+	BST_TIME(TREE_OP_REMOVE);
+
 	//success gets updated to true if removal was successful
 	bool success;
 	success = false;
 
-	RemoveValue(m_rootPtr, anEntry, success);
-
-	//if it still contains the entry then it is a leaf after running through
-	//Remove Value so locate parent node and delete it we must use the
-	//implimentation of FindNode from CBinarNode Tree here because if anEntry
-	// passed through the RemoveLeftmostNode function then it will be out of
-	//order, thus the CBST::Contains or CBST::FindNode won't find it
-	
-	bool searchSuccess;
-	CBinaryNodeTree<ItemType>::FindNode(m_rootPtr, anEntry, searchSuccess);
-	
-	if (searchSuccess)
-	{	
-		if (m_rootPtr->GetItem() == anEntry && m_rootPtr->IsLeaf())
-		{
-			delete m_rootPtr;
-			m_rootPtr = nullptr;
-		
-			success = true;
-		}
-		else
-		{
-			CBinaryNode<ItemType> *parentHolder;
-			parentHolder = FindParent(m_rootPtr, anEntry);
-			if (parentHolder->GetLeftChildPtr() != nullptr)
-			{
-				if (parentHolder->GetLeftChildPtr()->GetItem() == anEntry &&
-			 	   parentHolder->GetLeftChildPtr()->IsLeaf())
-				{
-					delete (parentHolder->GetLeftChildPtr());
-					parentHolder->SetLeftChildPtr(nullptr);
-
-					success = true;
-				}
-			}
-			
-			if (parentHolder->GetRightChildPtr() != nullptr)
-			{
-				if (parentHolder->GetRightChildPtr()->GetItem() == anEntry &&
-				   parentHolder->GetRightChildPtr()->IsLeaf())
-				{
-					delete (parentHolder->GetRightChildPtr());
-					parentHolder->SetRightChildPtr(nullptr);
-
-					success = true;
-				}
-			}
-			
-		}
+	m_rootPtr = RemoveValue(m_rootPtr, anEntry, success);
+	if (!success)
+	{
+		return false;
 	}
 
 	//balance after removal
-	if (m_rootPtr != nullptr)
-	{
-		ArrayToTree();
-	}
-	return success;
+	ArrayToTree();
+
+	return true;
 }
 
 
@@ -347,21 +322,17 @@ bool CBST<ItemType>::Remove(const ItemType &anEntry)
 template<class ItemType>
 void CBST<ItemType>::Clear()
 {
+	//DestroyTree frees the root too, so only the pointer is left to reset
 	CBinaryNodeTree<ItemType>::DestroyTree(m_rootPtr);
-	
-	if (m_rootPtr != nullptr)
-	{
-		m_rootPtr->SetLeftChildPtr(nullptr);
-		m_rootPtr->SetRightChildPtr(nullptr);
-		m_rootPtr = nullptr;
-	}
+	m_rootPtr = nullptr;
+	OnContentsChanged();
 }
 
 
 
 // ==== GetEntry ==============================================================
 //
-// Retrieves an entry from the tree.  This function calls FindNode.
+// Retrieves an entry from the tree.  This function calls FindOrNull.
 //
 // Input:
 //		asEntry	[IN] - An ItemType that will be used to retrieve an item
@@ -374,27 +345,23 @@ void CBST<ItemType>::Clear()
 //
 // ============================================================================
 template<class ItemType>
-ItemType CBST<ItemType>::GetEntry(const ItemType &anEntry)
-										const throw(NotFoundException)
+ItemType CBST<ItemType>::GetEntry(const ItemType &anEntry) const
 {
-	if (FindNode(m_rootPtr, anEntry) != nullptr)
-	{
-		//why do we want to return an ItemType if we already know the value
-		//would be anEntry??
-		return anEntry;
-	}
-	else
+	const ItemType *entryPtr = FindOrNull(anEntry);
+	if (entryPtr == nullptr)
 	{
 		NotFoundException exception("Entry does not exhist");
 		throw exception;
 	}
+
+	return *entryPtr;
 }
 
 
 
 // ==== Contains ==============================================================
 //
-// Checks if an item exists in the tree.  This function calls FindNode.
+// Checks if an item exists in the tree.  This function calls FindOrNull.
 //
 // Input:
 //		asEntry	[IN] - An ItemType that will be used to retrieve an item
@@ -405,514 +372,2241 @@ ItemType CBST<ItemType>::GetEntry(const ItemType &anEntry)
 //
 // ============================================================================
 template<class ItemType>
-bool CBST<ItemType>::Contains(const ItemType &anEntry) const
+bool CBST<ItemType>::Contains(const ItemType &anEntry) const noexcept
 {
-	if (FindNode(m_rootPtr, anEntry) != nullptr)
-	{
-		return true;
-	}
-	return false;
+	return FindOrNull(anEntry) != nullptr;
 }
 
 
 
-// ==== PreorderTraverse ======================================================
+// ==== FindOrNull ============================================================
 //
-// A function used to transverse the tree in preorder.  Calls the inherited
-// function Preorder.
+// Finds an item in the tree without throwing.  This function calls FindNode.
 //
 // Input:
-//		Visit	[IN] - A function that is a void return type and takes an
-//                  argument of ItemType. This function is the processing step
-//                  of each node. It is as simple as displaying the ItemType
-//					object.
+//		anEntry	[IN] - An ItemType that will be used to find an item
 //
 // Output:
-//		nothing
-//
+//		const ItemType*  -  the item in the tree, or nullptr if not found
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::PreorderTraverse(void Visit(ItemType &item)) const
+const ItemType* CBST<ItemType>::FindOrNull(const ItemType &anEntry) const
+																noexcept
 {
-	CBinaryNodeTree<ItemType>::Preorder(Visit, m_rootPtr);
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<ItemType> *nodePtr = FindNode(m_rootPtr, anEntry);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== InorderTraverse =======================================================
+// ==== Floor =================================================================
 //
-// A function used to transverse the tree in inorder.  Calls the inherited
-// function Inorder.
+// Finds an item with the greatest key not greater than key.  This function
+// calls FindBoundNode.
 //
 // Input:
-//		Visit	[IN] - A function that is a void return type and takes an
-//                  argument of ItemType. This function is the processing step
-//                  of each node. It is as simple as displaying the ItemType
-//					object.
+//		key	[IN] - the key to search from
 //
 // Output:
-//		nothing
-//
+//		const ItemType*  -  the item in the tree, or nullptr if every key is
+//						greater
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::InorderTraverse(void Visit(ItemType &item)) const
+const ItemType* CBST<ItemType>::Floor(const KeyType &key) const
 {
-	CBinaryNodeTree<ItemType>::Inorder(Visit, m_rootPtr);
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<ItemType> *nodePtr = FindBoundNode(key, true, true);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== PostorderTraverse =====================================================
+// ==== Ceiling ===============================================================
 //
-// A function used to transverse the tree in postorder.  Calls the inherited
-// function Postorder.
+// Finds an item with the least key not less than key.  This function
+// calls FindBoundNode.
 //
 // Input:
-//		Visit	[IN] - A function that is a void return type and takes an
-//                  argument of ItemType. This function is the processing step
-//                  of each node. It is as simple as displaying the ItemType
-//					object.
+//		key	[IN] - the key to search from
 //
 // Output:
-//		nothing
-//
+//		const ItemType*  -  the item in the tree, or nullptr if every key is
+//						less
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::PostorderTraverse(void Visit(ItemType &item)) const
+const ItemType* CBST<ItemType>::Ceiling(const KeyType &key) const
 {
-	CBinaryNodeTree<ItemType>::Postorder(Visit, m_rootPtr);
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<ItemType> *nodePtr = FindBoundNode(key, false, true);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== TreeToArray ===========================================================
+// ==== Predecessor ===========================================================
 //
-// This function recursively creates a balanced tree from an array
+// Finds an item with the greatest key less than key.  This function
+// calls FindBoundNode.
 //
 // Input:
-//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
-//		arr	[IN/OUT] - An array whose size is the same as the number of nodes
-//    				   in a tree
-//		arrLocation	[IN] - pointer to an int which shows the location of where
-//    					   to add the current node. Gets updated every
-//						   recursion
+//		key	[IN] - the key to search from
 //
 // Output:
-//		nothing but updates whatever array was passed into the function
+//		const ItemType*  -  the item in the tree, or nullptr if there is no
+//						smaller key
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::TreeToArray(CBinaryNode<ItemType> *treePtr,
-								ItemType arr[], int *arrLocation)
+const ItemType* CBST<ItemType>::Predecessor(const KeyType &key) const
 {
-	if (treePtr == nullptr)
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<ItemType> *nodePtr = FindBoundNode(key, true, false);
+	if (nodePtr == nullptr)
 	{
-		return;
+		return nullptr;
 	}
 
-	TreeToArray(treePtr->GetLeftChildPtr(), arr, arrLocation);
-
-	arr[*arrLocation] = treePtr->GetItem();
-	++ *arrLocation;
-	
-	TreeToArray(treePtr->GetRightChildPtr(), arr, arrLocation);
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== ArrayToTree ===========================================================
+// ==== Successor =============================================================
 //
-// This creates a balanced BST by calling TreeToArray to create an
-// array representing the tree then call ArrayToTreeHelper to convert that
-// array back to a tree but balanced.
+// Finds an item with the least key greater than key.  This function
+// calls FindBoundNode.
 //
 // Input:
-//		nothing
+//		key	[IN] - the key to search from
 //
 // Output:
-//		nothing but updates m_rootPtr and thus the tree
+//		const ItemType*  -  the item in the tree, or nullptr if there is no
+//						greater key
 //
 // ============================================================================
 template<class ItemType>
-void CBST<ItemType>::ArrayToTree()
+const ItemType* CBST<ItemType>::Successor(const KeyType &key) const
 {
-	int numberNodes;
-	numberNodes = GetNumberOfNodes();
-	ItemType arr[numberNodes];
-
-	int arrayLocation;
-	arrayLocation = 0;
-
-	//create the array
-	TreeToArray(m_rootPtr, arr, &arrayLocation);
+	BST_TIME(TREE_OP_FIND);
 
-	//clear the tree
-	Clear();
+	CBinaryNode<ItemType> *nodePtr = FindBoundNode(key, false, false);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
 
-	//create new tree
-	int start;
-	start = 0;
-	int end;
-	end = numberNodes - 1; //maybe not -1
-	
-	m_rootPtr = ArrayToTreeHelper(arr, start, end);
-	
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== ArrayToTreeHelper =====================================================
+// ==== Min ===================================================================
 //
-// This function recursively creates a balanced tree from an array
+// Finds the least item of the tree, at the end of the leftmost path.
 //
 // Input:
-//		arr	[IN] - A sorted array from least to greatest
-//		start	[IN] - int of where to start in the array
-//		end	[IN] - int of where to end in the array
+//		nothing
 //
 // Output:
-//		CBST - a CBST pointer which points to the rot of the new tree
-//
+//		const ItemType*  -  the item in the tree, or nullptr if it is empty
 //
 // ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::ArrayToTreeHelper(ItemType arr[],
-							int start, int end)
+const ItemType* CBST<ItemType>::Min() const
 {
-	if (start > end)
+	if (m_rootPtr == nullptr)
 	{
 		return nullptr;
 	}
 
-	int mid = (start + end)/2;
-	//create new node at middle
-	CBinaryNode<ItemType>* tempRoot;
-	tempRoot = new CBinaryNode<ItemType>;
-	tempRoot->SetItem(arr[mid]);
-
-	//recur down left side
-	tempRoot->SetLeftChildPtr(ArrayToTreeHelper(arr, start, mid - 1));
-
-	//recur down right side
-	tempRoot->SetRightChildPtr(ArrayToTreeHelper(arr, mid + 1, end));
+	const CBinaryNode<ItemType> *nodePtr = m_rootPtr;
+	while (nodePtr->GetLeftChildPtr() != nullptr)
+	{
+		nodePtr = nodePtr->GetLeftChildPtr();
+	}
 
-	return tempRoot;
-	
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// ==== Overloaded Assignment Operator ========================================
+// ==== Max ===================================================================
 //
-// Overloaded assignment operator.  Used to check if two CBST's are the
-// same.
+// Finds the greatest item of the tree, at the end of the rightmost path.
 //
 // Input:
-//		rhs	[IN] - A const CBST reference object.
+//		nothing
 //
 // Output:
-//		CBST - a CBST reference object
-//
+//		const ItemType*  -  the item in the tree, or nullptr if it is empty
 //
 // ============================================================================
 template<class ItemType>
-CBST<ItemType>& CBST<ItemType>::operator=(const CBST<ItemType> &rhs)
+const ItemType* CBST<ItemType>::Max() const
 {
-	if (this == &rhs)
+	if (m_rootPtr == nullptr)
 	{
-		return *this;
+		return nullptr;
 	}
 
-	//clears old tree
-	if (m_rootPtr != nullptr)
+	const CBinaryNode<ItemType> *nodePtr = m_rootPtr;
+	while (nodePtr->GetRightChildPtr() != nullptr)
 	{
-		Clear();
+		nodePtr = nodePtr->GetRightChildPtr();
 	}
 
-	//Creates a copy of rhs and has m_rootPtr point to it
-	m_rootPtr = CBinaryNodeTree<ItemType>::CopyTree(rhs.m_rootPtr);
-
-	return *this;
+	return &nodePtr->GetItemRef();
 }
 
 
 
-// =========================================================================
-//      Protected Member Functions
-// =========================================================================
-
-
-
-// ==== PlaceNode =============================================================
+// ==== PopMin ================================================================
 //
-// This function recursively finds where the given node should be placed
-// and inserts it in a leaf at that point.
+// Removes and returns the least item of the tree.  The leftmost node has
+// no left child, so its right child takes its place and nothing needs to
+// be rebalanced; the height of the tree cannot grow.  The change is
+// reported through OnItemsRemoved, so a subclass can account for it
+// without redoing the work Remove's rebuild pays for.
 //
 // Input:
-//		subTreeptr	[IN] - A pointer of CBinaryNode type for the root of the
-//						   tree.
-//		newNode		[IN] - A pointer of CBinaryNode type for the new node to
-//						   add/place.
+//		nothing
 //
 // Output:
-//		CBST - a CBST pointer
-//
+//		ItemType  -  the item removed
 //
 // ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::PlaceNode(
-			CBinaryNode<ItemType> *subTreePtr, CBinaryNode<ItemType> *newNode)
+ItemType CBST<ItemType>::PopMin()
 {
-	if (subTreePtr == nullptr)
-	{
-		return newNode;
-	}
-	else if (subTreePtr->GetItem() > newNode->GetItem())
-	{
-		CBinaryNode<ItemType> *tempPtr;
-		tempPtr = PlaceNode(subTreePtr->GetLeftChildPtr(), newNode);
-		subTreePtr->SetLeftChildPtr(tempPtr);
-	}
-	else
+	BST_TIME(TREE_OP_REMOVE);
+
+	if (m_rootPtr == nullptr)
 	{
-		CBinaryNode<ItemType> *tempPtr;
-		tempPtr = PlaceNode(subTreePtr->GetRightChildPtr(), newNode);
-		subTreePtr->SetRightChildPtr(tempPtr);
+		PrecondViolatedExcept exception("Tree is empty");
+		throw exception;
 	}
 
-	return subTreePtr;
+	ItemType minItem;
+	m_rootPtr = RemoveLeftmostNode(m_rootPtr, minItem);
+	OnItemsRemoved(1);
+
+	return minItem;
 }
 
 
 
-// ==== RemoveValue ===========================================================
+// ==== PopMax ================================================================
 //
-// This function recursively finds where the given node should be placed
-// and inserts it in a leaf at that point
+// Removes and returns the greatest item of the tree, the same way as PopMin.
 //
 // Input:
-//		subTreeptr	[IN] - A pointer of CBinaryNode type for the root of the
-//						   tree.
-//		target		[IN] - An ItemType to remove.
-//		success 	[IN/OUT] - A bool reference to report success or failture
-//                             of the removal.
+//		nothing
 //
 // Output:
-//		CBinaryNode - a CBinaryNode pointer
-//
+//		ItemType  -  the item removed
 //
 // ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::RemoveValue(
-      CBinaryNode<ItemType> *subTreePtr, const ItemType &target, bool &success)
+ItemType CBST<ItemType>::PopMax()
 {
-	if (subTreePtr == nullptr)
-	{
-		success = false;
-	}
-	else if (subTreePtr->GetItem() == target)
+	BST_TIME(TREE_OP_REMOVE);
+
+	if (m_rootPtr == nullptr)
 	{
-		subTreePtr = RemoveNode(subTreePtr); //remove item
-		success = true;
+		PrecondViolatedExcept exception("Tree is empty");
+		throw exception;
 	}
-	else if (subTreePtr->GetItem() > target)
-	{
-		//create a temporoary ptr to a CBinaryNode and search the left subtree
-		CBinaryNode<ItemType> *tempPtr;
+
+	ItemType maxItem;
+	m_rootPtr = RemoveRightmostNode(m_rootPtr, maxItem);
+	OnItemsRemoved(1);
+
+	return maxItem;
+}
+
+
+
+// ==== InorderFrom ===========================================================
+//
+// Visits the items lazily in order, starting from the first whose key is
+// not less than key.
+//
+// Input:
+//		key	[IN] - the least key to visit
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType> CBST<ItemType>::InorderFrom(const KeyType &key) const
+{
+	CTreeGenerator<ItemType> generator(m_rootPtr, TRAVERSE_INORDER);
+	generator.SeekCeiling(key);
+
+	return generator;
+}
+
+
+
+// ==== ContainsBatch =========================================================
+//
+// Checks, for every key of a batch, if the tree holds an item with that key.
+//
+// Input:
+//		keys	[IN] - the keys to look up
+//		count	[IN] - the number of keys
+//		results	[OUT] - true for every key that was found
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::ContainsBatch(const KeyType keys[], int count,
+								   bool results[]) const
+{
+	vector<const CBinaryNode<ItemType>*> nodes(count > 0 ? count : 0);
+	FindBatch(keys, count, nodes.empty() ? nullptr : &nodes[0]);
+
+	for (int index = 0; index < count; ++index)
+	{
+		results[index] = (nodes[index] != nullptr);
+	}
+}
+
+
+
+// ==== GetEntryBatch =========================================================
+//
+// Retrieves, for every key of a batch, an item with that key.
+//
+// Input:
+//		keys	[IN] - the keys to look up
+//		count	[IN] - the number of keys
+//		entries	[OUT] - an item for every key that was found
+//		found	[OUT] - true for every key that was found
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::GetEntryBatch(const KeyType keys[], int count,
+								   ItemType entries[], bool found[]) const
+{
+	vector<const CBinaryNode<ItemType>*> nodes(count > 0 ? count : 0);
+	FindBatch(keys, count, nodes.empty() ? nullptr : &nodes[0]);
+
+	for (int index = 0; index < count; ++index)
+	{
+		found[index] = (nodes[index] != nullptr);
+		if (found[index])
+		{
+			entries[index] = nodes[index]->GetItemRef();
+		}
+	}
+}
+
+
+
+// ==== PreorderTraverse ======================================================
+//
+// A function used to transverse the tree in preorder.  Calls the inherited
+// function Preorder.
+//
+// Input:
+//		Visit	[IN] - A function that is a void return type and takes an
+//                  argument of ItemType. This function is the processing step
+//                  of each node. It is as simple as displaying the ItemType
+//					object.
+//
+// Output:
+//		nothing
+//
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::PreorderTraverse(void Visit(ItemType &item)) const
+{
+	CBinaryNodeTree<ItemType>::Preorder(Visit, m_rootPtr);
+}
+
+
+
+// ==== InorderTraverse =======================================================
+//
+// A function used to transverse the tree in inorder.  Calls the inherited
+// function Inorder.
+//
+// Input:
+//		Visit	[IN] - A function that is a void return type and takes an
+//                  argument of ItemType. This function is the processing step
+//                  of each node. It is as simple as displaying the ItemType
+//					object.
+//
+// Output:
+//		nothing
+//
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::InorderTraverse(void Visit(ItemType &item)) const
+{
+	CBinaryNodeTree<ItemType>::Inorder(Visit, m_rootPtr);
+}
+
+
+
+// ==== PostorderTraverse =====================================================
+//
+// A function used to transverse the tree in postorder.  Calls the inherited
+// function Postorder.
+//
+// Input:
+//		Visit	[IN] - A function that is a void return type and takes an
+//                  argument of ItemType. This function is the processing step
+//                  of each node. It is as simple as displaying the ItemType
+//					object.
+//
+// Output:
+//		nothing
+//
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::PostorderTraverse(void Visit(ItemType &item)) const
+{
+	CBinaryNodeTree<ItemType>::Postorder(Visit, m_rootPtr);
+}
+
+
+
+// ==== Preorder ==============================================================
+//
+// Visits the items lazily in preorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType> CBST<ItemType>::Preorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_PREORDER);
+}
+
+
+
+// ==== Inorder ===============================================================
+//
+// Visits the items lazily in inorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType> CBST<ItemType>::Inorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_INORDER);
+}
+
+
+
+// ==== Postorder =============================================================
+//
+// Visits the items lazily in postorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType> CBST<ItemType>::Postorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_POSTORDER);
+}
+
+
+
+// ==== LevelOrder ============================================================
+//
+// Visits the items lazily in level order.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType> CBST<ItemType>::LevelOrder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_LEVEL_ORDER);
+}
+
+
+
+// ==== ParallelForEach =======================================================
+//
+// Calls Visit on every item on the workers of a pool.  Calls the inherited
+// function ParallelWalk.  Visit may have changed the items, so
+// OnContentsChanged is called afterwards.
+//
+// Input:
+//		Visit		[IN] - takes an ItemType&
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+template<class VisitType>
+void CBST<ItemType>::ParallelForEach(VisitType Visit, int grainSize,
+									 CWorkPool &pool)
+{
+	auto visitItem = [&Visit](ItemType &item, int)
+	{
+		Visit(item);
+	};
+
+	CBinaryNodeTree<ItemType>::ParallelWalk(m_rootPtr, visitItem, grainSize,
+											pool);
+	OnContentsChanged();
+}
+
+
+
+// ==== ParallelReduce ========================================================
+//
+// Combines Map(item) over every item on the workers of a pool.  Calls the
+// inherited function ParallelReduceHelper.
+//
+// Input:
+//		Map			[IN] - takes a const ItemType&
+//		Combine		[IN] - combines two results into one
+//		identity	[IN] - the result of no items
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		ResultType  -  the combined result
+//
+// ============================================================================
+template<class ItemType>
+template<class ResultType, class MapType, class CombineType>
+ResultType CBST<ItemType>::ParallelReduce(MapType Map, CombineType Combine,
+										  const ResultType &identity,
+										  int grainSize, CWorkPool &pool) const
+{
+	return CBinaryNodeTree<ItemType>::ParallelReduceHelper(m_rootPtr, Map,
+														   Combine, identity,
+														   grainSize, pool);
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// A function used to transverse, in order, only the items whose key lies in
+// the closed range [low, high].  Calls the function RangeHelper.
+//
+// Input:
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that is a void return type and takes an
+//                  argument of ItemType.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::RangeTraverse(const KeyType &low, const KeyType &high,
+								   void Visit(ItemType &item)) const
+{
+	RangeHelper(m_rootPtr, low, high, Visit);
+}
+
+
+
+// ==== GetSortedItems ========================================================
+//
+// Copies every item of the tree, in order, into a vector.
+//
+// Input:
+//		items	[OUT] - receives the items from least to greatest
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::GetSortedItems(vector<ItemType> &items) const
+{
+	items.clear();
+	items.reserve(GetNumberOfNodes());
+
+	GetSortedItemsHelper(m_rootPtr, items);
+}
+
+
+
+// ==== ExportColumns =========================================================
+//
+// Writes every item of the tree, in order, to a set of columns in one pass.
+// Calls the function ExportColumnsHelper.
+//
+// Input:
+//		columns	[OUT] - cleared, then receives the items from least to
+//						greatest
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+template<class ColumnsType>
+void CBST<ItemType>::ExportColumns(ColumnsType &columns) const
+{
+	columns.Clear();
+
+	ExportColumnsHelper(m_rootPtr, columns);
+}
+
+
+
+// ==== Dump ==================================================================
+//
+// Writes every item of the tree, in order, to a dump in one pass.  Calls
+// the function ExportColumns with columns that pass each item to DumpWrite.
+//
+// Input:
+//		writer	[IN/OUT] - the writer to write to
+//		format	[IN] - DUMP_TEXT or DUMP_CSV
+//
+// Output:
+//		bool  -  True if every write succeeded
+//
+// ============================================================================
+template<class ItemType>
+bool CBST<ItemType>::Dump(CDumpWriter &writer, CDumpFormat format) const
+{
+	CDumpColumns dumpColumns = {writer, format};
+	ExportColumns(dumpColumns);
+
+	return writer.Flush();
+}
+
+
+
+// ==== TreeToArray ===========================================================
+//
+// This function recursively creates a balanced tree from an array
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		arr	[IN/OUT] - An array whose size is the same as the number of nodes
+//    				   in a tree
+//		arrLocation	[IN] - pointer to an int which shows the location of where
+//    					   to add the current node. Gets updated every
+//						   recursion
+//
+// Output:
+//		nothing but updates whatever array was passed into the function
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::TreeToArray(CBinaryNode<ItemType> *treePtr,
+								ItemType arr[], int *arrLocation)
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	TreeToArray(treePtr->GetLeftChildPtr(), arr, arrLocation);
+
+	arr[*arrLocation] = treePtr->GetItem();
+	++ *arrLocation;
+	
+	TreeToArray(treePtr->GetRightChildPtr(), arr, arrLocation);
+}
+
+
+
+// ==== ArrayToTree ===========================================================
+//
+// This creates a balanced BST by calling TreeToArray to create an
+// array representing the tree then call ArrayToTreeHelper to convert that
+// array back to a tree but balanced.  The change is reported through
+// OnContentsChanged, so Add and Remove do not report it again.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing but updates m_rootPtr and thus the tree
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::ArrayToTree()
+{
+	BST_TIME(TREE_OP_REBUILD);
+	BST_COUNT(TREE_REBUILDS, 1);
+
+	int numberNodes;
+	numberNodes = GetNumberOfNodes();
+	if (numberNodes == 0)
+	{
+		//nothing to rebuild, but the caller emptied the tree
+		OnContentsChanged();
+		return;
+	}
+
+	//kept on the heap: a stack array overflows on large trees
+	vector<ItemType> items(numberNodes);
+	ItemType *arr = &items[0];
+
+	int arrayLocation;
+	arrayLocation = 0;
+
+	//create the array
+	TreeToArray(m_rootPtr, arr, &arrayLocation);
+
+	//free the old nodes; not through Clear, which subclasses extend to
+	//drop what they keep beside the nodes, and a rebuild keeps all of that
+	CBinaryNodeTree<ItemType>::DestroyTree(m_rootPtr);
+	m_rootPtr = nullptr;
+
+	//create new tree
+	int start;
+	start = 0;
+	int end;
+	end = numberNodes - 1; //maybe not -1
+	
+	m_rootPtr = ArrayToTreeHelper(arr, start, end);
+
+	//the items are the same but every node moved
+	OnContentsChanged();
+}
+
+
+
+// ==== ArrayToTreeHelper =====================================================
+//
+// This function recursively creates a balanced tree from an array
+//
+// Input:
+//		arr	[IN] - A sorted array from least to greatest
+//		start	[IN] - int of where to start in the array
+//		end	[IN] - int of where to end in the array
+//
+// Output:
+//		CBST - a CBST pointer which points to the rot of the new tree
+//
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::ArrayToTreeHelper(ItemType arr[],
+							int start, int end)
+{
+	if (start > end)
+	{
+		return nullptr;
+	}
+
+	int mid = (start + end)/2;
+	//create new node at middle
+	CBinaryNode<ItemType>* tempRoot;
+	tempRoot = new CBinaryNode<ItemType>;
+	tempRoot->SetItem(arr[mid]);
+
+	//recur down left side
+	tempRoot->SetLeftChildPtr(ArrayToTreeHelper(arr, start, mid - 1));
+
+	//recur down right side
+	tempRoot->SetRightChildPtr(ArrayToTreeHelper(arr, mid + 1, end));
+
+	return tempRoot;
+	
+}
+
+
+
+// ==== BuildFromSortedArray ==================================================
+//
+// Replaces the contents of the tree with a balanced tree built straight from
+// an array that is already sorted.  Used for bulk loads, where going through
+// Add would rebuild the whole tree once per item.
+//
+// Input:
+//		arr	[IN] - A sorted array from least to greatest
+//		count	[IN] - the number of items in arr
+//
+// Output:
+//		nothing but updates m_rootPtr and thus the tree
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::BuildFromSortedArray(ItemType arr[], int count)
+{
+	//freed directly rather than through Clear, so the change is reported once
+	CBinaryNodeTree<ItemType>::DestroyTree(m_rootPtr);
+	m_rootPtr = nullptr;
+
+	m_rootPtr = ArrayToTreeHelper(arr, 0, count - 1);
+	OnContentsChanged();
+}
+
+
+
+// ==== AddBatch ==============================================================
+//
+// Adds a batch of items with one rebuild.  The batch is stable sorted by
+// key, then merged after the existing items of equal key.
+//
+// Input:
+//		arr		[IN] - the items to add, in any order
+//		count	[IN] - the number of items in arr
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::AddBatch(const ItemType arr[], int count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	auto keyLess = [](const ItemType &lhs, const ItemType &rhs)
+	{
+		return CKeyTraits<ItemType>::GetKey(lhs) <
+			   CKeyTraits<ItemType>::GetKey(rhs);
+	};
+
+	vector<ItemType> batch(arr, arr + count);
+	stable_sort(batch.begin(), batch.end(), keyLess);
+
+	vector<ItemType> existing;
+	GetSortedItems(existing);
+
+	vector<ItemType> merged;
+	merged.reserve(existing.size() + batch.size());
+	merge(existing.begin(), existing.end(), batch.begin(), batch.end(),
+		  back_inserter(merged), keyLess);
+
+	BuildFromSortedArray(&merged[0], (int)merged.size());
+}
+
+
+
+// ==== RemoveBatch ===========================================================
+//
+// Removes, for every item of a batch, one item of the tree that is == to it,
+// with one rebuild.  Both runs are sorted by key, so they are walked side by
+// side and only items of the same key are compared.  Items of one key are
+// kept in the order they were added, so each search starts just past the
+// previous match: a batch that removes them in that order is matched in one
+// pass over the run.
+//
+// Input:
+//		arr		[IN] - the items to remove, in any order
+//		count	[IN] - the number of items in arr
+//
+// Output:
+//		int  -  the number of items removed
+//
+// ============================================================================
+template<class ItemType>
+int CBST<ItemType>::RemoveBatch(const ItemType arr[], int count)
+{
+	if (count <= 0 || m_rootPtr == nullptr)
+	{
+		return 0;
+	}
+
+	auto keyLess = [](const ItemType &lhs, const ItemType &rhs)
+	{
+		return CKeyTraits<ItemType>::GetKey(lhs) <
+			   CKeyTraits<ItemType>::GetKey(rhs);
+	};
+
+	vector<ItemType> batch(arr, arr + count);
+	stable_sort(batch.begin(), batch.end(), keyLess);
+
+	vector<ItemType> existing;
+	GetSortedItems(existing);
+	vector<bool> removed(existing.size(), false);
+	int removedCount = 0;
+
+	//[runStart, runEnd) holds the existing items with the current key; a
+	//search starts just past the previous match and wraps around the run
+	size_t runStart = 0;
+	size_t runEnd = 0;
+	size_t hint = 0;
+	for (size_t index = 0; index < batch.size(); ++index)
+	{
+		if (index == 0 || keyLess(batch[index - 1], batch[index]))
+		{
+			runStart = runEnd;
+			while (runStart < existing.size() &&
+				   keyLess(existing[runStart], batch[index]))
+			{
+				++runStart;
+			}
+			runEnd = runStart;
+			while (runEnd < existing.size() &&
+				   !keyLess(batch[index], existing[runEnd]))
+			{
+				++runEnd;
+			}
+			hint = runStart;
+		}
+
+		for (size_t step = 0; step < runEnd - runStart; ++step)
+		{
+			size_t pos = hint + step;
+			if (pos >= runEnd)
+			{
+				pos -= runEnd - runStart;
+			}
+
+			if (!removed[pos] && existing[pos] == batch[index])
+			{
+				removed[pos] = true;
+				++removedCount;
+				hint = pos + 1;
+				break;
+			}
+		}
+	}
+
+	if (removedCount == 0)
+	{
+		return 0;
+	}
+
+	vector<ItemType> kept;
+	kept.reserve(existing.size() - removedCount);
+	for (size_t index = 0; index < existing.size(); ++index)
+	{
+		if (!removed[index])
+		{
+			kept.push_back(existing[index]);
+		}
+	}
+
+	//rebuilt here rather than by BuildFromSortedArray, so the change is
+	//reported as a removal
+	CBinaryNodeTree<ItemType>::DestroyTree(m_rootPtr);
+	m_rootPtr = ArrayToTreeHelper(kept.empty() ? nullptr : &kept[0], 0,
+								  (int)kept.size() - 1);
+	OnItemsRemoved(removedCount);
+
+	return removedCount;
+}
+
+
+
+// ==== Split =================================================================
+//
+// Moves the items below key into left and the rest into right by cutting
+// the tree along the search path of key.
+//
+// Input:
+//		key		[IN] - the first key that goes to right
+//		left	[OUT] - receives the items below key
+//		right	[OUT] - receives the other items
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::Split(const KeyType &key, CBST<ItemType> &left,
+						   CBST<ItemType> &right)
+{
+	CBinaryNode<ItemType> *leftPtr;
+	CBinaryNode<ItemType> *rightPtr;
+	CBinaryNode<ItemType> *treePtr = m_rootPtr;
+
+	//detach the nodes first, since this tree may also be left or right
+	m_rootPtr = nullptr;
+	OnContentsChanged();
+	SplitHelper(treePtr, key, false, leftPtr, rightPtr);
+
+	//freed directly rather than through Clear, so each change is reported once
+	CBinaryNodeTree<ItemType>::DestroyTree(left.m_rootPtr);
+	left.m_rootPtr = leftPtr;
+	left.OnContentsChanged();
+
+	CBinaryNodeTree<ItemType>::DestroyTree(right.m_rootPtr);
+	right.m_rootPtr = rightPtr;
+	right.OnContentsChanged();
+}
+
+
+
+// ==== Join ==================================================================
+//
+// Moves every item of right into this tree.  The keys are checked at the
+// two ends of the trees before anything is relinked.
+//
+// Input:
+//		right	[IN/OUT] - the tree to move in; left empty
+//
+// Output:
+//		nothing
+//
+//		PrecondViolatedExcept  -  thrown if a key of this tree is greater
+//								  than a key of right
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::Join(CBST<ItemType> &right)
+{
+	if (this == &right || right.m_rootPtr == nullptr)
+	{
+		return;
+	}
+
+	if (m_rootPtr != nullptr)
+	{
+		const CBinaryNode<ItemType> *maxPtr = m_rootPtr;
+		while (maxPtr->GetRightChildPtr() != nullptr)
+		{
+			maxPtr = maxPtr->GetRightChildPtr();
+		}
+		const CBinaryNode<ItemType> *minPtr = right.m_rootPtr;
+		while (minPtr->GetLeftChildPtr() != nullptr)
+		{
+			minPtr = minPtr->GetLeftChildPtr();
+		}
+
+		if (CKeyTraits<ItemType>::GetKey(minPtr->GetItemRef()) <
+			CKeyTraits<ItemType>::GetKey(maxPtr->GetItemRef()))
+		{
+			PrecondViolatedExcept exception("Join needs every key of the "
+											"right tree to be at least the "
+											"largest key of this tree");
+			throw exception;
+		}
+	}
+
+	m_rootPtr = JoinHelper(m_rootPtr, right.m_rootPtr);
+	right.m_rootPtr = nullptr;
+	OnTreeMerged(right);
+	right.OnContentsChanged();
+}
+
+
+
+// ==== Union =================================================================
+//
+// Moves every item of other into this tree.
+//
+// Input:
+//		other	[IN/OUT] - the tree to move in; left empty
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::Union(CBST<ItemType> &other)
+{
+	if (this == &other || other.m_rootPtr == nullptr)
+	{
+		return;
+	}
+
+	m_rootPtr = UnionHelper(m_rootPtr, other.m_rootPtr);
+	other.m_rootPtr = nullptr;
+	OnTreeMerged(other);
+	other.OnContentsChanged();
+}
+
+
+
+// ==== Difference ============================================================
+//
+// Removes from this tree every item whose key appears in other.
+//
+// Input:
+//		other	[IN] - the keys to remove
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::Difference(const CBST<ItemType> &other)
+{
+	if (this == &other)
+	{
+		Clear();
+		return;
+	}
+
+	int removedCount = 0;
+	m_rootPtr = DifferenceHelper(m_rootPtr, other.m_rootPtr, removedCount);
+	OnItemsRemoved(removedCount);
+}
+
+
+
+// ==== Rebalance =============================================================
+//
+// Relinks the nodes into a perfectly balanced shape, the same shape
+// ArrayToTree builds, but without copying items or allocating nodes.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::Rebalance()
+{
+	vector<CBinaryNode<ItemType>*> nodes;
+	CollectNodes(m_rootPtr, nodes);
+
+	m_rootPtr = RelinkHelper(nodes, 0, (int)nodes.size() - 1);
+}
+
+
+
+// ==== Save ==================================================================
+//
+// Writes the tree to a binary snapshot file.  The layout is:
+//
+//		magic "CBSTSNAP" | version (u32) | reserved (u32) | count (u64) |
+//		payload size (u64) | items in in-order sequence | checksum (u64)
+//
+// where the checksum is the FNV-1a hash of the item bytes.
+//
+// Input:
+//		path	[IN] - the file to write; it is replaced atomically
+//
+// Output:
+//		bool  -  True if the snapshot was written, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CBST<ItemType>::Save(const string &path) const
+{
+	string payload;
+	SaveHelper(m_rootPtr, payload);
+
+	string buffer;
+	buffer.reserve(payload.size() + 40);
+	buffer.append(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+	SnapshotWrite(buffer, SNAPSHOT_VERSION);
+	SnapshotWrite(buffer, (unsigned int)0);
+	SnapshotWrite(buffer, (unsigned long long)GetNumberOfNodes());
+	SnapshotWrite(buffer, (unsigned long long)payload.size());
+	buffer.append(payload);
+	SnapshotWrite(buffer, SnapshotChecksum(payload.data(), payload.size()));
+
+	return SnapshotWriteFile(path, buffer);
+}
+
+
+
+// ==== Load ==================================================================
+//
+// Replaces the tree with the contents of a snapshot written by Save.  Since
+// the items are stored in order, the balanced tree is built directly by
+// ArrayToTreeHelper without a single comparison.
+//
+// Input:
+//		path	[IN] - the file to read
+//
+// Output:
+//		bool  -  True if the snapshot was loaded, false if the file could not
+//				 be read or failed validation (the tree is then unchanged)
+//
+// ============================================================================
+template<class ItemType>
+bool CBST<ItemType>::Load(const string &path)
+{
+	string buffer;
+	if (!SnapshotReadFile(path, buffer))
+	{
+		return false;
+	}
+
+	const char *pos = buffer.data();
+	const char *end = pos + buffer.size();
+	unsigned int version;
+	unsigned int reserved;
+	unsigned long long count;
+	unsigned long long payloadSize;
+	unsigned long long checksum;
+
+	//validate the header
+	if (buffer.size() < SNAPSHOT_MAGIC_SIZE ||
+		memcmp(pos, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0)
+	{
+		return false;
+	}
+	pos += SNAPSHOT_MAGIC_SIZE;
+
+	if (!SnapshotRead(pos, end, version) || version != SNAPSHOT_VERSION ||
+		!SnapshotRead(pos, end, reserved) || !SnapshotRead(pos, end, count) ||
+		!SnapshotRead(pos, end, payloadSize) ||
+		(unsigned long long)(end - pos) != payloadSize + sizeof(checksum))
+	{
+		return false;
+	}
+
+	//validate the items before decoding any of them
+	const char *payloadEnd = pos + payloadSize;
+	const char *checksumPos = payloadEnd;
+	if (!SnapshotRead(checksumPos, end, checksum) ||
+		checksum != SnapshotChecksum(pos, (size_t)payloadSize))
+	{
+		return false;
+	}
+
+	//the count is not covered by the checksum; every item takes at least a
+	//byte of the payload, so a larger count is corrupt and is rejected
+	//before it sizes anything
+	if (count > payloadSize || count > (unsigned long long)INT_MAX)
+	{
+		return false;
+	}
+
+	vector<ItemType> items((size_t)count);
+	for (size_t index = 0; index < items.size(); ++index)
+	{
+		if (!SnapshotRead(pos, payloadEnd, items[index]))
+		{
+			return false;
+		}
+	}
+	if (pos != payloadEnd)
+	{
+		return false;
+	}
+
+	BuildFromSortedArray(items.empty() ? nullptr : &items[0], (int)count);
+
+	return true;
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Overloaded assignment operator.  Used to check if two CBST's are the
+// same.
+//
+// Input:
+//		rhs	[IN] - A const CBST reference object.
+//
+// Output:
+//		CBST - a CBST reference object
+//
+//
+// ============================================================================
+template<class ItemType>
+CBST<ItemType>& CBST<ItemType>::operator=(const CBST<ItemType> &rhs)
+{
+	if (this == &rhs)
+	{
+		return *this;
+	}
+
+	//clears old tree without reporting it; the copy below is reported once
+	CBinaryNodeTree<ItemType>::DestroyTree(m_rootPtr);
+	m_rootPtr = nullptr;
+
+	//Creates a copy of rhs and has m_rootPtr point to it
+	m_rootPtr = CBinaryNodeTree<ItemType>::CopyTree(rhs.m_rootPtr);
+	OnContentsChanged();
+
+	return *this;
+}
+
+
+
+// =========================================================================
+//      Protected Member Functions
+// =========================================================================
+
+
+
+// ==== PlaceNode =============================================================
+//
+// This function recursively finds where the given node should be placed
+// and inserts it in a leaf at that point.
+//
+// Input:
+//		subTreeptr	[IN] - A pointer of CBinaryNode type for the root of the
+//						   tree.
+//		newNode		[IN] - A pointer of CBinaryNode type for the new node to
+//						   add/place.
+//
+// Output:
+//		CBST - a CBST pointer
+//
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::PlaceNode(
+			CBinaryNode<ItemType> *subTreePtr, CBinaryNode<ItemType> *newNode)
+{
+	if (subTreePtr == nullptr)
+	{
+		return newNode;
+	}
+
+	BST_COUNT(TREE_COMPARISONS, 1);
+	if (subTreePtr->GetItem() > newNode->GetItem())
+	{
+		CBinaryNode<ItemType> *tempPtr;
+		tempPtr = PlaceNode(subTreePtr->GetLeftChildPtr(), newNode);
+		subTreePtr->SetLeftChildPtr(tempPtr);
+	}
+	else
+	{
+		CBinaryNode<ItemType> *tempPtr;
+		tempPtr = PlaceNode(subTreePtr->GetRightChildPtr(), newNode);
+		subTreePtr->SetRightChildPtr(tempPtr);
+	}
+
+	return subTreePtr;
+}
+
+
+
+// ==== RemoveValue ===========================================================
+//
+// This function recursively finds the node holding target and removes it,
+// returning the new root of the subtree.  Items with the same key as target
+// may sit on either side of a node with that key once the tree has been
+// rebuilt, so both sides are searched when the keys match but the items do
+// not.
+//
+// Input:
+//		subTreeptr	[IN] - A pointer of CBinaryNode type for the root of the
+//						   tree.
+//		target		[IN] - An ItemType to remove.
+//		success 	[IN/OUT] - A bool reference to report success or failture
+//                             of the removal.
+//
+// Output:
+//		CBinaryNode - a CBinaryNode pointer
+//
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::RemoveValue(
+      CBinaryNode<ItemType> *subTreePtr, const ItemType &target, bool &success)
+{
+	if (subTreePtr == nullptr)
+	{
+		success = false;
+		return nullptr;
+	}
+
+	CBinaryNode<ItemType> *tempPtr;
+	BST_COUNT(TREE_COMPARISONS, 1);
+	if (subTreePtr->GetItemRef() == target)
+	{
+		success = true;
+		return RemoveNode(subTreePtr); //remove item
+	}
+	else if (subTreePtr->GetItemRef() > target)
+	{
+		tempPtr = RemoveValue(subTreePtr->GetLeftChildPtr(), target, success);
+		subTreePtr->SetLeftChildPtr(tempPtr);
+	}
+	else if (subTreePtr->GetItemRef() < target)
+	{
+		tempPtr = RemoveValue(subTreePtr->GetRightChildPtr(), target, success);
+		subTreePtr->SetRightChildPtr(tempPtr);
+	}
+	else
+	{
+		//same key, different item: it may be on either side
 		tempPtr = RemoveValue(subTreePtr->GetLeftChildPtr(), target, success);
+		subTreePtr->SetLeftChildPtr(tempPtr);
+		if (!success)
+		{
+			tempPtr = RemoveValue(subTreePtr->GetRightChildPtr(), target,
+								  success);
+			subTreePtr->SetRightChildPtr(tempPtr);
+		}
+	}
+
+	return subTreePtr;
+}
+
+
+
+// ==== RemoveNode ===========================================================
+//
+// This function removes a given node from a tree while maintaining a
+// binary search tree.  A node with two children takes the item of its
+// inorder successor, and the successor's node is removed instead.
+//
+// Input:
+//		nodePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//
+// Output:
+//		CBinaryNode - the new root of the subtree
+//
+//
+// ===========================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::RemoveNode(
+											CBinaryNode<ItemType> *nodePtr)
+{
+	if (nodePtr->IsLeaf())
+	{
+		delete nodePtr;
+		return nullptr;
+	}
+	else if (nodePtr->GetLeftChildPtr() == nullptr ||
+			 nodePtr->GetRightChildPtr() == nullptr)
+	{
+		CBinaryNode<ItemType> *nodeToConnectPtr;
+		if (nodePtr->GetRightChildPtr() == nullptr)
+		{
+			nodeToConnectPtr = nodePtr->GetLeftChildPtr();
+		}
+		else
+		{
+			nodeToConnectPtr = nodePtr->GetRightChildPtr();
+		}
+
+		delete nodePtr;
+		return nodeToConnectPtr;
+	}
+	else
+	{
+		CBinaryNode<ItemType> *tempPtr;
+		ItemType inorderSuccessor;
+
+		tempPtr = RemoveLeftmostNode(nodePtr->GetRightChildPtr(),
+									 inorderSuccessor);
+
+		nodePtr->SetRightChildPtr(tempPtr);
+		nodePtr->SetItem(inorderSuccessor);
+		return nodePtr;
+	}
+}
+
+
+
+// ==== RemoveLeftmostNode ====================================================
+//
+// This function removes the leftmost node of a subtree and passes its item
+// back through inorderSuccessor.
+//
+// Input:
+//		subtreePtr	[IN] - A pointer of CBinaryNode type for the root of the
+//						   tree.
+//		inorderSuccessor	[OUT] - Receives the item of the removed node.
+//
+// Output:
+//		CBinaryNode - a CBinaryNode pointer to the revised subtree
+//
+//
+// ===========================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::RemoveLeftmostNode(
+		  CBinaryNode<ItemType> *subTreePtr, ItemType &inorderSuccessor)
+{
+	if (subTreePtr->GetLeftChildPtr() == nullptr)
+	{
+		inorderSuccessor = subTreePtr->GetItemRef();
+		return RemoveNode(subTreePtr);
+	}
+	else
+	{
+		CBinaryNode<ItemType> *tempPtr;
+		tempPtr = RemoveLeftmostNode(
+							subTreePtr->GetLeftChildPtr(), inorderSuccessor);
 
 		subTreePtr->SetLeftChildPtr(tempPtr);
+		return subTreePtr;
+	}
+}
+
+
+
+// ==== RemoveRightmostNode ===================================================
+//
+// This function removes the rightmost node of a subtree and passes its item
+// back through rightmostItem.
+//
+// Input:
+//		subtreePtr	[IN] - A pointer of CBinaryNode type for the root of the
+//						   tree.
+//		rightmostItem	[OUT] - Receives the item of the removed node.
+//
+// Output:
+//		CBinaryNode - a CBinaryNode pointer to the revised subtree
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::RemoveRightmostNode(
+		  CBinaryNode<ItemType> *subTreePtr, ItemType &rightmostItem)
+{
+	if (subTreePtr->GetRightChildPtr() == nullptr)
+	{
+		rightmostItem = subTreePtr->GetItemRef();
+		return RemoveNode(subTreePtr);
 	}
 	else
 	{
-		//create a temporoary ptr to a CBinaryNode and search the left subtree
 		CBinaryNode<ItemType> *tempPtr;
-		tempPtr = RemoveValue(subTreePtr->GetRightChildPtr(), target, success);
+		tempPtr = RemoveRightmostNode(
+							subTreePtr->GetRightChildPtr(), rightmostItem);
 
 		subTreePtr->SetRightChildPtr(tempPtr);
+		return subTreePtr;
+	}
+}
+
+
+
+// ==== FindBoundNode =========================================================
+//
+// Finds the node with the greatest key below key, or the least key above
+// it.  Every node that qualifies is remembered on the way down and the
+// descent goes on towards key for a closer one.  Equal keys may sit on
+// either side of a node after a rebalance, but every key to the left of a
+// node is no greater and every key to the right no less, so the last node
+// remembered is the closest.
+//
+// Input:
+//		key			[IN] - the key to search from
+//		below		[IN] - true to search below key, false above it
+//		inclusive	[IN] - true if a node with key itself will do
+//
+// Output:
+//		CBinaryNode  -  the node, or nullptr if there is none
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::FindBoundNode(const KeyType &key,
+													 bool below,
+													 bool inclusive) const
+{
+	unsigned long long visited = 0;
+	CBinaryNode<ItemType> *boundPtr = nullptr;
+	CBinaryNode<ItemType> *nodePtr = m_rootPtr;
+
+	while (nodePtr != nullptr)
+	{
+		++visited;
+		KeyType nodeKey = CKeyTraits<ItemType>::GetKey(nodePtr->GetItemRef());
+
+		bool qualifies;
+		if (below)
+		{
+			qualifies = inclusive ? !(key < nodeKey) : (nodeKey < key);
+		}
+		else
+		{
+			qualifies = inclusive ? !(nodeKey < key) : (key < nodeKey);
+		}
+
+		if (qualifies)
+		{
+			boundPtr = nodePtr;
+		}
+		nodePtr = (qualifies == below) ? nodePtr->GetRightChildPtr() :
+										 nodePtr->GetLeftChildPtr();
+	}
+	BST_COUNT(TREE_NODES_VISITED, visited);
+
+	return boundPtr;
+}
+
+
+
+// ==== FindNode ==============================================================
+//
+// This function returns a pointer to the node containing the given value, or
+// nullptr if not found.
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		target	[IN] - A reference of ItemType type to find the node
+//					   corresponding.
+//
+// Output:
+//		CBinaryNode - a CBinaryNode pointer to the revised subtree
+//
+//
+// ===========================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::FindNode(
+                CBinaryNode<ItemType> *treePtr, const ItemType& target) const
+{
+	//nodes passed are counted here and reported once, at the end, so that
+	//instrumentation does not slow down every step of the descent
+	unsigned long long visited = 0;
+
+	while (treePtr != nullptr)
+	{
+		++visited;
+		if (treePtr->GetItemRef() == target)
+		{
+			break;
+		}
+		if (treePtr->GetItemRef() < target)
+		{
+			treePtr = treePtr->GetRightChildPtr();
+		}
+		else if (treePtr->GetItemRef() > target)
+		{
+			treePtr = treePtr->GetLeftChildPtr();
+		}
+		else
+		{
+			//same key, different item: it may be on either side
+			CBinaryNode<ItemType> *foundPtr;
+			foundPtr = FindNode(treePtr->GetLeftChildPtr(), target);
+			if (foundPtr == nullptr)
+			{
+				foundPtr = FindNode(treePtr->GetRightChildPtr(), target);
+			}
+			treePtr = foundPtr;
+			break;
+		}
+	}
+
+	BST_COUNT(TREE_NODES_VISITED, visited);
+
+	return treePtr;
+}
+
+
+
+// ==== FindParent ============================================================
+//
+// Recursively searches for target value's parent in the tree by using a
+// preorder traversal.
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNodeTree type for the root of the
+//                     tree.
+//		target	[IN] - A const ItemType reference to find.
+//		parentHolder	[IN/OUT] - An ItemType that will represent the parent
+//									of the target
+//
+// Output:
+//		ItemType -  Returns parent to the target's node
+//
+// ============================================================================
+template <class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::FindParent(
+								CBinaryNode<ItemType> *treePtr,
+								const ItemType &target)
+{
+	return CBinaryNodeTree<ItemType>::FindParent(treePtr, target);
+}
+
+
+
+// ==== SaveHelper ============================================================
+//
+// This function recursively appends the items of a subtree, in order, to a
+// snapshot buffer.
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		buffer	[IN/OUT] - the snapshot buffer to append to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::SaveHelper(const CBinaryNode<ItemType> *treePtr,
+								string &buffer) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	SaveHelper(treePtr->GetLeftChildPtr(), buffer);
+	SnapshotWrite(buffer, treePtr->GetItem());
+	SaveHelper(treePtr->GetRightChildPtr(), buffer);
+}
+
+
+
+// ==== RangeHelper ===========================================================
+//
+// Recursive traversal helper method for RangeTraverse.  Equal keys may sit
+// on either side of a node after a rebalance, so a subtree is only skipped
+// when its root's key is strictly outside of the range.
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::RangeHelper(const CBinaryNode<ItemType> *treePtr,
+								 const KeyType &low, const KeyType &high,
+								 void Visit(ItemType &item)) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	ItemType itemContents = treePtr->GetItem();
+	KeyType key = CKeyTraits<ItemType>::GetKey(itemContents);
+
+	if (!(key < low))
+	{
+		RangeHelper(treePtr->GetLeftChildPtr(), low, high, Visit);
+	}
+
+	if (!(key < low) && !(high < key))
+	{
+		Visit(itemContents);
+	}
+
+	if (!(high < key))
+	{
+		RangeHelper(treePtr->GetRightChildPtr(), low, high, Visit);
+	}
+}
+
+
+
+// ==== GetSortedItemsHelper ==================================================
+//
+// Recursive traversal helper method for GetSortedItems.
+//
+// Input:
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		items	[IN/OUT] - the vector to append to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::GetSortedItemsHelper(const CBinaryNode<ItemType> *treePtr,
+										  vector<ItemType> &items) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
 	}
 
-	return subTreePtr;
+	GetSortedItemsHelper(treePtr->GetLeftChildPtr(), items);
+	items.push_back(treePtr->GetItem());
+	GetSortedItemsHelper(treePtr->GetRightChildPtr(), items);
 }
 
 
 
-// ==== RemoveNode ===========================================================
+// ==== ExportColumnsHelper ===================================================
 //
-// This function removes a given node from a tree while maintaining a
-// binary search tree.
+// Recursive traversal helper method for ExportColumns.
 //
 // Input:
-//		nodePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
+//		columns	[IN/OUT] - the columns to append to
 //
 // Output:
-//		CBinaryNode - a CBinaryNode pointer
-//
+//		nothing
 //
-// ===========================================================================
+// ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::RemoveNode(
-											CBinaryNode<ItemType> *nodePtr)
+template<class ColumnsType>
+void CBST<ItemType>::ExportColumnsHelper(const CBinaryNode<ItemType> *treePtr,
+										 ColumnsType &columns) const
 {
-	if (nodePtr->IsLeaf())
+	if (treePtr == nullptr)
 	{
-		return nodePtr;
+		return;
 	}
-	else if ((nodePtr->GetLeftChildPtr() == nullptr || 
-			nodePtr->GetRightChildPtr() == nullptr) && !(nodePtr->IsLeaf()))
+
+	ExportColumnsHelper(treePtr->GetLeftChildPtr(), columns);
+	columns.Append(treePtr->GetItem());
+	ExportColumnsHelper(treePtr->GetRightChildPtr(), columns);
+}
+
+
+
+// ==== FindBatch =============================================================
+//
+// Finds, for every key of a batch, a node holding an item with that key.
+// Keys are taken BST_BATCH_LANES at a time.  Each round moves every key
+// still searching down one level and prefetches the node it lands on, so
+// by the time the round comes back to a key its node is usually in cache.
+//
+// Input:
+//		keys	[IN] - the keys to look up
+//		count	[IN] - the number of keys
+//		nodes	[OUT] - the node found for every key, or nullptr
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::FindBatch(const KeyType keys[], int count,
+							   const CBinaryNode<ItemType> *nodes[]) const
+{
+	const CBinaryNode<ItemType> *lanes[BST_BATCH_LANES];
+
+	for (int first = 0; first < count; first += BST_BATCH_LANES)
 	{
-		CBinaryNode<ItemType> *nodeToConnectPtr;
-		if (nodePtr->GetRightChildPtr() == nullptr)
-		{
-			nodeToConnectPtr = nodePtr->GetLeftChildPtr();
-		}
-		else
+		int laneCount = min(BST_BATCH_LANES, count - first);
+		int active = (m_rootPtr != nullptr) ? laneCount : 0;
+
+		for (int lane = 0; lane < laneCount; ++lane)
 		{
-			nodeToConnectPtr = nodePtr->GetRightChildPtr();
+			lanes[lane] = m_rootPtr;
+			nodes[first + lane] = nullptr;
 		}
 
-		//if the root is the one you delete here, make sure you relink the root back
-		//to the tree, this if statment checks for this
-		if (nodePtr->GetItem() == m_rootPtr->GetItem())
+		while (active > 0)
 		{
-			m_rootPtr = nodeToConnectPtr;
-		}
-		
-		delete nodePtr;
+			active = 0;
+			for (int lane = 0; lane < laneCount; ++lane)
+			{
+				const CBinaryNode<ItemType> *nodePtr = lanes[lane];
+				if (nodePtr == nullptr)
+				{
+					continue;
+				}
 
-		return nodeToConnectPtr;
+				const KeyType &key = keys[first + lane];
+				KeyType nodeKey = CKeyTraits<ItemType>::GetKey(
+													nodePtr->GetItemRef());
+				if (key < nodeKey)
+				{
+					nodePtr = nodePtr->GetLeftChildPtr();
+				}
+				else if (nodeKey < key)
+				{
+					nodePtr = nodePtr->GetRightChildPtr();
+				}
+				else
+				{
+					nodes[first + lane] = nodePtr;
+					nodePtr = nullptr;
+				}
+
+				lanes[lane] = nodePtr;
+				if (nodePtr != nullptr)
+				{
+					__builtin_prefetch(nodePtr);
+					++active;
+				}
+			}
+		}
 	}
-	else
+}
+
+
+
+// ==== SplitHelper ===========================================================
+//
+// Cuts a subtree along the search path of key.  Every node on the path goes
+// to one side and keeps the subtree on that side, while its other child is
+// replaced by the matching part of the cut below it.
+//
+// Input:
+//		treePtr			[IN] - the root of the subtree
+//		key				[IN] - the key to split at
+//		equalGoesLeft	[IN] - true to send items equal to key to the left
+//		leftPtr			[OUT] - the part below key
+//		rightPtr		[OUT] - the part above key
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::SplitHelper(CBinaryNode<ItemType> *treePtr,
+								 const KeyType &key, bool equalGoesLeft,
+								 CBinaryNode<ItemType> *&leftPtr,
+								 CBinaryNode<ItemType> *&rightPtr) const
+{
+	if (treePtr == nullptr)
 	{
-		CBinaryNode<ItemType> *tempPtr;
-		ItemType tempItem;
+		leftPtr = nullptr;
+		rightPtr = nullptr;
+		return;
+	}
 
-		//pass item we want to remove to tempItem
-		tempItem = nodePtr->GetItem();
-		tempPtr = RemoveLeftmostNode(nodePtr->GetRightChildPtr(),
-									 tempItem);
+	KeyType nodeKey = CKeyTraits<ItemType>::GetKey(treePtr->GetItemRef());
+	bool goesLeft = equalGoesLeft ? !(key < nodeKey) : (nodeKey < key);
 
-		nodePtr->SetRightChildPtr(tempPtr);
-		nodePtr->SetItem(tempItem);
-		return nodePtr;
+	if (goesLeft)
+	{
+		CBinaryNode<ItemType> *middlePtr;
+		SplitHelper(treePtr->GetRightChildPtr(), key, equalGoesLeft,
+					middlePtr, rightPtr);
+		treePtr->SetRightChildPtr(middlePtr);
+		leftPtr = treePtr;
+	}
+	else
+	{
+		CBinaryNode<ItemType> *middlePtr;
+		SplitHelper(treePtr->GetLeftChildPtr(), key, equalGoesLeft,
+					leftPtr, middlePtr);
+		treePtr->SetLeftChildPtr(middlePtr);
+		rightPtr = treePtr;
 	}
 }
 
 
 
-// ==== RemoveLeftmostNode ====================================================
+// ==== JoinHelper ============================================================
 //
-// This function recursively finds where the given node should be placed
-// and inserts it in a leaf at that point
+// Joins two subtrees by detaching the largest node of the left one and
+// making it the root over what is left of both.
 //
 // Input:
-//		subtreePtr	[IN] - A pointer of CBinaryNode type for the root of the
-//						   tree.
-//		inorderSuccessor	[IN] - A reference of ItemType type for its
-//									successor.
+//		leftPtr		[IN] - the subtree with the smaller keys
+//		rightPtr	[IN] - the subtree with the larger keys
 //
 // Output:
-//		CBinaryNode - a CBinaryNode pointer to the revised subtree
+//		CBinaryNode  -  the root of the joined subtree
 //
-//
-// ===========================================================================
+// ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::RemoveLeftmostNode(
-		  CBinaryNode<ItemType> *subTreePtr, ItemType &inorderSuccessor)
+CBinaryNode<ItemType>* CBST<ItemType>::JoinHelper(
+				CBinaryNode<ItemType> *leftPtr,
+				CBinaryNode<ItemType> *rightPtr) const
 {
-	if (subTreePtr->GetLeftChildPtr() == nullptr)
+	if (leftPtr == nullptr)
+	{
+		return rightPtr;
+	}
+	if (rightPtr == nullptr)
+	{
+		return leftPtr;
+	}
+
+	//detach the rightmost node of the left subtree
+	CBinaryNode<ItemType> *parentPtr = nullptr;
+	CBinaryNode<ItemType> *maxPtr = leftPtr;
+	while (maxPtr->GetRightChildPtr() != nullptr)
+	{
+		parentPtr = maxPtr;
+		maxPtr = maxPtr->GetRightChildPtr();
+	}
+
+	if (parentPtr != nullptr)
 	{
-		
-		ItemType itemHolder;
-		//have item holder hold the item that we want to remove which
-		//was passed to inorder successor
-		itemHolder = inorderSuccessor;
+		parentPtr->SetRightChildPtr(maxPtr->GetLeftChildPtr());
+		maxPtr->SetLeftChildPtr(leftPtr);
+	}
+	maxPtr->SetRightChildPtr(rightPtr);
+
+	return maxPtr;
+}
 
-		//update inorderSuccessor to hold the inorderSuccessor
-		inorderSuccessor = subTreePtr->GetItem();
 
-		//now item is at the bottom of the subtree
-		subTreePtr->SetItem(itemHolder);
 
-		//in the special case where m_rootPtr is the node to remove,
-		//update the value to the inorder successor now or it will interfere
-		//with the special root case of RemoveNode
-		if (m_rootPtr->GetItem() == itemHolder)
-		{
-			m_rootPtr->SetItem(inorderSuccessor);
-		}
-		
-		return RemoveNode(subTreePtr);
+// ==== UnionHelper ===========================================================
+//
+// Splits the other subtree around the root of this one and unions the two
+// sides recursively.  Items equal to the root go to its right, as PlaceNode
+// sends them.
+//
+// Input:
+//		treePtr		[IN] - the subtree whose nodes stay roots
+//		otherPtr	[IN] - the subtree split around them
+//
+// Output:
+//		CBinaryNode  -  the root of the union
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::UnionHelper(
+				CBinaryNode<ItemType> *treePtr,
+				CBinaryNode<ItemType> *otherPtr) const
+{
+	if (treePtr == nullptr)
+	{
+		return otherPtr;
 	}
-	else
+	if (otherPtr == nullptr)
 	{
-		CBinaryNode<ItemType> *tempPtr;
-		tempPtr = RemoveLeftmostNode(
-							subTreePtr->GetLeftChildPtr(), inorderSuccessor);
-
-		subTreePtr->SetLeftChildPtr(tempPtr);
-		return subTreePtr;
+		return treePtr;
 	}
+
+	CBinaryNode<ItemType> *lowPtr;
+	CBinaryNode<ItemType> *highPtr;
+	SplitHelper(otherPtr, CKeyTraits<ItemType>::GetKey(treePtr->GetItemRef()),
+				false, lowPtr, highPtr);
+
+	treePtr->SetLeftChildPtr(UnionHelper(treePtr->GetLeftChildPtr(), lowPtr));
+	treePtr->SetRightChildPtr(UnionHelper(treePtr->GetRightChildPtr(),
+										  highPtr));
+
+	return treePtr;
 }
 
 
 
-// ==== FindNode ==============================================================
+// ==== DifferenceHelper ======================================================
 //
-// This function returns a pointer to the node containing the given value, or
-// nullptr if not found.
+// Splits this subtree into the items below, equal to and above the key at
+// the root of the other subtree, deletes the equal part and recurses on the
+// other two before joining them.
 //
 // Input:
-//		treePtr	[IN] - A pointer of CBinaryNode type for the root of the tree.
-//		target	[IN] - A reference of ItemType type to find the node
-//					   corresponding.
+//		treePtr			[IN] - the subtree to remove keys from
+//		otherPtr		[IN] - the subtree holding the keys to remove
+//		removedCount	[IN/OUT] - incremented by the number of items removed
 //
 // Output:
-//		CBinaryNode - a CBinaryNode pointer to the revised subtree
-//
+//		CBinaryNode  -  the root of what is left
 //
-// ===========================================================================
+// ============================================================================
 template<class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::FindNode(
-                CBinaryNode<ItemType> *treePtr, const ItemType& target) const
+CBinaryNode<ItemType>* CBST<ItemType>::DifferenceHelper(
+				CBinaryNode<ItemType> *treePtr,
+				const CBinaryNode<ItemType> *otherPtr, int &removedCount)
 {
-	if (treePtr == nullptr || treePtr->GetItem() == target)
+	if (treePtr == nullptr || otherPtr == nullptr)
 	{
 		return treePtr;
 	}
-	if (treePtr->GetItem() < target)
+
+	KeyType key = CKeyTraits<ItemType>::GetKey(otherPtr->GetItemRef());
+	CBinaryNode<ItemType> *lowPtr;
+	CBinaryNode<ItemType> *restPtr;
+	CBinaryNode<ItemType> *equalPtr;
+	CBinaryNode<ItemType> *highPtr;
+	SplitHelper(treePtr, key, false, lowPtr, restPtr);
+	SplitHelper(restPtr, key, true, equalPtr, highPtr);
+	removedCount += this->GetNumberOfNodesHelper(equalPtr);
+	CBinaryNodeTree<ItemType>::DestroyTree(equalPtr);
+
+	lowPtr = DifferenceHelper(lowPtr, otherPtr->GetLeftChildPtr(),
+							  removedCount);
+	highPtr = DifferenceHelper(highPtr, otherPtr->GetRightChildPtr(),
+							   removedCount);
+
+	return JoinHelper(lowPtr, highPtr);
+}
+
+
+
+// ==== CollectNodes ==========================================================
+//
+// Appends the nodes of a subtree, in order, to a vector.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//		nodes	[IN/OUT] - the vector to append to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::CollectNodes(CBinaryNode<ItemType> *treePtr,
+								  vector<CBinaryNode<ItemType>*> &nodes) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	CollectNodes(treePtr->GetLeftChildPtr(), nodes);
+	nodes.push_back(treePtr);
+	CollectNodes(treePtr->GetRightChildPtr(), nodes);
+}
+
+
+
+// ==== RelinkHelper ==========================================================
+//
+// Links sorted nodes into a perfectly balanced subtree, picking the middle
+// node as the root the way ArrayToTreeHelper does.
+//
+// Input:
+//		nodes	[IN] - the nodes in order
+//		start	[IN] - first position to use
+//		end		[IN] - last position to use
+//
+// Output:
+//		CBinaryNode  -  the root of the subtree
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::RelinkHelper(
+				const vector<CBinaryNode<ItemType>*> &nodes,
+				int start, int end) const
+{
+	if (start > end)
 	{
-		return FindNode(treePtr->GetRightChildPtr(), target);
+		return nullptr;
 	}
+
+	int mid = (start + end) / 2;
+	CBinaryNode<ItemType> *nodePtr = nodes[mid];
+	nodePtr->SetLeftChildPtr(RelinkHelper(nodes, start, mid - 1));
+	nodePtr->SetRightChildPtr(RelinkHelper(nodes, mid + 1, end));
+
+	return nodePtr;
+}
+
+
+
+// ==== GetRootPtr ============================================================
+//
+// Gives subclasses read access to the root of the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CBinaryNode  -  the root node, or nullptr if the tree is empty
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CBST<ItemType>::GetRootPtr() const
+{
+	return m_rootPtr;
+}
+
+
+
+// ==== SetRootPtr ============================================================
+//
+// Lets subclasses that restructure the tree themselves install a new root.
+//
+// Input:
+//		rootPtr	[IN] - the new root node
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::SetRootPtr(CBinaryNode<ItemType> *rootPtr)
+{
+	m_rootPtr = rootPtr;
+}
+
+
+
+// ==== OnContentsChanged =====================================================
+//
+// Called after every operation that changes which items the tree holds.
+// Does nothing by default; classes that keep data derived from the items
+// override it.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::OnContentsChanged()
+{
 	
-	return FindNode(treePtr->GetLeftChildPtr(), target);
 }
 
 
 
-// ==== FindParent ============================================================
+// ==== OnItemsRemoved ========================================================
 //
-// Recursively searches for target value's parent in the tree by using a
-// preorder traversal.
+// Called after an operation that only removed items.  Treats the removal as
+// any other change by default.
 //
 // Input:
-//		treePtr	[IN] - A pointer of CBinaryNodeTree type for the root of the
-//                     tree.
-//		target	[IN] - A const ItemType reference to find.
-//		parentHolder	[IN/OUT] - An ItemType that will represent the parent
-//									of the target
+//		count	[IN] - the number of items removed
 //
 // Output:
-//		ItemType -  Returns parent to the target's node
+//		nothing
 //
 // ============================================================================
-template <class ItemType>
-CBinaryNode<ItemType>* CBST<ItemType>::FindParent(
-								CBinaryNode<ItemType> *treePtr,
-								const ItemType &target)
+template<class ItemType>
+void CBST<ItemType>::OnItemsRemoved(int)
 {
-	return CBinaryNodeTree<ItemType>::FindParent(treePtr, target);
+	OnContentsChanged();
+}
+
+
+
+// ==== OnTreeMerged ==========================================================
+//
+// Called after Join or Union moved the items of another tree into this one.
+// Treats the merge as any other change by default.
+//
+// Input:
+//		other	[IN] - the tree the items came from
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBST<ItemType>::OnTreeMerged(const CBST<ItemType> &)
+{
+	OnContentsChanged();
 }
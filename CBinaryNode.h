@@ -7,6 +7,9 @@
 #ifndef CBINARY_NODE_HEADER
 #define CBINARY_NODE_HEADER
 
+#include <cstddef>
+#include "CTreeInstrument.h"
+
 template<class ItemType>
 class CBinaryNode
 {   
@@ -41,6 +44,17 @@ public:
     @return  ItemType */
    ItemType 			  GetItem() const;
 
+   /** Gives direct access to m_item, for callers that update an item in
+       place without changing where it belongs in the tree.
+    @param Nothing.
+    @return  A reference to m_item. */
+   ItemType& 			  GetItemRef();
+
+   /** Gives read access to m_item without copying it.
+    @param Nothing.
+    @return  A const reference to m_item. */
+   const ItemType& 		  GetItemRef() const;
+
    /** Checks if a node is a leaf.
     @param Nothing.
     @return  True if the node is a leaf, or false if it is not. */
@@ -65,6 +79,22 @@ public:
     @param CBinaryNode<ItemType>*. A templated pointer to the right node.
     @return  Nothing. */
    void   SetRightChildPtr(CBinaryNode<ItemType> *rightChildPtr);
+
+#ifdef CBST_INSTRUMENT
+   /** Counts the node as allocated (TREE_NODES_ALLOCATED). */
+   static void* operator new(std::size_t size)
+   {
+      BST_COUNT(TREE_NODES_ALLOCATED, 1);
+      return ::operator new(size);
+   }
+
+   /** Counts the node as freed (TREE_NODES_FREED). */
+   static void operator delete(void *nodePtr)
+   {
+      BST_COUNT(TREE_NODES_FREED, 1);
+      ::operator delete(nodePtr);
+   }
+#endif
    
 private:
    // =========================================================================
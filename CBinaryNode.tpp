@@ -114,6 +114,44 @@ ItemType CBinaryNode<ItemType>::GetItem() const
 
 
 
+// ==== GetItemRef ============================================================
+//
+// Gives direct access to m_item.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		ItemType  -  a reference to m_item
+//
+// ============================================================================
+template<class ItemType>
+ItemType& CBinaryNode<ItemType>::GetItemRef()
+{
+	return m_item;
+}
+
+
+
+// ==== GetItemRef ============================================================
+//
+// Gives read access to m_item without copying it.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		ItemType  -  a const reference to m_item
+//
+// ============================================================================
+template<class ItemType>
+const ItemType& CBinaryNode<ItemType>::GetItemRef() const
+{
+	return m_item;
+}
+
+
+
 // ==== IsLeaf ================================================================
 //
 // Checks if a node is a leaf.
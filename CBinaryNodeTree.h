@@ -11,6 +11,9 @@
 #include "CBinaryNode.h"
 #include "PrecondViolatedExcept.h"
 #include "NotFoundException.h"
+#include "CTreeInstrument.h"
+#include "CTreeGenerator.h"
+#include "CWorkPool.h"
 
 template <class ItemType>
 class   CBinaryNodeTree : public CBinaryTreeInterface<ItemType>
@@ -49,7 +52,7 @@ public:
    /** Checks if m_rootPtr is nullptr
     @param Nothing.
     @return  True if it is empty, or false if it is not. */
-   bool             IsEmpty() const;
+   bool             IsEmpty() const noexcept;
 
    /** Counts the height of the tree by calling the function GetHeightHelper.
     @param Nothing.
@@ -62,11 +65,17 @@ public:
     @return  An int value representing the number of nodes the tree has. */
    int              GetNumberOfNodes() const;
 
+   /** Reports the shape of the tree and the memory its nodes use by calling
+       the function StatsHelper.
+    @param Nothing.
+    @return  A CTreeStats describing the tree. */
+   CTreeStats       Stats() const;
+
    /** Gets the item at root location.
     @param Nothing.
     @return  An ItemType that is located at the root.
     @throw  PrecondViolatedExcept if the tree is empty. */
-   ItemType         GetRootData() const throw(PrecondViolatedExcept);
+   ItemType         GetRootData() const;
 
    /** Assigns an item at root location. If the root is empty, a new
        CBinaryNode is created and item is initialzed.
@@ -94,17 +103,23 @@ public:
     @return  Nothing. */
    void             Clear();
 
-   /** Retrieves an entry from the tree.  This function calls FindNode.
+   /** Retrieves an entry from the tree.  This function calls FindOrNull.
     @param anEntry: An ItemType that will be used to retrieve an item.
     @return  Returns an ItemType (the entry if it exists.
     @throw   NotFoundException if the entry does not exists. */
-   ItemType         GetEntry(const ItemType &anEntry) const
-                             throw(NotFoundException);
+   ItemType         GetEntry(const ItemType &anEntry) const;
 
    /** Checks if an item exists in the tree.  This function calls FindNode.
     @param anEntry: An ItemType that will be used to check if it exists.
     @return  True if found, or false if it is not. */
-   bool             Contains(const ItemType &anEntry) const;
+   bool             Contains(const ItemType &anEntry) const noexcept;
+
+   /** Finds an item in the tree without throwing.  This function calls
+       FindNode.
+    @param anEntry: An ItemType that will be used to find an item.
+    @return  A pointer to the item in the tree, or nullptr if it is not
+             found. */
+   const ItemType*  FindOrNull(const ItemType &anEntry) const noexcept;
 
    /** A function used to transverse the tree in preorder.  Calls the function
        Preorder.
@@ -130,6 +145,54 @@ public:
     @return  Nothing. */
    void             PostorderTraverse(void Visit(ItemType &item)) const;
 
+   /** Visits the items lazily in preorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Preorder() const;
+
+   /** Visits the items lazily in inorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Inorder() const;
+
+   /** Visits the items lazily in postorder; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> Postorder() const;
+
+   /** Visits the items lazily in level order; see CTreeGenerator.
+    @param Nothing.
+    @return  A generator that yields a reference to each item in turn. */
+   CTreeGenerator<ItemType> LevelOrder() const;
+
+   /** Calls Visit on every item, spreading the items over the workers of a
+       pool; see CWorkPool.  Visit is called from several threads at once
+       and in no particular order.  It may change the item it is given but
+       not its key.
+    @param Visit: A function or function object taking an ItemType&.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  Nothing. */
+   template<class VisitType>
+   void ParallelForEach(VisitType Visit, int grainSize = PARALLEL_GRAIN_SIZE,
+                        CWorkPool &pool = DefaultWorkPool());
+
+   /** Combines Map(item) over every item, spreading the items over the
+       workers of a pool.  Each worker combines what it maps, then the
+       workers' results are combined, so Combine must be associative and
+       commutative.  Map is called from several threads at once.
+    @param Map: A function or function object taking a const ItemType&.
+    @param Combine: Combines two results into one.
+    @param identity: The result of no items.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  The combined result. */
+   template<class ResultType, class MapType, class CombineType>
+   ResultType ParallelReduce(MapType Map, CombineType Combine,
+                             const ResultType &identity,
+                             int grainSize = PARALLEL_GRAIN_SIZE,
+                             CWorkPool &pool = DefaultWorkPool()) const;
+
    /** Overloaded assignment operator.  Used to check if two CBinaryNodeTree
        are the same.
     @param rhs: A const CBinaryNodeTree reference object.
@@ -154,6 +217,53 @@ protected:
                        tree.
     @return  An int value. */
    int              GetNumberOfNodesHelper(CBinaryNode<ItemType> *subTreePtr) const;
+
+    /** This function measures the tree by providing the root/subtree root
+        pointer.  It walks the tree in postorder without recursing, so it
+        handles trees of any height.
+    @param subTreePtr: A pointer of CBinaryNodeTree type for the root of the
+                       tree.
+    @return  A CTreeStats describing the tree. */
+   CTreeStats       StatsHelper(const CBinaryNode<ItemType> *subTreePtr) const;
+
+   /** Calls Visit(item, worker) on every item below rootPtr on the workers
+       of a pool.  Calls the function ParallelWalkTask.
+    @param rootPtr: The root of the tree.
+    @param Visit: Takes an ItemType& and the index of the worker.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  Nothing. */
+   template<class VisitType>
+   void ParallelWalk(CBinaryNode<ItemType> *rootPtr, VisitType &Visit,
+                     int grainSize, CWorkPool &pool) const;
+
+   /** Walks a subtree as one task of ParallelWalk, handing its largest
+       unwalked subtree to the pool whenever it has visited grainSize items
+       and another worker is idle.
+    @param treePtr: The root of the subtree.
+    @param worker: The index of the worker running the task.
+    @param Visit: Takes an ItemType& and the index of the worker.
+    @param grainSize: The items to visit between offers to split.
+    @param pool: The pool the task runs on.
+    @return  Nothing. */
+   template<class VisitType>
+   void ParallelWalkTask(CBinaryNode<ItemType> *treePtr, int worker,
+                         VisitType &Visit, int grainSize,
+                         CWorkPool &pool) const;
+
+   /** ParallelReduce over the items below rootPtr.
+    @param rootPtr: The root of the tree.
+    @param Map: Takes a const ItemType&.
+    @param Combine: Combines two results into one.
+    @param identity: The result of no items.
+    @param grainSize: The items a task visits before it offers to split.
+    @param pool: The pool to run on.
+    @return  The combined result. */
+   template<class ResultType, class MapType, class CombineType>
+   ResultType ParallelReduceHelper(CBinaryNode<ItemType> *rootPtr,
+                                   MapType &Map, CombineType &Combine,
+                                   const ResultType &identity, int grainSize,
+                                   CWorkPool &pool) const;
    
    /** Recursively adds a new node to the tree in a left/right fashion to
        keep the tree balanced.
@@ -5,7 +5,9 @@
 // binary tree
 // ============================================================================
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 using namespace std;
 
 #include "CBinaryNodeTree.h"
@@ -75,7 +77,6 @@ CBinaryNodeTree<ItemType>::CBinaryNodeTree(const ItemType &rootItem,
                    const CBinaryNodeTree<ItemType> *leftTreePtr,
                    const CBinaryNodeTree<ItemType> *rightTreePtr)
 {
-	Clear();
 	m_rootPtr = new CBinaryNode<ItemType>;
 	m_rootPtr->SetItem(rootItem);
 
@@ -102,7 +103,6 @@ CBinaryNodeTree<ItemType>::CBinaryNodeTree(const ItemType &rootItem,
 template <class ItemType>
 CBinaryNodeTree<ItemType>::CBinaryNodeTree(const CBinaryNodeTree<ItemType> &tree)
 {
-	Clear();
 	m_rootPtr = CopyTree(tree.m_rootPtr);
 }
 
@@ -148,7 +148,7 @@ CBinaryNodeTree<ItemType>::~CBinaryNodeTree()
 //
 // ============================================================================
 template <class ItemType>
-bool CBinaryNodeTree<ItemType>::IsEmpty() const
+bool CBinaryNodeTree<ItemType>::IsEmpty() const noexcept
 {
 	if (m_rootPtr == nullptr)
 	{
@@ -199,6 +199,26 @@ int CBinaryNodeTree<ItemType>::GetNumberOfNodes() const
 
 
 
+// ==== Stats =================================================================
+//
+// Reports the shape of the tree and the memory its nodes use by calling the
+// function StatsHelper.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeStats  -  the report
+//
+// ============================================================================
+template <class ItemType>
+CTreeStats CBinaryNodeTree<ItemType>::Stats() const
+{
+	return StatsHelper(m_rootPtr);
+}
+
+
+
 // ==== GetRootData ===========================================================
 //
 // Gets the item at root location.
@@ -213,8 +233,7 @@ int CBinaryNodeTree<ItemType>::GetNumberOfNodes() const
 //
 // ============================================================================
 template <class ItemType>
-ItemType CBinaryNodeTree<ItemType>::GetRootData()
-									const throw(PrecondViolatedExcept)
+ItemType CBinaryNodeTree<ItemType>::GetRootData() const
 {
 	if (m_rootPtr != nullptr)
 	{
@@ -270,6 +289,8 @@ void CBinaryNodeTree<ItemType>::SetRootData(const ItemType &newData)
 template <class ItemType>
 bool CBinaryNodeTree<ItemType>::Add(const ItemType &newData)
 {
+	BST_TIME(TREE_OP_ADD);
+
 	CBinaryNode<ItemType> *newNode = new CBinaryNode<ItemType>;
 	newNode->SetItem(newData);
 	
@@ -296,6 +317,8 @@ bool CBinaryNodeTree<ItemType>::Add(const ItemType &newData)
 template <class ItemType>
 bool CBinaryNodeTree<ItemType>::Remove(const ItemType &data)
 {
+	BST_TIME(TREE_OP_REMOVE);
+
 	//success gets updated to true if removal was successful
 	bool success;
 	success = false;
@@ -323,11 +346,6 @@ bool CBinaryNodeTree<ItemType>::Remove(const ItemType &data)
 		return true;
 	}
 
-	CBinaryNode<ItemType>* nodeLocation;
-	nodeLocation = FindNode(m_rootPtr, data, success);
-	
-	CBinaryNode<ItemType>* nodeParent;
-	nodeParent = FindParent(m_rootPtr, data);
 	if ((m_rootPtr->GetItem() == data)	&&
 	    (m_rootPtr->GetRightChildPtr() != nullptr ||
 		 m_rootPtr->GetLeftChildPtr() != nullptr))
@@ -337,6 +355,22 @@ bool CBinaryNodeTree<ItemType>::Remove(const ItemType &data)
 		success = true;
 		return success;
 	}
+
+	CBinaryNode<ItemType>* nodeParent;
+	nodeParent = FindParent(m_rootPtr, data);
+
+	//take the node from the parent found, checking the right child first
+	//like the code below, so that with duplicates both refer to one copy
+	CBinaryNode<ItemType>* nodeLocation;
+	if (nodeParent->GetRightChildPtr() != nullptr &&
+		nodeParent->GetRightChildPtr()->GetItem() == data)
+	{
+		nodeLocation = nodeParent->GetRightChildPtr();
+	}
+	else
+	{
+		nodeLocation = nodeParent->GetLeftChildPtr();
+	}
 	
 	if (nodeLocation->IsLeaf())
 	{
@@ -421,20 +455,16 @@ bool CBinaryNodeTree<ItemType>::Remove(const ItemType &data)
 template <class ItemType>
 void CBinaryNodeTree<ItemType>::Clear()
 {
+	//DestroyTree frees the root too, so only the pointer is left to reset
 	DestroyTree(m_rootPtr);
-	if (m_rootPtr != nullptr)
-	{
-		m_rootPtr->SetLeftChildPtr(nullptr);
-		m_rootPtr->SetRightChildPtr(nullptr);
-		m_rootPtr = nullptr;
-	}
+	m_rootPtr = nullptr;
 }
 
 
 
 // ==== GetEntry ==============================================================
 //
-// Retrieves an entry from the tree.  This function calls FindNode. 
+// Retrieves an entry from the tree.  This function calls FindOrNull. 
 //
 // Input:
 //		ItemType anEntry	[IN] -  An ItemType that will be used to retrieve
@@ -447,22 +477,15 @@ void CBinaryNodeTree<ItemType>::Clear()
 // ============================================================================
 template <class ItemType>
 ItemType CBinaryNodeTree<ItemType>::GetEntry(const ItemType &anEntry) const
-                             						throw(NotFoundException)
 {
-	bool success;
-	success = false;
-	FindNode(m_rootPtr, anEntry, success);
-	if (success == true)
-	{
-		//why do we want to return an ItemType if we already know the value
-		//would be anEntry??
-		return anEntry;
-	}
-	else
+	const ItemType *entryPtr = FindOrNull(anEntry);
+	if (entryPtr == nullptr)
 	{
 		NotFoundException exception("Entry does not exist");
 		throw exception;
 	}
+
+	return *entryPtr;
 }
 
 
@@ -481,7 +504,10 @@ ItemType CBinaryNodeTree<ItemType>::GetEntry(const ItemType &anEntry) const
 // ============================================================================
 template <class ItemType>
 bool CBinaryNodeTree<ItemType>::Contains(const ItemType &anEntry) const
+																noexcept
 {
+	BST_TIME(TREE_OP_FIND);
+
 	//success gets updates to true if found
 	bool success;
 	success = false;
@@ -492,6 +518,37 @@ bool CBinaryNodeTree<ItemType>::Contains(const ItemType &anEntry) const
 
 
 
+// ==== FindOrNull ============================================================
+//
+// Finds an item in the tree without throwing.  This function calls
+// FindNode.
+//
+// Input:
+//		ItemType anEntry	[IN] - An ItemType that will be used to find an
+//								   item.
+//
+// Output:
+//		const ItemType*  -  the item in the tree, or nullptr if not found
+//
+// ============================================================================
+template <class ItemType>
+const ItemType* CBinaryNodeTree<ItemType>::FindOrNull(const ItemType &anEntry)
+															const noexcept
+{
+	BST_TIME(TREE_OP_FIND);
+
+	bool success = false;
+	CBinaryNode<ItemType> *nodePtr = FindNode(m_rootPtr, anEntry, success);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &nodePtr->GetItemRef();
+}
+
+
+
 // ==== PreorderTraverse ======================================================
 //
 // A function used to transverse the tree in preorder.  Calls the function
@@ -562,6 +619,141 @@ void CBinaryNodeTree<ItemType>::PostorderTraverse(
 
 
 
+// ==== Preorder ==============================================================
+//
+// Visits the items lazily in preorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template <class ItemType>
+CTreeGenerator<ItemType> CBinaryNodeTree<ItemType>::Preorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_PREORDER);
+}
+
+
+
+// ==== Inorder ===============================================================
+//
+// Visits the items lazily in inorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template <class ItemType>
+CTreeGenerator<ItemType> CBinaryNodeTree<ItemType>::Inorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_INORDER);
+}
+
+
+
+// ==== Postorder =============================================================
+//
+// Visits the items lazily in postorder.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template <class ItemType>
+CTreeGenerator<ItemType> CBinaryNodeTree<ItemType>::Postorder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_POSTORDER);
+}
+
+
+
+// ==== LevelOrder ============================================================
+//
+// Visits the items lazily in level order.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeGenerator<ItemType>  -  yields a reference to each item in turn
+//
+// ============================================================================
+template <class ItemType>
+CTreeGenerator<ItemType> CBinaryNodeTree<ItemType>::LevelOrder() const
+{
+	return CTreeGenerator<ItemType>(m_rootPtr, TRAVERSE_LEVEL_ORDER);
+}
+
+
+
+// ==== ParallelForEach =======================================================
+//
+// Calls Visit on every item on the workers of a pool.  Calls the function
+// ParallelWalk.
+//
+// Input:
+//		Visit		[IN] - takes an ItemType&
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template <class ItemType>
+template<class VisitType>
+void CBinaryNodeTree<ItemType>::ParallelForEach(VisitType Visit, int grainSize,
+												CWorkPool &pool)
+{
+	auto visitItem = [&Visit](ItemType &item, int)
+	{
+		Visit(item);
+	};
+
+	ParallelWalk(m_rootPtr, visitItem, grainSize, pool);
+}
+
+
+
+// ==== ParallelReduce ========================================================
+//
+// Combines Map(item) over every item on the workers of a pool.  Calls the
+// function ParallelReduceHelper.
+//
+// Input:
+//		Map			[IN] - takes a const ItemType&
+//		Combine		[IN] - combines two results into one
+//		identity	[IN] - the result of no items
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		ResultType  -  the combined result
+//
+// ============================================================================
+template <class ItemType>
+template<class ResultType, class MapType, class CombineType>
+ResultType CBinaryNodeTree<ItemType>::ParallelReduce(MapType Map,
+													 CombineType Combine,
+													 const ResultType &identity,
+													 int grainSize,
+													 CWorkPool &pool) const
+{
+	return ParallelReduceHelper(m_rootPtr, Map, Combine, identity, grainSize,
+								pool);
+}
+
+
+
 // ==== Overloaded Assignment Operator ========================================
 //
 // Used to check if two CBinaryNodeTree are the same.
@@ -667,6 +859,268 @@ int CBinaryNodeTree<ItemType>::GetNumberOfNodesHelper(
 
 
 
+// ==== ParallelWalk ==========================================================
+//
+// Calls Visit(item, worker) on every item below rootPtr on the workers of
+// a pool, starting with the whole tree as one task.
+//
+// Input:
+//		rootPtr		[IN] - the root of the tree
+//		Visit		[IN] - takes an ItemType& and the index of the worker
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template <class ItemType>
+template<class VisitType>
+void CBinaryNodeTree<ItemType>::ParallelWalk(CBinaryNode<ItemType> *rootPtr,
+											 VisitType &Visit, int grainSize,
+											 CWorkPool &pool) const
+{
+	if (rootPtr == nullptr)
+	{
+		return;
+	}
+
+	pool.Run([this, rootPtr, &Visit, grainSize, &pool](int worker)
+	{
+		ParallelWalkTask(rootPtr, worker, Visit, grainSize, pool);
+	});
+}
+
+
+
+// ==== ParallelWalkTask ======================================================
+//
+// Walks a subtree as one task of ParallelWalk, in preorder on an explicit
+// stack.  The stack holds the right subtrees still to be walked, largest
+// at the bottom, so each split hands the bottom one to the pool: the split
+// moves as much work as one subtree can, and the task keeps the rest.  The
+// tree has no subtree sizes to split by up front; splitting only while a
+// worker is idle adapts to any shape of tree.
+//
+// Input:
+//		treePtr		[IN] - the root of the subtree
+//		worker		[IN] - the index of the worker running the task
+//		Visit		[IN] - takes an ItemType& and the index of the worker
+//		grainSize	[IN] - the items to visit between offers to split
+//		pool		[IN/OUT] - the pool the task runs on
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template <class ItemType>
+template<class VisitType>
+void CBinaryNodeTree<ItemType>::ParallelWalkTask(CBinaryNode<ItemType> *treePtr,
+												 int worker, VisitType &Visit,
+												 int grainSize,
+												 CWorkPool &pool) const
+{
+	vector<CBinaryNode<ItemType>*> stack(1, treePtr);
+	size_t bottom = 0;
+	int sinceSplit = 0;
+
+	while (bottom < stack.size())
+	{
+		if (++sinceSplit >= grainSize && stack.size() - bottom > 1 &&
+			pool.HasIdleWorkers())
+		{
+			CBinaryNode<ItemType> *splitPtr = stack[bottom++];
+			pool.Spawn(worker, [this, splitPtr, &Visit, grainSize,
+								&pool](int thief)
+			{
+				ParallelWalkTask(splitPtr, thief, Visit, grainSize, pool);
+			});
+			sinceSplit = 0;
+		}
+
+		CBinaryNode<ItemType> *nodePtr = stack.back();
+		stack.pop_back();
+		Visit(nodePtr->GetItemRef(), worker);
+
+		if (nodePtr->GetRightChildPtr() != nullptr)
+		{
+			stack.push_back(nodePtr->GetRightChildPtr());
+		}
+		if (nodePtr->GetLeftChildPtr() != nullptr)
+		{
+			stack.push_back(nodePtr->GetLeftChildPtr());
+		}
+	}
+}
+
+
+
+// ==== ParallelReduceHelper ==================================================
+//
+// ParallelReduce over the items below rootPtr.  Each worker combines into a
+// result of its own, on a cache line of its own, and the results of the
+// workers are combined once the walk is done.
+//
+// Input:
+//		rootPtr		[IN] - the root of the tree
+//		Map			[IN] - takes a const ItemType&
+//		Combine		[IN] - combines two results into one
+//		identity	[IN] - the result of no items
+//		grainSize	[IN] - the items a task visits before it offers to split
+//		pool		[IN/OUT] - the pool to run on
+//
+// Output:
+//		ResultType  -  the combined result
+//
+// ============================================================================
+template <class ItemType>
+template<class ResultType, class MapType, class CombineType>
+ResultType CBinaryNodeTree<ItemType>::ParallelReduceHelper(
+										CBinaryNode<ItemType> *rootPtr,
+										MapType &Map, CombineType &Combine,
+										const ResultType &identity,
+										int grainSize, CWorkPool &pool) const
+{
+	struct alignas(64) CWorkerResult
+	{
+		ResultType m_value;
+	};
+
+	vector<CWorkerResult> results(pool.GetWorkerCount(),
+								  CWorkerResult{identity});
+	auto combineItem = [&results, &Map, &Combine](ItemType &item, int worker)
+	{
+		const ItemType &constItem = item;
+		results[worker].m_value = Combine(results[worker].m_value,
+										  Map(constItem));
+	};
+	ParallelWalk(rootPtr, combineItem, grainSize, pool);
+
+	ResultType total = identity;
+	for (size_t worker = 0; worker < results.size(); ++worker)
+	{
+		total = Combine(total, results[worker].m_value);
+	}
+
+	return total;
+}
+
+
+
+// ==== StatsHelper ===========================================================
+//
+// This function measures the tree by providing the root/subtree root
+// pointer.  The nodes are walked in postorder on an explicit stack holding
+// the path from the root, so every node is visited once and the height of
+// each subtree is known when its root is left, which gives the balance
+// factor of every node along with the height of the tree.
+//
+// Input:
+//		subTreePtr	[IN] - A pointer of CBinaryNodeTree type for the root of
+//						   the tree.
+//
+// Output:
+//		CTreeStats - the report
+//
+// ============================================================================
+template <class ItemType>
+CTreeStats CBinaryNodeTree<ItemType>::StatsHelper(
+								const CBinaryNode<ItemType> *subTreePtr) const
+{
+	// A node on the path from the root, with the heights of the subtrees
+	// that have been walked so far
+	struct CStatsFrame
+	{
+		const CBinaryNode<ItemType>	*nodePtr;
+		int							depth;
+		int							leftHeight;
+		int							rightHeight;
+		int							state;	// 0 new, 1 in left, 2 in right
+	};
+
+	CTreeStats stats;
+	vector<CStatsFrame> path;
+	long long pathTotal = 0;
+
+	if (subTreePtr != nullptr)
+	{
+		path.push_back(CStatsFrame{subTreePtr, 0, 0, 0, 0});
+	}
+
+	while (!path.empty())
+	{
+		CStatsFrame &frame = path.back();
+		const CBinaryNode<ItemType> *childPtr = nullptr;
+		int childDepth = frame.depth + 1;
+
+		if (frame.state == 0)
+		{
+			if ((size_t)frame.depth >= stats.m_depthHistogram.size())
+			{
+				stats.m_depthHistogram.resize(frame.depth + 1, 0);
+			}
+			++stats.m_depthHistogram[frame.depth];
+			++stats.m_nodeCount;
+			pathTotal += frame.depth + 1;
+			stats.m_payloadHeapBytes += HeapBytes(frame.nodePtr->GetItemRef());
+			stats.m_allocatedBytes += AllocatedBytes(frame.nodePtr,
+											sizeof(CBinaryNode<ItemType>));
+
+			frame.state = 1;
+			childPtr = frame.nodePtr->GetLeftChildPtr();
+		}
+		else if (frame.state == 1)
+		{
+			frame.state = 2;
+			childPtr = frame.nodePtr->GetRightChildPtr();
+		}
+		else
+		{
+			int height = max(frame.leftHeight, frame.rightHeight) + 1;
+			++stats.m_balanceFactors[frame.leftHeight - frame.rightHeight];
+			path.pop_back();
+
+			// Hand the height to the parent, which is in the subtree the
+			// state says
+			if (path.empty())
+			{
+				stats.m_height = height;
+			}
+			else if (path.back().state == 1)
+			{
+				path.back().leftHeight = height;
+			}
+			else
+			{
+				path.back().rightHeight = height;
+			}
+		}
+
+		if (childPtr != nullptr)
+		{
+			path.push_back(CStatsFrame{childPtr, childDepth, 0, 0, 0});
+		}
+	}
+
+	stats.m_worstPathLength = stats.m_height;
+	stats.m_nodeBytes = stats.m_nodeCount * sizeof(CBinaryNode<ItemType>);
+	stats.m_payloadBytes = stats.m_nodeCount * sizeof(ItemType);
+	if (stats.m_nodeCount > 0)
+	{
+		stats.m_averagePathLength = (double)pathTotal / stats.m_nodeCount;
+	}
+	if (stats.m_allocatedBytes > stats.m_nodeBytes)
+	{
+		stats.m_fragmentation = (double)(stats.m_allocatedBytes -
+										 stats.m_nodeBytes) /
+								stats.m_allocatedBytes;
+	}
+
+	return stats;
+}
+
+
+
 // ==== BalancedAdd ===========================================================
 //
 // Recursively adds a new node to the tree in a left/right fashion to keep the
@@ -925,6 +1379,7 @@ CBinaryNode<ItemType>* CBinaryNodeTree<ItemType>::FindNode(
 		success = false;
 		return nullptr;
 	}
+	BST_COUNT(TREE_NODES_VISITED, 1);
 	if (treePtr->GetItem() == target)
 	{
 		success = true;
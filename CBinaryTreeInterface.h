@@ -7,7 +7,10 @@
 #ifndef CBINARY_TREE_INTERFACE_HEADER
 #define CBINARY_TREE_INTERFACE_HEADER
 
+#include <functional>
+#include <optional>
 #include "NotFoundException.h"
+#include "CTreeStats.h"
 
 template<class ItemType>
 class CBinaryTreeInterface
@@ -15,7 +18,7 @@ class CBinaryTreeInterface
 public:
    /** Tests whether this binary tree is empty.
     @return True if the binary tree is empty, or false if not. */
-   virtual bool IsEmpty() const = 0;
+   virtual bool IsEmpty() const noexcept = 0;
    
    /** Gets the height of this binary tree.
     @return The height of the binary tree. */
@@ -24,6 +27,11 @@ public:
    /** Gets the number of nodes in this binary tree.
     @return The number of nodes in the binary tree. */
    virtual int GetNumberOfNodes() const = 0;
+
+   /** Reports the shape of this binary tree and the memory its nodes use,
+       in one pass over the nodes.
+    @return  The report. */
+   virtual CTreeStats Stats() const = 0;
    
    /** Gets the data that is in the root of this binary tree.
     @pre  The binary tree is not empty.
@@ -60,14 +68,38 @@ public:
     @param anEntry  The entry to locate.
     @return  The entry in the binary tree that matches the given entry.
     @throw  NotFoundException if the given entry is not in the tree. */
-   virtual ItemType GetEntry(const ItemType& anEntry) const
-                    throw(NotFoundException) = 0;
+   virtual ItemType GetEntry(const ItemType& anEntry) const = 0;
    
    /** Tests whether a given entry occurs in this binary tree.
     @post  The binary search tree is unchanged.
     @param anEntry  The entry to find.
     @return  True if the entry occurs in the tree, or false if not. */
-   virtual bool Contains(const ItemType& anEntry) const = 0;
+   virtual bool Contains(const ItemType& anEntry) const noexcept = 0;
+
+   /** Finds a specific entry in this binary tree without throwing, so a
+       miss costs no more than a hit.
+    @post  The binary tree is unchanged.
+    @param anEntry  The entry to locate.
+    @return  A pointer to the entry in the tree, valid until the tree next
+             changes, or nullptr if the entry is not in the tree. */
+   virtual const ItemType* FindOrNull(const ItemType& anEntry) const
+                                                            noexcept = 0;
+
+   /** Gets a specific entry in this binary tree without throwing.
+    @post  The binary tree is unchanged.
+    @param anEntry  The entry to locate.
+    @return  The entry in the tree, valid until the tree next changes, or
+             std::nullopt if the entry is not in the tree. */
+   std::optional<std::reference_wrapper<const ItemType> >
+   TryGetEntry(const ItemType& anEntry) const noexcept
+   {
+      const ItemType *entryPtr = FindOrNull(anEntry);
+      if (entryPtr == nullptr)
+      {
+         return std::nullopt;
+      }
+      return std::cref(*entryPtr);
+   }
    
    /** Traverses this binary tree in preorder (inorder, postorder) and
        calls the function Visit once for each node.
@@ -0,0 +1,87 @@
+// ============================================================================
+// File: CBoundedQueue.h
+// ============================================================================
+// Header file for the class CBoundedQueue (bounded lock-free MPMC queue)
+// ============================================================================
+
+#ifndef CBOUNDEDQUEUE_HEADER
+#define CBOUNDEDQUEUE_HEADER
+
+#include <atomic>
+#include <cstddef>
+
+template<class ItemType>
+class CBoundedQueue
+{
+public:
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Allocates the ring of cells.  The capacity is rounded up to the next
+       power of two so a slot can be found with a mask instead of a modulo. */
+   CBoundedQueue(int capacity);
+
+   /** Destructor.  Releases the ring of cells. */
+   ~CBoundedQueue();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Tries to move an item into the queue without waiting.
+    @param item: The item to enqueue.  It is moved from only on success.
+    @return  True if the item was enqueued, or false if the queue is full. */
+   bool TryPush(ItemType &item);
+
+   /** Tries to move an item out of the queue without waiting.
+    @param item: Receives the dequeued item on success.
+    @return  True if an item was dequeued, or false if the queue is empty. */
+   bool TryPop(ItemType &item);
+
+   /** Enqueues an item, yielding while the queue is full.  This is what gives
+       the pipeline its back-pressure: a fast producer stalls here instead of
+       buffering without bound.
+    @param item: The item to enqueue.
+    @return  Nothing. */
+   void Push(ItemType &item);
+
+   /** Dequeues an item, yielding while the queue is empty.
+    @param item: Receives the dequeued item.
+    @return  True if an item was dequeued, or false if the queue is empty
+             and Close has been called. */
+   bool Pop(ItemType &item);
+
+   /** Marks the queue as closed.  Must only be called after every producer
+       has finished pushing.
+    @param Nothing.
+    @return  Nothing. */
+   void Close();
+
+private:
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   struct CCell
+   {
+      std::atomic<size_t>  m_sequence;
+      ItemType             m_data;
+   };
+
+   CCell                *m_cells;      // Ring of cells
+   size_t                m_mask;       // Capacity - 1
+   std::atomic<bool>     m_closed;     // Set once producers are finished
+
+   // producer and consumer cursors live on separate cache lines
+   alignas(64) std::atomic<size_t> m_enqueuePos;
+   alignas(64) std::atomic<size_t> m_dequeuePos;
+
+   /** Copying a queue would copy its atomics; disallow it. */
+   CBoundedQueue(const CBoundedQueue<ItemType> &queue);
+   CBoundedQueue<ItemType>& operator=(const CBoundedQueue<ItemType> &rhs);
+}; // end CBoundedQueue
+
+#include "CBoundedQueue.tpp"
+
+#endif  // CBOUNDEDQUEUE_HEADER
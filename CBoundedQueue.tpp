@@ -0,0 +1,237 @@
+// ============================================================================
+// File: CBoundedQueue.tpp
+// ============================================================================
+// This is the implementation file for the class CBoundedQueue which
+// impliments a bounded multi-producer/multi-consumer ring buffer.  Every cell
+// carries a sequence number that tells producers and consumers whose turn it
+// is, so no locks are taken on either side.
+// ============================================================================
+
+#include <thread>
+#include <utility>
+#include "CBoundedQueue.h"
+
+
+
+// ==== Type Constructor ======================================================
+//
+// Allocates the ring of cells.  The capacity is rounded up to the next power
+// of two so a slot can be found with a mask instead of a modulo.
+//
+// Input:
+//		capacity	[IN] - the minimum number of items the queue can hold
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CBoundedQueue<ItemType>::CBoundedQueue(int capacity) : m_closed(false),
+								m_enqueuePos(0), m_dequeuePos(0)
+{
+	size_t size = 2;
+	while (size < (size_t)capacity)
+	{
+		size = size * 2;
+	}
+
+	m_cells = new CCell[size];
+	m_mask = size - 1;
+
+	for (size_t index = 0; index < size; ++index)
+	{
+		m_cells[index].m_sequence.store(index, std::memory_order_relaxed);
+	}
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Releases the ring of cells.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CBoundedQueue<ItemType>::~CBoundedQueue()
+{
+	delete [] m_cells;
+}
+
+
+
+// ==== TryPush ===============================================================
+//
+// Tries to move an item into the queue without waiting.  A cell is free for
+// the producer at position pos when its sequence equals pos.
+//
+// Input:
+//		item	[IN/OUT] - the item to enqueue; moved from only on success
+//
+// Output:
+//		bool  -  True if the item was enqueued, false if the queue is full
+//
+// ============================================================================
+template<class ItemType>
+bool CBoundedQueue<ItemType>::TryPush(ItemType &item)
+{
+	size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		CCell *cell = &m_cells[pos & m_mask];
+		size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+		long long diff = (long long)sequence - (long long)pos;
+
+		if (diff == 0)
+		{
+			//claim the cell; on failure pos is reloaded and we try again
+			if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+												 std::memory_order_relaxed))
+			{
+				cell->m_data = std::move(item);
+				cell->m_sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			//the consumer has not released this cell yet, so we are full
+			return false;
+		}
+		else
+		{
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+
+
+// ==== TryPop ================================================================
+//
+// Tries to move an item out of the queue without waiting.  A cell holds data
+// for the consumer at position pos when its sequence equals pos + 1.
+//
+// Input:
+//		item	[OUT] - receives the dequeued item on success
+//
+// Output:
+//		bool  -  True if an item was dequeued, false if the queue is empty
+//
+// ============================================================================
+template<class ItemType>
+bool CBoundedQueue<ItemType>::TryPop(ItemType &item)
+{
+	size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		CCell *cell = &m_cells[pos & m_mask];
+		size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+		long long diff = (long long)sequence - (long long)(pos + 1);
+
+		if (diff == 0)
+		{
+			if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+												 std::memory_order_relaxed))
+			{
+				item = std::move(cell->m_data);
+				//hand the cell back to producers one lap later
+				cell->m_sequence.store(pos + m_mask + 1,
+									   std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			pos = m_dequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+
+
+// ==== Push ==================================================================
+//
+// Enqueues an item, yielding while the queue is full.
+//
+// Input:
+//		item	[IN/OUT] - the item to enqueue
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBoundedQueue<ItemType>::Push(ItemType &item)
+{
+	while (!TryPush(item))
+	{
+		std::this_thread::yield();
+	}
+}
+
+
+
+// ==== Pop ===================================================================
+//
+// Dequeues an item, yielding while the queue is empty.  Once the queue has
+// been closed, one last attempt is made so that nothing pushed before Close
+// is lost.
+//
+// Input:
+//		item	[OUT] - receives the dequeued item
+//
+// Output:
+//		bool  -  True if an item was dequeued, false if the queue is drained
+//				 and closed
+//
+// ============================================================================
+template<class ItemType>
+bool CBoundedQueue<ItemType>::Pop(ItemType &item)
+{
+	for (;;)
+	{
+		if (TryPop(item))
+		{
+			return true;
+		}
+
+		if (m_closed.load(std::memory_order_acquire))
+		{
+			return TryPop(item);
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+
+
+// ==== Close =================================================================
+//
+// Marks the queue as closed.  Must only be called after every producer has
+// finished pushing.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CBoundedQueue<ItemType>::Close()
+{
+	m_closed.store(true, std::memory_order_release);
+}
@@ -0,0 +1,134 @@
+// ============================================================================
+// File: CCachedBST.h
+// ============================================================================
+// Header file for the class CCachedBST (CBST with a lookup cache for hot
+// keys)
+// ============================================================================
+
+#ifndef CCACHEDBST_HEADER
+#define CCACHEDBST_HEADER
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "CBST.h"
+
+// Default number of cache slots; always rounded up to a power of two
+const int BST_CACHE_SLOTS = 1024;
+
+template<class ItemType>
+class CCachedBST : public CBST<ItemType>
+{
+public:
+   typedef typename CBST<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree.
+    @param cacheSlots: The number of cache slots, rounded up to a power of
+                       two.  Each slot remembers the node of one key. */
+   CCachedBST(int cacheSlots = BST_CACHE_SLOTS);
+
+   /** Copy constructor.  The cache starts empty. */
+   CCachedBST(const CCachedBST<ItemType> &tree);
+
+   /** Destructor. */
+   virtual ~CCachedBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Finds an item.  A key whose node is cached is answered without
+       descending the tree; otherwise the node found is cached.  Contains,
+       GetEntry and TryGetEntry all go through it.  The cache is written
+       through this const function, so a CCachedBST must not be read from
+       several threads at once.
+    @param anEntry: The item to look for.
+    @return  A pointer to the item in the tree, or nullptr if it is not
+             found. */
+   const ItemType* FindOrNull(const ItemType &anEntry) const
+                                                   noexcept override;
+
+   /** Returns the number of lookups answered from the cache.
+    @param Nothing.
+    @return  The number of cache hits. */
+   long long GetCacheHits() const;
+
+   /** Returns the number of lookups that had to search the tree.
+    @param Nothing.
+    @return  The number of cache misses. */
+   long long GetCacheMisses() const;
+
+   /** Sets the hit and miss counters back to zero.
+    @param Nothing.
+    @return  Nothing. */
+   void ResetCacheStats();
+
+   /** Overloaded assignment operator.  The cache is flushed.
+    @param rhs: A const CCachedBST reference object.
+    @return  CCachedBST reference object. */
+   CCachedBST<ItemType>& operator=(const CCachedBST<ItemType> &rhs);
+
+protected:
+   // =========================================================================
+   //      Protected Member Functions
+   // =========================================================================
+
+   /** Flushes the cache.  CBST rebuilds its nodes whenever the items change,
+       so no cached node can be trusted afterwards.
+    @return  nothing */
+   void OnContentsChanged() override;
+
+private:
+   // =========================================================================
+   //      Private Types
+   // =========================================================================
+
+   // A slot is valid only while its generation is the tree's, so a flush
+   // just starts a new generation.
+   struct CSlot
+   {
+      CSlot() : m_nodePtr(nullptr), m_generation(0) {}
+
+      CBinaryNode<ItemType>   *m_nodePtr;
+      size_t                  m_generation;
+   };
+
+   // The slots are stored a cache line at a time, aligned to the line, so
+   // no slot straddles two lines and a hit costs one miss at most
+   static const size_t SLOTS_PER_LINE = 64 / sizeof(CSlot);
+   static_assert(64 % sizeof(CSlot) == 0, "a slot must divide a cache line");
+
+   struct alignas(64) CSlotLine
+   {
+      CSlot                   m_slots[SLOTS_PER_LINE];
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Returns the slot of a key.
+    @param key: The key.
+    @return  The slot the key hashes to. */
+   CSlot& GetSlot(const KeyType &key) const;
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   // The cache and its counters change on const lookups, hence mutable.
+   // std::allocator honors the alignment of CSlotLine since C++17.
+   mutable std::vector<CSlotLine>   m_lines;       // Direct mapped by hash
+   size_t                           m_mask;        // Number of slots - 1
+   size_t                           m_generation;  // Bumped by every change
+   mutable long long                m_hits;
+   mutable long long                m_misses;
+}; // end CCachedBST
+
+#include "CCachedBST.tpp"
+
+#endif  // CCACHEDBST_HEADER
@@ -0,0 +1,248 @@
+// ============================================================================
+// File: CCachedBST.tpp
+// ============================================================================
+// This is the implementation file for the class CCachedBST.  A small
+// direct-mapped table maps the hash of a key to the node last found for it,
+// so repeated lookups of the same keys cost one hash, one slot read and one
+// item comparison instead of a walk down the tree.  The balanced shape of
+// the tree is left untouched.
+// ============================================================================
+
+#include "CCachedBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree with an empty cache.
+//
+// Input:
+//		cacheSlots	[IN] - the number of slots, rounded up to a power of two
+//					   and to at least a cache line of them
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CCachedBST<ItemType>::CCachedBST(int cacheSlots) : m_generation(1),
+												   m_hits(0), m_misses(0)
+{
+	size_t size = SLOTS_PER_LINE;
+	while (size < (size_t)cacheSlots)
+	{
+		size *= 2;
+	}
+	m_lines.resize(size / SLOTS_PER_LINE);
+	m_mask = size - 1;
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the items of the tree and the size of its cache.  The cache and
+// its counters start empty.
+//
+// Input:
+//		tree	[IN] - a const CCachedBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CCachedBST<ItemType>::CCachedBST(const CCachedBST<ItemType> &tree) :
+								CBST<ItemType>(tree),
+								m_lines(tree.m_lines.size()),
+								m_mask(tree.m_mask), m_generation(1),
+								m_hits(0), m_misses(0)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST releases.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CCachedBST<ItemType>::~CCachedBST()
+{
+
+}
+
+
+
+// ==== GetCacheHits ==========================================================
+//
+// Returns the number of lookups answered from the cache.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		long long  -  the number of cache hits
+//
+// ============================================================================
+template<class ItemType>
+long long CCachedBST<ItemType>::GetCacheHits() const
+{
+	return m_hits;
+}
+
+
+
+// ==== GetCacheMisses ========================================================
+//
+// Returns the number of lookups that had to search the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		long long  -  the number of cache misses
+//
+// ============================================================================
+template<class ItemType>
+long long CCachedBST<ItemType>::GetCacheMisses() const
+{
+	return m_misses;
+}
+
+
+
+// ==== ResetCacheStats =======================================================
+//
+// Sets the hit and miss counters back to zero.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CCachedBST<ItemType>::ResetCacheStats()
+{
+	m_hits = 0;
+	m_misses = 0;
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the items of rhs.  CBST::operator= calls OnContentsChanged, which
+// flushes the cache.
+//
+// Input:
+//		rhs	[IN] - A const CCachedBST reference object.
+//
+// Output:
+//		CCachedBST - a CCachedBST reference object
+//
+// ============================================================================
+template<class ItemType>
+CCachedBST<ItemType>& CCachedBST<ItemType>::operator=(
+											const CCachedBST<ItemType> &rhs)
+{
+	CBST<ItemType>::operator=(rhs);
+
+	return *this;
+}
+
+
+
+// ==== OnContentsChanged =====================================================
+//
+// Flushes the cache by starting a new generation, which invalidates every
+// slot without touching them.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CCachedBST<ItemType>::OnContentsChanged()
+{
+	++m_generation;
+}
+
+
+
+// ==== FindOrNull ============================================================
+//
+// Checks the key's slot first.  The cached node is used only if it is from
+// the current generation and its item is == anEntry; otherwise the tree is
+// searched and the node found replaces whatever the slot held.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		const ItemType*  -  the item in the tree, or nullptr if not found
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CCachedBST<ItemType>::FindOrNull(const ItemType &anEntry)
+															const noexcept
+{
+	BST_TIME(TREE_OP_FIND);
+
+	CSlot &slot = GetSlot(CKeyTraits<ItemType>::GetKey(anEntry));
+
+	if (slot.m_generation == m_generation &&
+		slot.m_nodePtr->GetItemRef() == anEntry)
+	{
+		++m_hits;
+		return &slot.m_nodePtr->GetItemRef();
+	}
+
+	++m_misses;
+	CBinaryNode<ItemType> *nodePtr = this->FindNode(this->GetRootPtr(),
+													 anEntry);
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	slot.m_nodePtr = nodePtr;
+	slot.m_generation = m_generation;
+
+	return &nodePtr->GetItemRef();
+}
+
+
+
+// ==== GetSlot ===============================================================
+//
+// Returns the slot a key hashes to.  Both divisions are by a power of two.
+//
+// Input:
+//		key	[IN] - the key
+//
+// Output:
+//		CSlot&  -  the slot
+//
+// ============================================================================
+template<class ItemType>
+typename CCachedBST<ItemType>::CSlot& CCachedBST<ItemType>::GetSlot(
+												const KeyType &key) const
+{
+	size_t index = std::hash<KeyType>()(key) & m_mask;
+
+	return m_lines[index / SLOTS_PER_LINE].m_slots[index % SLOTS_PER_LINE];
+}
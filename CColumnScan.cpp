@@ -0,0 +1,429 @@
+// ============================================================================
+// File: CColumnScan.cpp
+// ============================================================================
+// Implimentation file for the column scan kernels.  Every kernel finds the
+// rows outside [low, high] with two signed compares of the keys, and uses
+// that mask to keep those rows out of the aggregates: their values are
+// masked to 0 for the sum and to the opposite infinity for the minimum and
+// maximum, and the rows are counted to be subtracted from the total.
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+using namespace std;
+#include "CColumnScan.h"
+
+// Every x86-64 CPU runs SSE2; AVX2 is checked for at run time
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define SCAN_X86
+#endif
+
+// Vector steps ScanCount takes before moving its 32-bit lane counts into
+// a 64-bit total, few enough that no lane can overflow
+const unsigned int   SCAN_FLUSH_STEPS = 1u << 20;
+
+// ==== ScanAggregateTail =====================================================
+//
+// Aggregates rows one at a time into a partial result; the whole scan on
+// CPUs without vector kernels, and the last few rows otherwise.
+//
+// Input:
+//		keys, values, low, high	[IN] - as for ScanAggregate
+//		first					[IN] - the first row to aggregate
+//		count					[IN] - one past the last row to aggregate
+//		result					[IN/OUT] - the partial result
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void ScanAggregateTail(const int keys[], const double values[],
+							  size_t first, size_t count, int low, int high,
+							  CColumnAggregate &result)
+{
+	for (size_t row = first; row < count; ++row)
+	{
+		if (keys[row] >= low && keys[row] <= high)
+		{
+			++result.m_count;
+			result.m_sum += values[row];
+			result.m_min = fmin(result.m_min, values[row]);
+			result.m_max = fmax(result.m_max, values[row]);
+		}
+	}
+}
+
+#ifdef SCAN_X86
+
+// ==== ScanAggregateAvx2 =====================================================
+//
+// Aggregates eight rows per step in two independent sets of four lanes, so
+// that consecutive adds do not wait on each other.
+//
+// Input:
+//		keys, values, count, low, high	[IN] - as for ScanAggregate
+//
+// Output:
+//		CColumnAggregate  -  the aggregates of the selected rows
+//
+// ============================================================================
+__attribute__((target("avx2")))
+static CColumnAggregate ScanAggregateAvx2(const int keys[],
+										  const double values[],
+										  size_t count, int low, int high)
+{
+	const __m128i lowKeys = _mm_set1_epi32(low);
+	const __m128i highKeys = _mm_set1_epi32(high);
+	const __m256d positiveHuge = _mm256_set1_pd(HUGE_VAL);
+	const __m256d negativeHuge = _mm256_set1_pd(-HUGE_VAL);
+
+	__m256d sum[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256d minimum[2] = { positiveHuge, positiveHuge };
+	__m256d maximum[2] = { negativeHuge, negativeHuge };
+	__m256i outside[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+	size_t row = 0;
+	for (; row + 8 <= count; row += 8)
+	{
+		for (int half = 0; half < 2; ++half)
+		{
+			__m128i key = _mm_loadu_si128(
+						reinterpret_cast<const __m128i*>(keys + row + 4 * half));
+			__m128i out = _mm_or_si128(_mm_cmpgt_epi32(lowKeys, key),
+									   _mm_cmpgt_epi32(key, highKeys));
+			__m256i outWide = _mm256_cvtepi32_epi64(out);
+			__m256d outMask = _mm256_castsi256_pd(outWide);
+			__m256d value = _mm256_loadu_pd(values + row + 4 * half);
+
+			sum[half] = _mm256_add_pd(sum[half],
+									  _mm256_andnot_pd(outMask, value));
+			minimum[half] = _mm256_min_pd(minimum[half],
+							_mm256_blendv_pd(value, positiveHuge, outMask));
+			maximum[half] = _mm256_max_pd(maximum[half],
+							_mm256_blendv_pd(value, negativeHuge, outMask));
+			outside[half] = _mm256_sub_epi64(outside[half], outWide);
+		}
+	}
+
+	double sumLanes[4];
+	double minLanes[4];
+	double maxLanes[4];
+	long long outLanes[4];
+	_mm256_storeu_pd(sumLanes, _mm256_add_pd(sum[0], sum[1]));
+	_mm256_storeu_pd(minLanes, _mm256_min_pd(minimum[0], minimum[1]));
+	_mm256_storeu_pd(maxLanes, _mm256_max_pd(maximum[0], maximum[1]));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(outLanes),
+						_mm256_add_epi64(outside[0], outside[1]));
+
+	CColumnAggregate result = { (long long)row, 0, HUGE_VAL, -HUGE_VAL };
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		result.m_count -= outLanes[lane];
+		result.m_sum += sumLanes[lane];
+		result.m_min = fmin(result.m_min, minLanes[lane]);
+		result.m_max = fmax(result.m_max, maxLanes[lane]);
+	}
+
+	ScanAggregateTail(keys, values, row, count, low, high, result);
+
+	return result;
+}
+
+
+
+// ==== ScanAggregateSse2 =====================================================
+//
+// Aggregates four rows per step, two in each pair of lanes.  SSE2 has no
+// blend, so the minimum and maximum select with and/or.
+//
+// Input:
+//		keys, values, count, low, high	[IN] - as for ScanAggregate
+//
+// Output:
+//		CColumnAggregate  -  the aggregates of the selected rows
+//
+// ============================================================================
+static CColumnAggregate ScanAggregateSse2(const int keys[],
+										  const double values[],
+										  size_t count, int low, int high)
+{
+	const __m128i lowKeys = _mm_set1_epi32(low);
+	const __m128i highKeys = _mm_set1_epi32(high);
+	const __m128d positiveHuge = _mm_set1_pd(HUGE_VAL);
+	const __m128d negativeHuge = _mm_set1_pd(-HUGE_VAL);
+
+	__m128d sum[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128d minimum[2] = { positiveHuge, positiveHuge };
+	__m128d maximum[2] = { negativeHuge, negativeHuge };
+	__m128i outside[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+
+	size_t row = 0;
+	for (; row + 4 <= count; row += 4)
+	{
+		__m128i key = _mm_loadu_si128(
+								reinterpret_cast<const __m128i*>(keys + row));
+		__m128i out = _mm_or_si128(_mm_cmpgt_epi32(lowKeys, key),
+								   _mm_cmpgt_epi32(key, highKeys));
+		__m128i outWide[2] = { _mm_unpacklo_epi32(out, out),
+							   _mm_unpackhi_epi32(out, out) };
+
+		for (int half = 0; half < 2; ++half)
+		{
+			__m128d outMask = _mm_castsi128_pd(outWide[half]);
+			__m128d value = _mm_loadu_pd(values + row + 2 * half);
+			__m128d kept = _mm_andnot_pd(outMask, value);
+
+			sum[half] = _mm_add_pd(sum[half], kept);
+			minimum[half] = _mm_min_pd(minimum[half],
+							_mm_or_pd(kept, _mm_and_pd(outMask, positiveHuge)));
+			maximum[half] = _mm_max_pd(maximum[half],
+							_mm_or_pd(kept, _mm_and_pd(outMask, negativeHuge)));
+			outside[half] = _mm_sub_epi64(outside[half], outWide[half]);
+		}
+	}
+
+	double sumLanes[2];
+	double minLanes[2];
+	double maxLanes[2];
+	long long outLanes[2];
+	_mm_storeu_pd(sumLanes, _mm_add_pd(sum[0], sum[1]));
+	_mm_storeu_pd(minLanes, _mm_min_pd(minimum[0], minimum[1]));
+	_mm_storeu_pd(maxLanes, _mm_max_pd(maximum[0], maximum[1]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(outLanes),
+					 _mm_add_epi64(outside[0], outside[1]));
+
+	CColumnAggregate result = { (long long)row, 0, HUGE_VAL, -HUGE_VAL };
+	for (int lane = 0; lane < 2; ++lane)
+	{
+		result.m_count -= outLanes[lane];
+		result.m_sum += sumLanes[lane];
+		result.m_min = fmin(result.m_min, minLanes[lane]);
+		result.m_max = fmax(result.m_max, maxLanes[lane]);
+	}
+
+	ScanAggregateTail(keys, values, row, count, low, high, result);
+
+	return result;
+}
+
+
+
+// ==== ScanCountAvx2 =========================================================
+//
+// Counts the rows outside the range eight per step, in 32-bit lanes that
+// are moved into the total every SCAN_FLUSH_STEPS steps.
+//
+// Input:
+//		keys, count, low, high	[IN] - as for ScanCount
+//
+// Output:
+//		long long  -  the number of rows selected
+//
+// ============================================================================
+__attribute__((target("avx2")))
+static long long ScanCountAvx2(const int keys[], size_t count, int low,
+							   int high)
+{
+	const __m256i lowKeys = _mm256_set1_epi32(low);
+	const __m256i highKeys = _mm256_set1_epi32(high);
+
+	long long outsideTotal = 0;
+	__m256i outside = _mm256_setzero_si256();
+	unsigned int steps = 0;
+	int lanes[8];
+
+	size_t row = 0;
+	for (; row + 8 <= count; row += 8)
+	{
+		__m256i key = _mm256_loadu_si256(
+								reinterpret_cast<const __m256i*>(keys + row));
+		__m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lowKeys, key),
+									  _mm256_cmpgt_epi32(key, highKeys));
+		outside = _mm256_sub_epi32(outside, out);
+
+		if (++steps == SCAN_FLUSH_STEPS || row + 16 > count)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), outside);
+			for (int lane = 0; lane < 8; ++lane)
+			{
+				outsideTotal += lanes[lane];
+			}
+			outside = _mm256_setzero_si256();
+			steps = 0;
+		}
+	}
+
+	long long selected = (long long)row - outsideTotal;
+	for (; row < count; ++row)
+	{
+		selected += (keys[row] >= low && keys[row] <= high);
+	}
+
+	return selected;
+}
+
+
+
+// ==== ScanCountSse2 =========================================================
+//
+// Counts the rows outside the range four per step, the way ScanCountAvx2
+// does.
+//
+// Input:
+//		keys, count, low, high	[IN] - as for ScanCount
+//
+// Output:
+//		long long  -  the number of rows selected
+//
+// ============================================================================
+static long long ScanCountSse2(const int keys[], size_t count, int low,
+							   int high)
+{
+	const __m128i lowKeys = _mm_set1_epi32(low);
+	const __m128i highKeys = _mm_set1_epi32(high);
+
+	long long outsideTotal = 0;
+	__m128i outside = _mm_setzero_si128();
+	unsigned int steps = 0;
+	int lanes[4];
+
+	size_t row = 0;
+	for (; row + 4 <= count; row += 4)
+	{
+		__m128i key = _mm_loadu_si128(
+								reinterpret_cast<const __m128i*>(keys + row));
+		__m128i out = _mm_or_si128(_mm_cmpgt_epi32(lowKeys, key),
+								   _mm_cmpgt_epi32(key, highKeys));
+		outside = _mm_sub_epi32(outside, out);
+
+		if (++steps == SCAN_FLUSH_STEPS || row + 8 > count)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), outside);
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				outsideTotal += lanes[lane];
+			}
+			outside = _mm_setzero_si128();
+			steps = 0;
+		}
+	}
+
+	long long selected = (long long)row - outsideTotal;
+	for (; row < count; ++row)
+	{
+		selected += (keys[row] >= low && keys[row] <= high);
+	}
+
+	return selected;
+}
+
+// ==== ScanHasAvx2 ===========================================================
+//
+// Checks once whether the CPU runs AVX2.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if it does
+//
+// ============================================================================
+static bool ScanHasAvx2()
+{
+	static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+	return hasAvx2;
+}
+
+#endif  // SCAN_X86
+
+
+
+// ==== ScanAggregate =========================================================
+//
+// Aggregates the values of the rows whose key lies in [low, high] with the
+// widest kernel the CPU runs.
+//
+// Input:
+//		keys	[IN] - the key of every row
+//		values	[IN] - the value of every row
+//		count	[IN] - the number of rows
+//		low		[IN] - the smallest key to select
+//		high	[IN] - the largest key to select
+//
+// Output:
+//		CColumnAggregate  -  the aggregates of the selected rows
+//
+// ============================================================================
+CColumnAggregate ScanAggregate(const int keys[], const double values[],
+							   size_t count, int low, int high)
+{
+#ifdef SCAN_X86
+	if (ScanHasAvx2())
+	{
+		return ScanAggregateAvx2(keys, values, count, low, high);
+	}
+	return ScanAggregateSse2(keys, values, count, low, high);
+#else
+	CColumnAggregate result = { 0, 0, HUGE_VAL, -HUGE_VAL };
+	ScanAggregateTail(keys, values, 0, count, low, high, result);
+	return result;
+#endif
+}
+
+
+
+// ==== ScanCount =============================================================
+//
+// Counts the rows whose key lies in [low, high] with the widest kernel the
+// CPU runs.
+//
+// Input:
+//		keys	[IN] - the key of every row
+//		count	[IN] - the number of rows
+//		low		[IN] - the smallest key to count
+//		high	[IN] - the largest key to count
+//
+// Output:
+//		long long  -  the number of rows selected
+//
+// ============================================================================
+long long ScanCount(const int keys[], size_t count, int low, int high)
+{
+#ifdef SCAN_X86
+	if (ScanHasAvx2())
+	{
+		return ScanCountAvx2(keys, count, low, high);
+	}
+	return ScanCountSse2(keys, count, low, high);
+#else
+	long long selected = 0;
+	for (size_t row = 0; row < count; ++row)
+	{
+		selected += (keys[row] >= low && keys[row] <= high);
+	}
+	return selected;
+#endif
+}
+
+
+
+// ==== ScanInstructionSet ====================================================
+//
+// Names the instruction set the scans use on this CPU.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const char*  -  "avx2", "sse2" or "scalar"
+//
+// ============================================================================
+const char* ScanInstructionSet()
+{
+#ifdef SCAN_X86
+	return ScanHasAvx2() ? "avx2" : "sse2";
+#else
+	return "scalar";
+#endif
+}
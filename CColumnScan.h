@@ -0,0 +1,52 @@
+// ============================================================================
+// File: CColumnScan.h
+// ============================================================================
+// Header file for the column scan kernels.  A scan filters the rows of a
+// column of int keys by a key range and aggregates a parallel column of
+// doubles over the rows that pass, without branching on any row.  The
+// kernels run eight rows per step with AVX2 where the CPU has it, two per
+// step with SSE2 on other x86 CPUs, and one at a time elsewhere; the choice
+// is made once, on the first scan.
+//
+// Sums are added in a different order than a loop over the rows would add
+// them, so they may differ from such a loop in the last bits.
+// ============================================================================
+
+#ifndef CCOLUMNSCAN_HEADER
+#define CCOLUMNSCAN_HEADER
+
+#include <cstddef>
+
+/** The aggregates of the rows a scan selected. */
+struct CColumnAggregate
+{
+   long long   m_count;       // Rows selected
+   double      m_sum;         // Sum of their values, 0 if none
+   double      m_min;         // Smallest value, +infinity if none
+   double      m_max;         // Largest value, -infinity if none
+};
+
+/** Aggregates the values of the rows whose key lies in [low, high].
+    @param keys: The key of every row.
+    @param values: The value of every row.
+    @param count: The number of rows.
+    @param low: The smallest key to select.
+    @param high: The largest key to select.
+    @return  The count, sum, minimum and maximum of the selected values. */
+CColumnAggregate ScanAggregate(const int keys[], const double values[],
+                               size_t count, int low, int high);
+
+/** Counts the rows whose key lies in [low, high].
+    @param keys: The key of every row.
+    @param count: The number of rows.
+    @param low: The smallest key to count.
+    @param high: The largest key to count.
+    @return  The number of rows selected. */
+long long ScanCount(const int keys[], size_t count, int low, int high);
+
+/** Names the instruction set the scans use on this CPU.
+    @param Nothing.
+    @return  "avx2", "sse2" or "scalar". */
+const char* ScanInstructionSet();
+
+#endif  // CCOLUMNSCAN_HEADER
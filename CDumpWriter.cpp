@@ -0,0 +1,330 @@
+// ============================================================================
+// File: CDumpWriter.cpp
+// ============================================================================
+// Implimentation file for the class CDumpWriter
+// ============================================================================
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+using namespace std;
+#include "CDumpWriter.h"
+
+
+
+// ==== File Descriptor Constructor ===========================================
+//
+// Creates a writer that writes to a file descriptor.
+//
+// Input:
+//		fd			[IN] - an open file descriptor
+//		bufferSize	[IN] - the bytes to buffer between writes
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CDumpWriter::CDumpWriter(int fd, size_t bufferSize)
+	: m_buffer(new char[max(bufferSize, DUMP_NUMBER_SIZE)]),
+	  m_bufferSize(max(bufferSize, DUMP_NUMBER_SIZE)), m_used(0), m_fd(fd),
+	  m_outs(nullptr), m_good(true), m_bytesWritten(0)
+{
+
+}
+
+
+
+// ==== Stream Constructor ====================================================
+//
+// Creates a writer that writes to a stream.
+//
+// Input:
+//		outs		[IN] - an output stream
+//		bufferSize	[IN] - the bytes to buffer between writes
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CDumpWriter::CDumpWriter(ostream &outs, size_t bufferSize)
+	: m_buffer(new char[max(bufferSize, DUMP_NUMBER_SIZE)]),
+	  m_bufferSize(max(bufferSize, DUMP_NUMBER_SIZE)), m_used(0), m_fd(-1),
+	  m_outs(&outs), m_good(true), m_bytesWritten(0)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Writes out whatever is still buffered.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CDumpWriter::~CDumpWriter()
+{
+	Flush();
+}
+
+
+
+// ==== Append ================================================================
+//
+// Appends text.  Text larger than the buffer is written out directly.
+//
+// Input:
+//		text	[IN] - the text to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::Append(string_view text)
+{
+	if (text.size() > m_bufferSize - m_used)
+	{
+		WriteOut(m_buffer.get(), m_used);
+		m_used = 0;
+		if (text.size() > m_bufferSize)
+		{
+			WriteOut(text.data(), text.size());
+			return;
+		}
+	}
+
+	memcpy(m_buffer.get() + m_used, text.data(), text.size());
+	m_used += text.size();
+}
+
+
+
+// ==== Append ================================================================
+//
+// Appends one character.
+//
+// Input:
+//		ch	[IN] - the character to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::Append(char ch)
+{
+	Reserve(1);
+
+	m_buffer[m_used++] = ch;
+}
+
+
+
+// ==== AppendNumber ==========================================================
+//
+// Appends a floating point number with a fixed number of significant
+// digits, in the form printf's %g uses.
+//
+// Input:
+//		value		[IN] - the number to append
+//		precision	[IN] - the number of significant digits
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::AppendNumber(double value, int precision)
+{
+	Reserve(DUMP_NUMBER_SIZE);
+
+	char *first = m_buffer.get() + m_used;
+	to_chars_result result = to_chars(first, first + DUMP_NUMBER_SIZE, value,
+									  chars_format::general, precision);
+	if (result.ec != errc())
+	{
+		//only a huge precision overflows; fall back to the shortest form
+		result = to_chars(first, first + DUMP_NUMBER_SIZE, value);
+	}
+	m_used += result.ptr - first;
+}
+
+
+
+// ==== AppendCsvField ========================================================
+//
+// Appends text as one CSV field.  A field holding a comma, a quote or a
+// line break is put in quotes, with each quote inside it doubled.
+//
+// Input:
+//		text	[IN] - the text of the field
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::AppendCsvField(string_view text)
+{
+	if (text.find_first_of(",\"\r\n") == string_view::npos)
+	{
+		Append(text);
+		return;
+	}
+
+	Append('"');
+	size_t start = 0;
+	size_t quote;
+	while ((quote = text.find('"', start)) != string_view::npos)
+	{
+		Append(text.substr(start, quote + 1 - start));
+		Append('"');
+		start = quote + 1;
+	}
+	Append(text.substr(start));
+	Append('"');
+}
+
+
+
+// ==== Flush =================================================================
+//
+// Writes out whatever is buffered.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if every write so far has succeeded
+//
+// ============================================================================
+bool CDumpWriter::Flush()
+{
+	if (m_used > 0)
+	{
+		WriteOut(m_buffer.get(), m_used);
+		m_used = 0;
+	}
+	if (m_outs != nullptr && m_good)
+	{
+		m_outs->flush();
+		m_good = m_outs->good();
+	}
+
+	return m_good;
+}
+
+
+
+// ==== IsGood ================================================================
+//
+// Reports whether every write so far has succeeded.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if no write has failed
+//
+// ============================================================================
+bool CDumpWriter::IsGood() const
+{
+	return m_good;
+}
+
+
+
+// ==== GetBytesWritten =======================================================
+//
+// Returns the number of bytes written out so far.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		unsigned long long  -  the number of bytes
+//
+// ============================================================================
+unsigned long long CDumpWriter::GetBytesWritten() const
+{
+	return m_bytesWritten;
+}
+
+
+
+// ==== Reserve ===============================================================
+//
+// Makes room in the buffer, writing it out if fewer than size bytes are
+// free.
+//
+// Input:
+//		size	[IN] - the bytes needed
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::Reserve(size_t size)
+{
+	if (m_bufferSize - m_used < size)
+	{
+		WriteOut(m_buffer.get(), m_used);
+		m_used = 0;
+	}
+}
+
+
+
+// ==== WriteOut ==============================================================
+//
+// Writes a block of bytes to the file descriptor or stream.  Once a write
+// has failed nothing more is written, so the output ends where it failed.
+//
+// Input:
+//		data	[IN] - the first byte
+//		size	[IN] - the number of bytes
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CDumpWriter::WriteOut(const char *data, size_t size)
+{
+	if (!m_good)
+	{
+		return;
+	}
+
+	if (m_outs != nullptr)
+	{
+		m_outs->write(data, size);
+		if (!m_outs->good())
+		{
+			m_good = false;
+			return;
+		}
+		m_bytesWritten += size;
+		return;
+	}
+
+	while (size > 0)
+	{
+		ssize_t written = write(m_fd, data, size);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			m_good = false;
+			return;
+		}
+		data += written;
+		size -= (size_t)written;
+		m_bytesWritten += (size_t)written;
+	}
+}
@@ -0,0 +1,182 @@
+// ============================================================================
+// File: CDumpWriter.h
+// ============================================================================
+// Header file for the class CDumpWriter, the output path of the bulk dumps
+// (CBST::Dump).  A CDumpWriter formats text into one buffer it allocates
+// when it is made, numbers included (with std::to_chars), and hands the
+// buffer to a file descriptor or a stream only when it is full, so a dump
+// of a whole tree costs a few large writes instead of a flush per record.
+//
+// A class that wants to be dumped provides its own DumpWrite overload next
+// to its stream operators (see CPersonInfo.h).
+// ============================================================================
+
+#ifndef CDUMPWRITER_HEADER
+#define CDUMPWRITER_HEADER
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+// =========================================================================
+//      Dump constants
+// =========================================================================
+
+// The layouts a dump can be written in
+enum CDumpFormat
+{
+   DUMP_TEXT,                 // The layout of operator<<, a line per field
+   DUMP_CSV                   // A comma separated line per item
+};
+
+// Bytes a CDumpWriter buffers before it writes
+const size_t         DUMP_BUFFER_SIZE = 1 << 20;
+
+// Room enough for any number AppendNumber writes
+const size_t         DUMP_NUMBER_SIZE = 64;
+
+// Significant digits of a double in a DUMP_TEXT dump, the default
+// precision of a stream
+const int            DUMP_TEXT_PRECISION = 6;
+
+class CDumpWriter
+{
+public:
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates a writer that writes to a file descriptor, which it does not
+       close.
+    @param fd: An open file descriptor.
+    @param bufferSize: The bytes to buffer between writes. */
+   explicit CDumpWriter(int fd, size_t bufferSize = DUMP_BUFFER_SIZE);
+
+   /** Creates a writer that writes to a stream.
+    @param outs: An output stream.
+    @param bufferSize: The bytes to buffer between writes. */
+   explicit CDumpWriter(std::ostream &outs,
+                        size_t bufferSize = DUMP_BUFFER_SIZE);
+
+   /** Writes out whatever is still buffered. */
+   ~CDumpWriter();
+
+   CDumpWriter(const CDumpWriter &other) = delete;
+   CDumpWriter& operator=(const CDumpWriter &rhs) = delete;
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Appends text.
+    @param text: The text to append.
+    @return  Nothing. */
+   void Append(std::string_view text);
+
+   /** Appends one character.
+    @param ch: The character to append.
+    @return  Nothing. */
+   void Append(char ch);
+
+   /** Appends a number.  Floating point numbers are written in the shortest
+       form that reads back as the same number.
+    @param value: The number to append.
+    @return  Nothing. */
+   template<class NumberType>
+   typename std::enable_if<std::is_arithmetic<NumberType>::value>::type
+   AppendNumber(NumberType value);
+
+   /** Appends a floating point number with precision significant digits,
+       as printf's %g does; operator<< writes doubles this way with a
+       precision of 6.
+    @param value: The number to append.
+    @param precision: The number of significant digits.
+    @return  Nothing. */
+   void AppendNumber(double value, int precision);
+
+   /** Appends text as one CSV field, quoted if it holds a comma, a quote
+       or a line break.
+    @param text: The text of the field.
+    @return  Nothing. */
+   void AppendCsvField(std::string_view text);
+
+   /** Writes out whatever is buffered.
+    @param Nothing.
+    @return  True if every write so far has succeeded. */
+   bool Flush();
+
+   /** Reports whether every write so far has succeeded.
+    @param Nothing.
+    @return  True if no write has failed. */
+   bool IsGood() const;
+
+   /** Returns the number of bytes written out so far, not counting what
+       is still buffered.
+    @param Nothing.
+    @return  The number of bytes. */
+   unsigned long long GetBytesWritten() const;
+
+private:
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Makes room in the buffer, writing it out if fewer than size bytes are
+       free.
+    @param size: The bytes needed; at most the size of the buffer.
+    @return  Nothing. */
+   void Reserve(size_t size);
+
+   /** Writes a block of bytes to the file descriptor or stream.
+    @param data: The first byte.
+    @param size: The number of bytes.
+    @return  Nothing. */
+   void WriteOut(const char *data, size_t size);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   std::unique_ptr<char[]>    m_buffer;
+   size_t                     m_bufferSize;
+   size_t                     m_used;           // Bytes buffered
+   int                        m_fd;             // -1 when writing to m_outs
+   std::ostream               *m_outs;
+   bool                       m_good;
+   unsigned long long         m_bytesWritten;
+}; // end CDumpWriter
+
+// =========================================================================
+//      Dump functions
+// =========================================================================
+
+/** Appends a number to a dump as a line of its own.
+    @param writer: The writer to append to.
+    @param value: The number to append.
+    @param format: The layout of the dump.
+    @return  Nothing. */
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value>::type
+DumpWrite(CDumpWriter &writer, const ItemType &value, CDumpFormat format);
+
+/** Passes every item it is given to DumpWrite, so that ExportColumns can
+    dump a tree in order. */
+struct CDumpColumns
+{
+   void Clear() {}
+
+   template<class ItemType>
+   void Append(const ItemType &item)
+   {
+      DumpWrite(m_writer, item, m_format);
+   }
+
+   CDumpWriter    &m_writer;
+   CDumpFormat    m_format;
+};
+
+#include "CDumpWriter.tpp"
+
+#endif  // CDUMPWRITER_HEADER
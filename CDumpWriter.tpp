@@ -0,0 +1,59 @@
+// ============================================================================
+// File: CDumpWriter.tpp
+// ============================================================================
+// This is the implementation file for the templated members of CDumpWriter
+// and the templated dump functions
+// ============================================================================
+
+#include <charconv>
+#include "CDumpWriter.h"
+
+
+
+// ==== AppendNumber ==========================================================
+//
+// Appends a number, converting it straight into the buffer.
+//
+// Input:
+//		value	[IN] - the number to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class NumberType>
+typename std::enable_if<std::is_arithmetic<NumberType>::value>::type
+CDumpWriter::AppendNumber(NumberType value)
+{
+	Reserve(DUMP_NUMBER_SIZE);
+
+	char *first = m_buffer.get() + m_used;
+	std::to_chars_result result = std::to_chars(first,
+												first + DUMP_NUMBER_SIZE,
+												value);
+	m_used += result.ptr - first;
+}
+
+
+
+// ==== DumpWrite =============================================================
+//
+// Appends a number to a dump as a line of its own; both layouts are the
+// same for a single number.
+//
+// Input:
+//		writer	[IN/OUT] - the writer to append to
+//		value	[IN] - the number to append
+//		format	[IN] - the layout of the dump
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value>::type
+DumpWrite(CDumpWriter &writer, const ItemType &value, CDumpFormat format)
+{
+	writer.AppendNumber(value);
+	writer.Append('\n');
+}
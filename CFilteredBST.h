@@ -0,0 +1,150 @@
+// ============================================================================
+// File: CFilteredBST.h
+// ============================================================================
+// Header file for the class CFilteredBST (CBST with a Bloom filter that
+// answers most lookups of missing keys without searching the tree)
+// ============================================================================
+
+#ifndef CFILTEREDBST_HEADER
+#define CFILTEREDBST_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "CBST.h"
+
+// Default rate of lookups of missing keys that still search the tree
+const double BST_FILTER_FP_RATE = 0.01;
+// Words in one block of the filter (512 bits, one cache line)
+const int BST_FILTER_BLOCK_WORDS = 8;
+
+template<class ItemType>
+class CFilteredBST : public CBST<ItemType>
+{
+public:
+   typedef typename CBST<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree.
+    @param falsePositiveRate: The fraction of lookups of missing keys that
+                              the filter lets through to the tree.  Smaller
+                              rates cost more memory: about 1.9 * log2(1 /
+                              rate) bits per key. */
+   CFilteredBST(double falsePositiveRate = BST_FILTER_FP_RATE);
+
+   /** Copy constructor. */
+   CFilteredBST(const CFilteredBST<ItemType> &tree);
+
+   /** Destructor. */
+   virtual ~CFilteredBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Adds an item and sets the bits of its key in the filter.
+    @param newEntry: The item to add.
+    @return  True. */
+   bool Add(const ItemType &newEntry) override;
+
+   /** Removes an item.  A Bloom filter cannot clear a key, so the filter is
+       rebuilt once half of the keys it holds have been removed, whether by
+       Remove, RemoveBatch, Difference, PopMin or PopMax.
+    @param anEntry: The item to remove.
+    @return  True if the item was removed, or false if it was not found. */
+   bool Remove(const ItemType &anEntry) override;
+
+   /** Finds an item.  The filter is checked first and the tree is searched
+       only if the key may be present.  Contains, GetEntry and TryGetEntry
+       all go through it.
+    @param anEntry: The item to look for.
+    @return  A pointer to the item in the tree, or nullptr if it is not
+             found. */
+   const ItemType* FindOrNull(const ItemType &anEntry) const
+                                                   noexcept override;
+
+   /** Returns the memory the filter uses.
+    @param Nothing.
+    @return  The size of the filter in bytes. */
+   size_t GetFilterBytes() const;
+
+   /** Overloaded assignment operator.
+    @param rhs: A const CFilteredBST reference object.
+    @return  CFilteredBST reference object. */
+   CFilteredBST<ItemType>& operator=(const CFilteredBST<ItemType> &rhs);
+
+protected:
+   // =========================================================================
+   //      Protected Member Functions
+   // =========================================================================
+
+   /** Rebuilds the filter from the items, unless Add or Remove is updating
+       it themselves.
+    @return  nothing */
+   void OnContentsChanged() override;
+
+   /** Leaves the bits of removed keys set and counts them as stale, the
+       way Remove does.
+    @param count: The number of items removed.
+    @return  nothing */
+   void OnItemsRemoved(int count) override;
+
+   /** ORs the filter of other into this one when both have the same shape
+       and there is room, and rebuilds the filter otherwise.
+    @param other: The tree the items came from.
+    @return  nothing */
+   void OnTreeMerged(const CBST<ItemType> &other) override;
+
+private:
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Sizes the filter for the items in the tree, with room to grow, and
+       sets the bits of every key.
+    @return  nothing */
+   void Rebuild();
+
+   /** Recursive helper for Rebuild.
+    @param treePtr: The root of the subtree.
+    @return  nothing */
+   void RebuildHelper(const CBinaryNode<ItemType> *treePtr);
+
+   /** Sets the bits of a key.
+    @param key: The key to insert.
+    @return  nothing */
+   void Insert(const KeyType &key);
+
+   /** Checks the bits of a key.
+    @param key: The key to check.
+    @return  False if the key is certainly not in the tree. */
+   bool MayContain(const KeyType &key) const;
+
+   /** Hashes a key to 64 well-mixed bits.
+    @param key: The key to hash.
+    @return  The hash. */
+   static uint64_t Hash(const KeyType &key);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   // The filter is split into 512-bit blocks (one cache line each); a key
+   // sets all of its bits in one block, so a lookup reads one line.
+   std::vector<uint64_t>   m_words;
+   size_t                  m_blocks;      // m_words.size() / 8
+   int                     m_bitsPerKey;
+   int                     m_hashCount;   // Bits set per key
+   int                     m_capacity;    // Keys the filter was sized for
+   int                     m_keys;        // Keys set since the last rebuild
+   int                     m_removed;     // Keys removed since then
+   bool                    m_updating;    // Add or Remove is running
+}; // end CFilteredBST
+
+#include "CFilteredBST.tpp"
+
+#endif  // CFILTEREDBST_HEADER
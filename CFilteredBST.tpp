@@ -0,0 +1,477 @@
+// ============================================================================
+// File: CFilteredBST.tpp
+// ============================================================================
+// This is the implementation file for the class CFilteredBST.  The filter
+// is a blocked Bloom filter over the keys of the items: each key hashes to
+// one 512-bit block and sets m_hashCount bits inside it.  A lookup whose
+// key finds any of its bits clear cannot be in the tree and returns after
+// reading one cache line, instead of descending the full height of the
+// tree.  Confining a key to one block costs accuracy, so the filter uses
+// 30% more bits per key than a classic Bloom filter with the same rate.
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include "CFilteredBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree and a filter sized for the given false positive
+// rate.
+//
+// Input:
+//		falsePositiveRate	[IN] - the fraction of missing keys let through
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CFilteredBST<ItemType>::CFilteredBST(double falsePositiveRate) :
+												m_blocks(0), m_capacity(0),
+												m_keys(0), m_removed(0),
+												m_updating(false)
+{
+	const double ln2 = std::log(2.0);
+	double rate = std::min(std::max(falsePositiveRate, 1e-9), 0.5);
+	double bits = -std::log(rate) / (ln2 * ln2);
+
+	m_hashCount = std::min(16, std::max(1, (int)std::lround(bits * ln2)));
+	m_bitsPerKey = (int)std::ceil(bits * 1.3);
+	Rebuild();
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the items of the tree and its filter.
+//
+// Input:
+//		tree	[IN] - a const CFilteredBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CFilteredBST<ItemType>::CFilteredBST(const CFilteredBST<ItemType> &tree) :
+											CBST<ItemType>(tree),
+											m_words(tree.m_words),
+											m_blocks(tree.m_blocks),
+											m_bitsPerKey(tree.m_bitsPerKey),
+											m_hashCount(tree.m_hashCount),
+											m_capacity(tree.m_capacity),
+											m_keys(tree.m_keys),
+											m_removed(tree.m_removed),
+											m_updating(false)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST releases.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CFilteredBST<ItemType>::~CFilteredBST()
+{
+
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Adds an item and sets the bits of its key.  The filter is resized once it
+// holds more keys than it was sized for.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True
+//
+// ============================================================================
+template<class ItemType>
+bool CFilteredBST<ItemType>::Add(const ItemType &newEntry)
+{
+	bool success;
+	m_updating = true;
+	try
+	{
+		success = CBST<ItemType>::Add(newEntry);
+	}
+	catch (...)
+	{
+		//the tree may have changed before the throw, so the filter is
+		//rebuilt from it rather than trusted
+		m_updating = false;
+		Rebuild();
+		throw;
+	}
+	m_updating = false;
+
+	if (++m_keys > m_capacity)
+	{
+		Rebuild();
+	}
+	else
+	{
+		Insert(CKeyTraits<ItemType>::GetKey(newEntry));
+	}
+
+	return success;
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Removes an item.  Its bits stay set, so the filter is rebuilt once half
+// of its keys are gone.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if the item was removed, false if it was not found
+//
+// ============================================================================
+template<class ItemType>
+bool CFilteredBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	bool success;
+	m_updating = true;
+	try
+	{
+		success = CBST<ItemType>::Remove(anEntry);
+	}
+	catch (...)
+	{
+		//the tree may have changed before the throw, so the filter is
+		//rebuilt from it rather than trusted
+		m_updating = false;
+		Rebuild();
+		throw;
+	}
+	m_updating = false;
+
+	if (success && 2 * ++m_removed > m_keys)
+	{
+		Rebuild();
+	}
+
+	return success;
+}
+
+
+
+// ==== FindOrNull ============================================================
+//
+// Finds an item, checking the filter first.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		const ItemType*  -  the item in the tree, or nullptr if not found
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CFilteredBST<ItemType>::FindOrNull(const ItemType &anEntry)
+															const noexcept
+{
+	if (!MayContain(CKeyTraits<ItemType>::GetKey(anEntry)))
+	{
+		return nullptr;
+	}
+
+	return CBST<ItemType>::FindOrNull(anEntry);
+}
+
+
+
+// ==== GetFilterBytes ========================================================
+//
+// Returns the memory the filter uses.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		size_t  -  the size of the filter in bytes
+//
+// ============================================================================
+template<class ItemType>
+size_t CFilteredBST<ItemType>::GetFilterBytes() const
+{
+	return m_words.size() * sizeof(uint64_t);
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the items of rhs and its false positive rate.  CBST::operator=
+// calls OnContentsChanged, which rebuilds the filter.
+//
+// Input:
+//		rhs	[IN] - A const CFilteredBST reference object.
+//
+// Output:
+//		CFilteredBST - a CFilteredBST reference object
+//
+// ============================================================================
+template<class ItemType>
+CFilteredBST<ItemType>& CFilteredBST<ItemType>::operator=(
+										const CFilteredBST<ItemType> &rhs)
+{
+	m_bitsPerKey = rhs.m_bitsPerKey;
+	m_hashCount = rhs.m_hashCount;
+	CBST<ItemType>::operator=(rhs);
+
+	return *this;
+}
+
+
+
+// ==== OnContentsChanged =====================================================
+//
+// Rebuilds the filter after changes that bring in keys it has not seen
+// (bulk builds, AddBatch, the halves of a Split, Load and assignment) and
+// after Clear.  Add, Remove, removals and merges update it themselves.  The
+// rebuild is O(n), the same order as the CBST rebuild that caused it.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::OnContentsChanged()
+{
+	if (!m_updating)
+	{
+		Rebuild();
+	}
+}
+
+
+
+// ==== OnItemsRemoved ========================================================
+//
+// Counts removed keys as stale, leaving their bits set, and rebuilds the
+// filter once half of its keys are gone, the same rule Remove follows.
+//
+// Input:
+//		count	[IN] - the number of items removed
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::OnItemsRemoved(int count)
+{
+	m_removed += count;
+	if (2 * m_removed > m_keys)
+	{
+		Rebuild();
+	}
+}
+
+
+
+// ==== OnTreeMerged ==========================================================
+//
+// Sets the bits of the keys Join or Union moved in.  If other is a
+// CFilteredBST whose filter has the same number of blocks and hashes, a key
+// sets the same bits in both, so its words are ORed in; the keys other
+// counted are added to this filter's counts.  Otherwise, or if this filter
+// would overflow, it is rebuilt.
+//
+// Input:
+//		other	[IN] - the tree the items came from
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::OnTreeMerged(const CBST<ItemType> &other)
+{
+	const CFilteredBST<ItemType> *filteredPtr;
+	filteredPtr = dynamic_cast<const CFilteredBST<ItemType>*>(&other);
+
+	if (filteredPtr == nullptr || filteredPtr->m_blocks != m_blocks ||
+		filteredPtr->m_hashCount != m_hashCount ||
+		m_keys + filteredPtr->m_keys > m_capacity)
+	{
+		Rebuild();
+		return;
+	}
+
+	for (size_t index = 0; index < m_words.size(); ++index)
+	{
+		m_words[index] |= filteredPtr->m_words[index];
+	}
+	m_keys += filteredPtr->m_keys;
+	m_removed += filteredPtr->m_removed;
+}
+
+
+
+// ==== Rebuild ===============================================================
+//
+// Sizes the filter for a quarter more keys than the tree holds (at least
+// 1024) so it can grow before the next rebuild, then sets the bits of
+// every key.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::Rebuild()
+{
+	m_keys = this->GetNumberOfNodes();
+	m_removed = 0;
+	m_capacity = std::max(1024, m_keys + m_keys / 4);
+
+	size_t bits = (size_t)m_capacity * m_bitsPerKey;
+	m_blocks = (bits + 511) / 512;
+	m_words.assign(m_blocks * BST_FILTER_BLOCK_WORDS, 0);
+
+	RebuildHelper(this->GetRootPtr());
+}
+
+
+
+// ==== RebuildHelper =========================================================
+//
+// Sets the bits of every key in a subtree.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::RebuildHelper(const CBinaryNode<ItemType>
+																*treePtr)
+{
+	while (treePtr != nullptr)
+	{
+		Insert(CKeyTraits<ItemType>::GetKey(treePtr->GetItemRef()));
+		RebuildHelper(treePtr->GetLeftChildPtr());
+		treePtr = treePtr->GetRightChildPtr();
+	}
+}
+
+
+
+// ==== Insert ================================================================
+//
+// Sets the bits of a key.  The high half of the hash picks the block; the
+// bits inside it are h1 + i * h2 for two 32-bit halves of a remixed hash.
+//
+// Input:
+//		key	[IN] - the key to insert
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFilteredBST<ItemType>::Insert(const KeyType &key)
+{
+	uint64_t hash = Hash(key);
+	uint64_t *block = &m_words[((hash >> 32) * m_blocks >> 32) *
+							   BST_FILTER_BLOCK_WORDS];
+	uint32_t h1 = (uint32_t)hash;
+	uint32_t h2 = (uint32_t)((hash * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+
+	for (int index = 0; index < m_hashCount; ++index)
+	{
+		uint32_t bit = (h1 + index * h2) & 511;
+		block[bit >> 6] |= (uint64_t)1 << (bit & 63);
+	}
+}
+
+
+
+// ==== MayContain ============================================================
+//
+// Checks the bits of a key, the same way Insert sets them.
+//
+// Input:
+//		key	[IN] - the key to check
+//
+// Output:
+//		bool  -  False if the key is certainly not in the tree
+//
+// ============================================================================
+template<class ItemType>
+bool CFilteredBST<ItemType>::MayContain(const KeyType &key) const
+{
+	uint64_t hash = Hash(key);
+	const uint64_t *block = &m_words[((hash >> 32) * m_blocks >> 32) *
+									 BST_FILTER_BLOCK_WORDS];
+	uint32_t h1 = (uint32_t)hash;
+	uint32_t h2 = (uint32_t)((hash * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+
+	for (int index = 0; index < m_hashCount; ++index)
+	{
+		uint32_t bit = (h1 + index * h2) & 511;
+		if ((block[bit >> 6] & ((uint64_t)1 << (bit & 63))) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+// ==== Hash ==================================================================
+//
+// Hashes a key with std::hash and mixes the result (the splitmix64
+// finalizer), since std::hash of an integer is often the integer itself.
+//
+// Input:
+//		key	[IN] - the key to hash
+//
+// Output:
+//		uint64_t  -  the hash
+//
+// ============================================================================
+template<class ItemType>
+uint64_t CFilteredBST<ItemType>::Hash(const KeyType &key)
+{
+	uint64_t hash = std::hash<KeyType>()(key);
+
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+
+	return hash ^ (hash >> 31);
+}
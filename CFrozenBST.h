@@ -0,0 +1,141 @@
+// ============================================================================
+// File: CFrozenBST.h
+// ============================================================================
+// Header file for the class CFrozenBST (read-only, memory-mapped CBST)
+// ============================================================================
+
+#ifndef CFROZENBST_HEADER
+#define CFROZENBST_HEADER
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include "CBST.h"
+#include "CKeyTraits.h"
+#include "NotFoundException.h"
+
+template<class ItemType>
+class CFrozenBST
+{
+public:
+   /** The part of an item that the tree is ordered by (see CKeyTraits). */
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates a frozen tree that has no file mapped. */
+   CFrozenBST();
+
+   /** Destructor.  Unmaps the file if one is mapped. */
+   ~CFrozenBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Writes the contents of a tree to a frozen file.  The keys are stored
+       in Eytzinger (breadth-first) order so a search walks the array from
+       the front, and every link is an offset, never a pointer.
+    @param tree: The tree to freeze.
+    @param path: The file to write.  It is replaced atomically.
+    @return  True if the file was written, or false if it could not be. */
+   static bool Write(const CBST<ItemType> &tree, const std::string &path);
+
+   /** Maps a frozen file read-only.  Nothing is copied or decoded, so the
+       tree can be queried right away and every process that maps the same
+       file shares one copy of it in the page cache.
+    @param path: The file to map.
+    @return  True if the file was mapped, or false if it could not be opened
+             or is not a valid frozen file. */
+   bool Open(const std::string &path);
+
+   /** Unmaps the file.
+    @param Nothing.
+    @return  Nothing. */
+   void Close();
+
+   /** Checks if the tree holds no items (or no file is mapped).
+    @param Nothing.
+    @return  True if it is empty, or false if it is not. */
+   bool IsEmpty() const;
+
+   /** Returns the number of items in the mapped file.
+    @param Nothing.
+    @return  An int value representing the number of items. */
+   int GetNumberOfNodes() const;
+
+   /** Checks if an item exists in the tree.
+    @param anEntry: An ItemType that will be used to check if it exists.
+    @return  True if found, or false if it is not. */
+   bool Contains(const ItemType &anEntry) const;
+
+   /** Retrieves an entry from the tree.
+    @param anEntry: An ItemType that will be used to retrieve an item.
+    @return  Returns the stored ItemType equal to anEntry.
+    @throw   NotFoundException if the entry does not exists. */
+   ItemType GetEntry(const ItemType &anEntry) const;
+
+   /** Retrieves an entry from the tree without throwing.  Items are decoded
+       from the file, so the entry is returned by value.
+    @param anEntry: An ItemType that will be used to retrieve an item.
+    @return  The stored ItemType equal to anEntry, or std::nullopt if the
+             entry does not exist. */
+   std::optional<ItemType> TryGetEntry(const ItemType &anEntry) const;
+
+   /** Visits, in order, the items whose key lies in the closed range
+       [low, high].
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that is a void return type and takes an argument
+                  of ItemType.
+    @return  Nothing. */
+   void RangeTraverse(const KeyType &low, const KeyType &high,
+                      void Visit(ItemType &item)) const;
+
+private:
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Finds the sorted position of the first item whose key is not less
+       than key.
+    @param key: The key to search for.
+    @return  The sorted position, or the number of items if every key is
+             less than key. */
+   size_t LowerBound(const KeyType &key) const;
+
+   /** Decodes the item at a sorted position.
+    @param rank: The sorted position of the item.
+    @param item: Receives the item.
+    @return  True if the item was decoded, or false if the record is bad. */
+   bool ReadItem(size_t rank, ItemType &item) const;
+
+   /** Finds the sorted position of an item equal to anEntry.
+    @param anEntry: The item to search for.
+    @param item: Receives the stored item when found.
+    @return  True if found, or false if it is not. */
+   bool Find(const ItemType &anEntry, ItemType &item) const;
+
+   /** Copying would map the file twice; disallow it. */
+   CFrozenBST(const CFrozenBST<ItemType> &tree);
+   CFrozenBST<ItemType>& operator=(const CFrozenBST<ItemType> &rhs);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   const char                 *m_base;          // Start of the mapping
+   size_t                      m_size;          // Size of the mapping
+   size_t                      m_count;         // Number of items
+   const KeyType              *m_keys;          // Keys, Eytzinger order
+   const unsigned long long   *m_ranks;         // Sorted position per slot
+   const unsigned long long   *m_recordOffsets; // Record start, sorted order
+   const char                 *m_records;       // Encoded items, sorted order
+   size_t                      m_recordsSize;   // Bytes of encoded items
+}; // end CFrozenBST
+
+#include "CFrozenBST.tpp"
+
+#endif  // CFROZENBST_HEADER
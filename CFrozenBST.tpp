@@ -0,0 +1,633 @@
+// ============================================================================
+// File: CFrozenBST.tpp
+// ============================================================================
+// This is the implementation file for the class CFrozenBST which impliments
+// a read-only tree that is queried in place from a memory-mapped file.  The
+// file layout (all sections 8-byte aligned) is:
+//
+//		header	magic "CBSTFRZN" | version (u32) | key size (u32) |
+//				count (u64) | keys offset | ranks offset |
+//				record offsets offset | records offset | records size
+//		keys	count + 1 keys in Eytzinger order (slot 0 unused)
+//		ranks	count + 1 sorted positions, one per Eytzinger slot
+//		offsets	count + 1 record start offsets in sorted order
+//		records	every item encoded with SnapshotWrite, in sorted order
+//
+// A search only touches the keys array; records are decoded when an item is
+// actually returned.
+// ============================================================================
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "CFrozenBST.h"
+
+// first 8 bytes of every frozen file
+const char           FROZEN_MAGIC[] = "CBSTFRZN";
+const size_t         FROZEN_MAGIC_SIZE = 8;
+const unsigned int   FROZEN_VERSION = 1;
+const size_t         FROZEN_HEADER_SIZE = 64;
+
+
+
+// ==== FrozenAlign ===========================================================
+//
+// Pads a buffer with zeros up to the next multiple of 8 bytes.
+//
+// Input:
+//		buffer	[IN/OUT] - the buffer to pad
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+inline void FrozenAlign(std::string &buffer)
+{
+	while (buffer.size() % 8 != 0)
+	{
+		buffer.push_back('\0');
+	}
+}
+
+
+
+// ==== FrozenCheckTables =====================================================
+//
+// Checks the rank and record offset tables of a mapped file, so a corrupt or
+// truncated file cannot make a query read outside the mapping: every rank
+// must name an item, and the record offsets must never decrease or run past
+// the records section.
+//
+// Input:
+//		ranks			[IN] - count + 1 sorted positions (slot 0 unused)
+//		recordOffsets	[IN] - count + 1 record start offsets
+//		count			[IN] - the number of items
+//		recordsSize		[IN] - bytes of encoded items
+//
+// Output:
+//		bool  -  True if both tables are consistent with count
+//
+// ============================================================================
+inline bool FrozenCheckTables(const unsigned long long *ranks,
+							  const unsigned long long *recordOffsets,
+							  size_t count, unsigned long long recordsSize)
+{
+	for (size_t slot = 1; slot <= count; ++slot)
+	{
+		if (ranks[slot] >= count)
+		{
+			return false;
+		}
+	}
+
+	for (size_t rank = 0; rank < count; ++rank)
+	{
+		if (recordOffsets[rank] > recordOffsets[rank + 1])
+		{
+			return false;
+		}
+	}
+
+	return recordOffsets[count] <= recordsSize;
+}
+
+
+
+// ==== FrozenFillEytzinger ===================================================
+//
+// Recursively places sorted keys into Eytzinger order by walking the
+// implicit tree (children of slot k are 2k and 2k + 1) in order.
+//
+// Input:
+//		items	[IN] - the items in sorted order
+//		keys	[OUT] - the Eytzinger key array
+//		ranks	[OUT] - the sorted position of each Eytzinger slot
+//		next	[IN/OUT] - the next sorted position to place
+//		slot	[IN] - the current Eytzinger slot
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void FrozenFillEytzinger(const std::vector<ItemType> &items,
+				std::vector<typename CKeyTraits<ItemType>::KeyType> &keys,
+				std::vector<unsigned long long> &ranks, size_t &next,
+				size_t slot)
+{
+	if (slot >= keys.size())
+	{
+		return;
+	}
+
+	FrozenFillEytzinger(items, keys, ranks, next, 2 * slot);
+
+	keys[slot] = CKeyTraits<ItemType>::GetKey(items[next]);
+	ranks[slot] = next;
+	++next;
+
+	FrozenFillEytzinger(items, keys, ranks, next, 2 * slot + 1);
+}
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates a frozen tree that has no file mapped.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CFrozenBST<ItemType>::CFrozenBST() : m_base(nullptr), m_size(0), m_count(0),
+				m_keys(nullptr), m_ranks(nullptr), m_recordOffsets(nullptr),
+				m_records(nullptr), m_recordsSize(0)
+{
+	static_assert(std::is_trivially_copyable<KeyType>::value,
+				  "CFrozenBST keys must be trivially copyable");
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Unmaps the file if one is mapped.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CFrozenBST<ItemType>::~CFrozenBST()
+{
+	Close();
+}
+
+
+
+// ==== Write =================================================================
+//
+// Writes the contents of a tree to a frozen file.
+//
+// Input:
+//		tree	[IN] - the tree to freeze
+//		path	[IN] - the file to write; it is replaced atomically
+//
+// Output:
+//		bool  -  True if the file was written, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::Write(const CBST<ItemType> &tree,
+								 const std::string &path)
+{
+	std::vector<ItemType> items;
+	tree.GetSortedItems(items);
+	size_t count = items.size();
+
+	//lay the keys out in Eytzinger order
+	std::vector<KeyType> keys(count + 1);
+	std::vector<unsigned long long> ranks(count + 1, 0);
+	size_t next = 0;
+	FrozenFillEytzinger(items, keys, ranks, next, 1);
+
+	//encode the records in sorted order
+	std::string records;
+	std::vector<unsigned long long> recordOffsets(count + 1);
+	for (size_t index = 0; index < count; ++index)
+	{
+		recordOffsets[index] = records.size();
+		SnapshotWrite(records, items[index]);
+	}
+	recordOffsets[count] = records.size();
+
+	//work out where each section starts
+	unsigned long long slots = count + 1;
+	unsigned long long keysOffset = FROZEN_HEADER_SIZE;
+	unsigned long long ranksOffset = keysOffset + slots * sizeof(KeyType);
+	ranksOffset = (ranksOffset + 7) / 8 * 8;
+	unsigned long long offsetsOffset = ranksOffset + slots * 8;
+	unsigned long long recordsOffset = offsetsOffset + slots * 8;
+
+	std::string buffer;
+	buffer.reserve((size_t)recordsOffset + records.size());
+	buffer.append(FROZEN_MAGIC, FROZEN_MAGIC_SIZE);
+	SnapshotWrite(buffer, FROZEN_VERSION);
+	SnapshotWrite(buffer, (unsigned int)sizeof(KeyType));
+	SnapshotWrite(buffer, (unsigned long long)count);
+	SnapshotWrite(buffer, keysOffset);
+	SnapshotWrite(buffer, ranksOffset);
+	SnapshotWrite(buffer, offsetsOffset);
+	SnapshotWrite(buffer, recordsOffset);
+	SnapshotWrite(buffer, (unsigned long long)records.size());
+
+	buffer.append(reinterpret_cast<const char*>(&keys[0]),
+				  keys.size() * sizeof(KeyType));
+	FrozenAlign(buffer);
+	buffer.append(reinterpret_cast<const char*>(&ranks[0]),
+				  ranks.size() * sizeof(unsigned long long));
+	buffer.append(reinterpret_cast<const char*>(&recordOffsets[0]),
+				  recordOffsets.size() * sizeof(unsigned long long));
+	buffer.append(records);
+
+	return SnapshotWriteFile(path, buffer);
+}
+
+
+
+// ==== Open ==================================================================
+//
+// Maps a frozen file read-only and checks that its sections are aligned and
+// fit in it, and that its rank and record offset tables are consistent.  The
+// tables are read once here so queries never have to bounds check them.
+//
+// Input:
+//		path	[IN] - the file to map
+//
+// Output:
+//		bool  -  True if the file was mapped, false if it could not be opened
+//				 or is not a valid frozen file
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::Open(const std::string &path)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat fileInfo;
+	if (fstat(fd, &fileInfo) != 0 ||
+		(size_t)fileInfo.st_size < FROZEN_HEADER_SIZE)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t size = (size_t)fileInfo.st_size;
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		return false;
+	}
+
+	const char *base = static_cast<const char*>(mapping);
+	const char *pos = base + FROZEN_MAGIC_SIZE;
+	const char *end = base + FROZEN_HEADER_SIZE;
+	unsigned int version;
+	unsigned int keySize;
+	unsigned long long count;
+	unsigned long long keysOffset;
+	unsigned long long ranksOffset;
+	unsigned long long offsetsOffset;
+	unsigned long long recordsOffset;
+	unsigned long long recordsSize;
+
+	bool valid = memcmp(base, FROZEN_MAGIC, FROZEN_MAGIC_SIZE) == 0 &&
+				 SnapshotRead(pos, end, version) &&
+				 SnapshotRead(pos, end, keySize) &&
+				 SnapshotRead(pos, end, count) &&
+				 SnapshotRead(pos, end, keysOffset) &&
+				 SnapshotRead(pos, end, ranksOffset) &&
+				 SnapshotRead(pos, end, offsetsOffset) &&
+				 SnapshotRead(pos, end, recordsOffset) &&
+				 SnapshotRead(pos, end, recordsSize);
+
+	//every offset is checked against size first, so no sum below overflows
+	valid = valid && version == FROZEN_VERSION &&
+			keySize == sizeof(KeyType) && count < size &&
+			keysOffset >= FROZEN_HEADER_SIZE && keysOffset <= size &&
+			ranksOffset <= size && offsetsOffset <= size &&
+			recordsOffset <= size && recordsSize <= size &&
+			keysOffset % alignof(KeyType) == 0 && ranksOffset % 8 == 0 &&
+			offsetsOffset % 8 == 0 &&
+			keysOffset + (count + 1) * sizeof(KeyType) <= ranksOffset &&
+			ranksOffset + (count + 1) * 8 <= offsetsOffset &&
+			offsetsOffset + (count + 1) * 8 <= recordsOffset &&
+			recordsOffset + recordsSize <= size;
+
+	valid = valid && FrozenCheckTables(
+		reinterpret_cast<const unsigned long long*>(base + ranksOffset),
+		reinterpret_cast<const unsigned long long*>(base + offsetsOffset),
+		(size_t)count, recordsSize);
+
+	if (!valid)
+	{
+		munmap(mapping, size);
+		return false;
+	}
+
+	m_base = base;
+	m_size = size;
+	m_count = (size_t)count;
+	m_keys = reinterpret_cast<const KeyType*>(base + keysOffset);
+	m_ranks = reinterpret_cast<const unsigned long long*>(base + ranksOffset);
+	m_recordOffsets = reinterpret_cast<const unsigned long long*>(
+														base + offsetsOffset);
+	m_records = base + recordsOffset;
+	m_recordsSize = (size_t)recordsSize;
+
+	return true;
+}
+
+
+
+// ==== Close =================================================================
+//
+// Unmaps the file.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFrozenBST<ItemType>::Close()
+{
+	if (m_base != nullptr)
+	{
+		munmap(const_cast<char*>(m_base), m_size);
+	}
+
+	m_base = nullptr;
+	m_size = 0;
+	m_count = 0;
+	m_keys = nullptr;
+	m_ranks = nullptr;
+	m_recordOffsets = nullptr;
+	m_records = nullptr;
+	m_recordsSize = 0;
+}
+
+
+
+// ==== IsEmpty ===============================================================
+//
+// Checks if the tree holds no items (or no file is mapped).
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if it is empty, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::IsEmpty() const
+{
+	return m_count == 0;
+}
+
+
+
+// ==== GetNumberOfNodes ======================================================
+//
+// Returns the number of items in the mapped file.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of items
+//
+// ============================================================================
+template<class ItemType>
+int CFrozenBST<ItemType>::GetNumberOfNodes() const
+{
+	return (int)m_count;
+}
+
+
+
+// ==== Contains ==============================================================
+//
+// Checks if an item exists in the tree.
+//
+// Input:
+//		anEntry	[IN] - An ItemType that will be used to check if it exists
+//
+// Output:
+//		bool  -  True if found, false if not found.
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::Contains(const ItemType &anEntry) const
+{
+	ItemType item;
+
+	return Find(anEntry, item);
+}
+
+
+
+// ==== GetEntry ==============================================================
+//
+// Retrieves an entry from the tree.
+//
+// Input:
+//		anEntry	[IN] - An ItemType that will be used to retrieve an item
+//
+// Output:
+//		ItemType  -  the stored item equal to anEntry
+//
+//		NotFoundException  -  thrown if the entry does not exist
+//
+// ============================================================================
+template<class ItemType>
+ItemType CFrozenBST<ItemType>::GetEntry(const ItemType &anEntry) const
+{
+	ItemType item;
+
+	if (!Find(anEntry, item))
+	{
+		NotFoundException exception("Entry does not exhist");
+		throw exception;
+	}
+
+	return item;
+}
+
+
+
+// ==== TryGetEntry ===========================================================
+//
+// Retrieves an entry from the tree without throwing.
+//
+// Input:
+//		anEntry	[IN] - An ItemType that will be used to retrieve an item
+//
+// Output:
+//		std::optional<ItemType>  -  the stored item equal to anEntry, or
+//									std::nullopt if it does not exist
+//
+// ============================================================================
+template<class ItemType>
+std::optional<ItemType> CFrozenBST<ItemType>::TryGetEntry(
+											const ItemType &anEntry) const
+{
+	ItemType item;
+
+	if (!Find(anEntry, item))
+	{
+		return std::nullopt;
+	}
+
+	return item;
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// Visits, in order, the items whose key lies in the closed range
+// [low, high].  Records are stored in sorted order, so after one search the
+// range is a sequential scan.
+//
+// Input:
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that is a void return type and takes an
+//                  argument of ItemType.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CFrozenBST<ItemType>::RangeTraverse(const KeyType &low,
+							const KeyType &high,
+							void Visit(ItemType &item)) const
+{
+	ItemType item;
+
+	for (size_t rank = LowerBound(low); rank < m_count; ++rank)
+	{
+		if (!ReadItem(rank, item) ||
+			high < CKeyTraits<ItemType>::GetKey(item))
+		{
+			return;
+		}
+		Visit(item);
+	}
+}
+
+
+
+// ==== LowerBound ============================================================
+//
+// Finds the sorted position of the first item whose key is not less than
+// key.  The loop is branch free: each step moves to child 2k or 2k + 1, and
+// the trailing right turns are undone at the end to recover the answer.
+//
+// Input:
+//		key	[IN] - the key to search for
+//
+// Output:
+//		size_t  -  the sorted position, or m_count if every key is less
+//
+// ============================================================================
+template<class ItemType>
+size_t CFrozenBST<ItemType>::LowerBound(const KeyType &key) const
+{
+	size_t slot = 1;
+
+	while (slot <= m_count)
+	{
+		//the keys four levels down share a cache line; fetch them early
+		__builtin_prefetch(m_keys + 16 * slot);
+		slot = 2 * slot + (m_keys[slot] < key ? 1 : 0);
+	}
+
+	//strip the right turns taken after the last left turn
+	slot = slot >> (__builtin_ctzll(~(unsigned long long)slot) + 1);
+
+	if (slot == 0)
+	{
+		return m_count;
+	}
+
+	return (size_t)m_ranks[slot];
+}
+
+
+
+// ==== ReadItem ==============================================================
+//
+// Decodes the item at a sorted position.
+//
+// Input:
+//		rank	[IN] - the sorted position of the item
+//		item	[OUT] - receives the item
+//
+// Output:
+//		bool  -  True if the item was decoded, false if the record is bad
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::ReadItem(size_t rank, ItemType &item) const
+{
+	unsigned long long start = m_recordOffsets[rank];
+	unsigned long long stop = m_recordOffsets[rank + 1];
+
+	if (start > stop || stop > m_recordsSize)
+	{
+		return false;
+	}
+
+	const char *pos = m_records + start;
+
+	return SnapshotRead(pos, m_records + stop, item);
+}
+
+
+
+// ==== Find ==================================================================
+//
+// Finds an item equal to anEntry.  Items with the same key are stored next
+// to each other, so they are compared in turn after one search.
+//
+// Input:
+//		anEntry	[IN] - the item to search for
+//		item	[OUT] - receives the stored item when found
+//
+// Output:
+//		bool  -  True if found, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CFrozenBST<ItemType>::Find(const ItemType &anEntry, ItemType &item) const
+{
+	KeyType key = CKeyTraits<ItemType>::GetKey(anEntry);
+
+	for (size_t rank = LowerBound(key); rank < m_count; ++rank)
+	{
+		if (!ReadItem(rank, item) || key < CKeyTraits<ItemType>::GetKey(item))
+		{
+			return false;
+		}
+		if (item == anEntry)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
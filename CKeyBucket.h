@@ -0,0 +1,135 @@
+// ============================================================================
+// File: CKeyBucket.h
+// ============================================================================
+// Header file for the class CKeyBucket.  A bucket holds every item that
+// shares one key, so a tree of buckets (see CMultiBST) has one node per
+// distinct key no matter how many items repeat it.  Buckets are ordered by
+// their key alone.
+// ============================================================================
+
+#ifndef CKEYBUCKET_HEADER
+#define CKEYBUCKET_HEADER
+
+#include <string>
+#include <vector>
+#include "CKeyTraits.h"
+#include "CSnapshotIO.h"
+#include "CTreeStats.h"
+
+template<class ItemType>
+struct CKeyBucket
+{
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   /** Creates an empty bucket; its key is left default constructed. */
+   CKeyBucket() : m_key()
+   {
+   }
+
+   /** Creates a bucket holding one item. */
+   CKeyBucket(const ItemType &item)
+      : m_key(CKeyTraits<ItemType>::GetKey(item)), m_items(1, item)
+   {
+   }
+
+   bool operator==(const CKeyBucket<ItemType> &rhs) const
+   {
+      return !(m_key < rhs.m_key) && !(rhs.m_key < m_key);
+   }
+
+   bool operator<(const CKeyBucket<ItemType> &rhs) const
+   {
+      return m_key < rhs.m_key;
+   }
+
+   bool operator>(const CKeyBucket<ItemType> &rhs) const
+   {
+      return rhs.m_key < m_key;
+   }
+
+   KeyType                 m_key;      // The key every item shares
+   std::vector<ItemType>   m_items;    // In the order they were added
+}; // end CKeyBucket
+
+/** A bucket's key is the key of its items. */
+template<class ItemType>
+struct CKeyTraits< CKeyBucket<ItemType> >
+{
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   static KeyType GetKey(const CKeyBucket<ItemType> &bucket)
+   {
+      return bucket.m_key;
+   }
+}; // end CKeyTraits
+
+// =========================================================================
+//      Snapshot encoding
+// =========================================================================
+
+/** Appends a bucket to a snapshot buffer: the number of items followed by
+    the items.  The key is not stored since it is the key of every item.
+    @param buffer: The buffer to append to.
+    @param bucket: The bucket to encode.
+    @return  Nothing. */
+template<class ItemType>
+void SnapshotWrite(std::string &buffer, const CKeyBucket<ItemType> &bucket)
+{
+   SnapshotWrite(buffer, (unsigned int)bucket.m_items.size());
+   for (size_t index = 0; index < bucket.m_items.size(); ++index)
+   {
+      SnapshotWrite(buffer, bucket.m_items[index]);
+   }
+}
+
+/** Decodes a bucket written by SnapshotWrite.  An empty bucket is rejected.
+    @param pos: The read position; advanced past the bucket on success.
+    @param end: The end of the buffer.
+    @param bucket: Receives the bucket.
+    @return  True if a bucket was decoded, or false if the buffer is short
+             or the bucket is empty. */
+template<class ItemType>
+bool SnapshotRead(const char *&pos, const char *end,
+                  CKeyBucket<ItemType> &bucket)
+{
+   unsigned int count;
+   if (!SnapshotRead(pos, end, count) || count == 0 ||
+       count > (unsigned int)(end - pos))
+   {
+      return false;
+   }
+
+   bucket.m_items.resize(count);
+   for (size_t index = 0; index < bucket.m_items.size(); ++index)
+   {
+      if (!SnapshotRead(pos, end, bucket.m_items[index]))
+      {
+         return false;
+      }
+   }
+   bucket.m_key = CKeyTraits<ItemType>::GetKey(bucket.m_items[0]);
+
+   return true;
+}
+
+// =========================================================================
+//      Memory accounting
+// =========================================================================
+
+/** Returns the heap memory a bucket owns: its array of items and whatever
+    its key and items own in turn.
+    @param bucket: The bucket.
+    @return  The number of bytes. */
+template<class ItemType>
+size_t HeapBytes(const CKeyBucket<ItemType> &bucket)
+{
+   size_t bytes = HeapBytes(bucket.m_key) +
+                  bucket.m_items.capacity() * sizeof(ItemType);
+   for (size_t index = 0; index < bucket.m_items.size(); ++index)
+   {
+      bytes += HeapBytes(bucket.m_items[index]);
+   }
+   return bytes;
+}
+
+#endif  // CKEYBUCKET_HEADER
@@ -0,0 +1,64 @@
+// ============================================================================
+// File: CKeyHandle.h
+// ============================================================================
+// Header file for the class CKeyHandle.  A handle holds the key of an item
+// and the number of the item's record in a separate record store (see
+// CSplitBST), so a tree of handles compares keys without reading records.
+// Handles are ordered by their key alone; two handles are == only if they
+// also name the same record.
+// ============================================================================
+
+#ifndef CKEYHANDLE_HEADER
+#define CKEYHANDLE_HEADER
+
+#include "CKeyTraits.h"
+
+template<class ItemType>
+struct CKeyHandle
+{
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   /** Creates a handle to record 0; its key is left default constructed. */
+   CKeyHandle() : m_key(), m_record(0)
+   {
+   }
+
+   /** Creates a handle to a record holding item. */
+   CKeyHandle(const ItemType &item, unsigned int record)
+      : m_key(CKeyTraits<ItemType>::GetKey(item)), m_record(record)
+   {
+   }
+
+   bool operator==(const CKeyHandle<ItemType> &rhs) const
+   {
+      return m_record == rhs.m_record && !(m_key < rhs.m_key) &&
+             !(rhs.m_key < m_key);
+   }
+
+   bool operator<(const CKeyHandle<ItemType> &rhs) const
+   {
+      return m_key < rhs.m_key;
+   }
+
+   bool operator>(const CKeyHandle<ItemType> &rhs) const
+   {
+      return rhs.m_key < m_key;
+   }
+
+   KeyType        m_key;      // The key of the record
+   unsigned int   m_record;   // Its number in the record store
+}; // end CKeyHandle
+
+/** A handle's key is the key of its record. */
+template<class ItemType>
+struct CKeyTraits< CKeyHandle<ItemType> >
+{
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   static KeyType GetKey(const CKeyHandle<ItemType> &handle)
+   {
+      return handle.m_key;
+   }
+}; // end CKeyTraits
+
+#endif  // CKEYHANDLE_HEADER
@@ -0,0 +1,31 @@
+// ============================================================================
+// File: CKeyTraits.h
+// ============================================================================
+// Header file for the class CKeyTraits.  CBST orders items with operator<
+// and operator>, which for most item types only look at part of the item
+// (CPersonInfo, for example, is ordered by age alone).  CKeyTraits names
+// that part so it can be searched for, stored and compared on its own.
+//
+// The default treats the whole item as its key.  A class ordered by one of
+// its members specializes CKeyTraits next to its declaration.
+// ============================================================================
+
+#ifndef CKEYTRAITS_HEADER
+#define CKEYTRAITS_HEADER
+
+template<class ItemType>
+struct CKeyTraits
+{
+   /** The type of the part of the item that the tree is ordered by. */
+   typedef ItemType KeyType;
+
+   /** Extracts the key of an item.
+    @param item: The item to extract the key from.
+    @return  The key of the item. */
+   static KeyType GetKey(const ItemType &item)
+   {
+      return item;
+   }
+}; // end CKeyTraits
+
+#endif  // CKEYTRAITS_HEADER
@@ -0,0 +1,161 @@
+// ============================================================================
+// File: CMultiBST.h
+// ============================================================================
+// Header file for the class CMultiBST (CBST that keeps duplicate keys)
+// ============================================================================
+
+#ifndef CMULTIBST_HEADER
+#define CMULTIBST_HEADER
+
+#include <vector>
+#include "CBST.h"
+#include "CKeyBucket.h"
+
+template<class ItemType>
+class CMultiBST : public CBST< CKeyBucket<ItemType> >
+{
+public:
+   typedef CKeyBucket<ItemType> BucketType;
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   using CBST<BucketType>::InorderTraverse;
+   using CBST<BucketType>::RangeTraverse;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree. */
+   CMultiBST();
+
+   /** Copy constructor. */
+   CMultiBST(const CMultiBST<ItemType> &tree);
+
+   /** Destructor. */
+   virtual ~CMultiBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Adds an item.  An item whose key is already in the tree joins that
+       key's bucket in O(log n) without changing the shape of the tree; only
+       a new key goes through CBST::Add and its rebuild.
+    @param newEntry: The item to add.
+    @return  True. */
+   bool Add(const ItemType &newEntry);
+
+   /** Removes one item that is == anEntry.  The key's node is removed only
+       when its last item goes.
+    @param anEntry: The item to remove.
+    @return  True if an item was removed, or false if none matched. */
+   bool Remove(const ItemType &anEntry);
+
+   /** Checks if an item that is == anEntry is in the tree.  It takes an
+       item rather than a bucket, so it overloads the interface's Contains
+       instead of overriding it; like that one, it never throws.
+    @param anEntry: The item to look for.
+    @return  True if found, or false if it is not. */
+   bool Contains(const ItemType &anEntry) const noexcept;
+
+   /** Counts the items with a key, in O(log n).
+    @param key: The key to count.
+    @return  The number of items with the key. */
+   int Count(const KeyType &key) const;
+
+   /** Copies the items with a key, in the order they were added, in
+       O(log n + k).
+    @param key: The key to look up.
+    @param items: Receives the items (replacing its contents).
+    @return  The number of items with the key. */
+   int EqualRange(const KeyType &key, std::vector<ItemType> &items) const;
+
+   /** Removes every item with a key, in one CBST::Remove of its node.
+    @param key: The key to remove.
+    @return  The number of items removed. */
+   int RemoveAll(const KeyType &key);
+
+   /** Counts every item in the tree (GetNumberOfNodes counts distinct keys).
+    @param Nothing.
+    @return  The number of items. */
+   int GetNumberOfItems() const;
+
+   /** Visits every item in key order; items sharing a key are visited in the
+       order they were added.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void InorderTraverse(void Visit(ItemType &item)) const;
+
+   /** Visits, in key order, every item whose key lies in [low, high].
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void RangeTraverse(const KeyType &low, const KeyType &high,
+                      void Visit(ItemType &item)) const;
+
+   /** Replaces the tree with the contents of a snapshot written by Save,
+       after checking that it holds one non-empty bucket per key and that
+       every item sits in the bucket of its own key.
+    @param path: The file to read.
+    @return  True if the snapshot was loaded, or false if the file could not
+             be read or failed validation (the tree is then unchanged). */
+   bool Load(const std::string &path);
+
+   /** Overloaded assignment operator.
+    @param rhs: A const CMultiBST reference object.
+    @return  CMultiBST reference object. */
+   CMultiBST<ItemType>& operator=(const CMultiBST<ItemType> &rhs);
+
+private:
+   // Adding a bucket, or joining, uniting, splitting into or bulk building
+   // bucket trees, can leave two buckets with the same key, which the
+   // lookups here cannot handle, and ParallelForEach hands out buckets that
+   // Visit could empty.  Difference only removes keys and stays available.
+   // The bucket Remove and Contains go with Add, as the item versions
+   // above take their place.
+   using CBST<BucketType>::Add;
+   using CBST<BucketType>::Remove;
+   using CBST<BucketType>::Contains;
+   using CBST<BucketType>::AddBatch;
+   using CBST<BucketType>::BuildFromSortedArray;
+   using CBST<BucketType>::Join;
+   using CBST<BucketType>::Union;
+   using CBST<BucketType>::Split;
+   using CBST<BucketType>::ParallelForEach;
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Finds the node holding a key's bucket.
+    @param key: The key to find.
+    @return  The node, or nullptr if the key is not in the tree. */
+   CBinaryNode<BucketType>* FindBucket(const KeyType &key) const;
+
+   /** Recursive helper for the item traversals.
+    @param treePtr: The root of the subtree.
+    @param low: The smallest key to visit, or nullptr for no bound.
+    @param high: The largest key to visit, or nullptr for no bound.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void ItemHelper(CBinaryNode<BucketType> *treePtr, const KeyType *low,
+                   const KeyType *high, void Visit(ItemType &item)) const;
+
+   /** Checks, in order, that the keys of a subtree are strictly increasing
+       and that every bucket is non-empty and holds only items of its key.
+    @param treePtr: The root of the subtree.
+    @param previous: The key visited last, or nullptr; updated.
+    @return  True if the subtree keeps those rules. */
+   bool CheckBuckets(const CBinaryNode<BucketType> *treePtr,
+                     const KeyType *&previous) const;
+
+   /** Recursive helper for GetNumberOfItems.
+    @param treePtr: The root of the subtree.
+    @return  The number of items in the subtree. */
+   int CountItemsHelper(const CBinaryNode<BucketType> *treePtr) const;
+}; // end CMultiBST
+
+#include "CMultiBST.tpp"
+
+#endif  // CMULTIBST_HEADER
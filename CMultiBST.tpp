@@ -0,0 +1,543 @@
+// ============================================================================
+// File: CMultiBST.tpp
+// ============================================================================
+// This is the implementation file for the class CMultiBST.  The tree holds
+// one CKeyBucket per distinct key, so equal keys never form chains and never
+// end up split between the two subtrees of a node after a rebuild.
+// ============================================================================
+
+#include "CMultiBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CMultiBST<ItemType>::CMultiBST()
+{
+
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the buckets of the tree.
+//
+// Input:
+//		tree	[IN] - a const CMultiBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CMultiBST<ItemType>::CMultiBST(const CMultiBST<ItemType> &tree) :
+											CBST<BucketType>(tree)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST releases.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CMultiBST<ItemType>::~CMultiBST()
+{
+
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Adds an item to its key's bucket, or adds a new bucket for a new key.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiBST<ItemType>::Add(const ItemType &newEntry)
+{
+	CBinaryNode<BucketType> *nodePtr;
+	nodePtr = FindBucket(CKeyTraits<ItemType>::GetKey(newEntry));
+
+	if (nodePtr == nullptr)
+	{
+		return CBST<BucketType>::Add(BucketType(newEntry));
+	}
+
+	nodePtr->GetItemRef().m_items.push_back(newEntry);
+	this->OnContentsChanged();
+
+	return true;
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Removes one item that is == anEntry from its key's bucket, and the bucket
+// itself once it is empty.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if an item was removed, false if none matched
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	CBinaryNode<BucketType> *nodePtr;
+	nodePtr = FindBucket(CKeyTraits<ItemType>::GetKey(anEntry));
+
+	if (nodePtr == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<ItemType> &items = nodePtr->GetItemRef().m_items;
+	for (size_t index = 0; index < items.size(); ++index)
+	{
+		if (items[index] == anEntry)
+		{
+			if (items.size() == 1)
+			{
+				return CBST<BucketType>::Remove(nodePtr->GetItem());
+			}
+
+			items.erase(items.begin() + index);
+			this->OnContentsChanged();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+// ==== Contains ==============================================================
+//
+// Checks if an item that is == anEntry is in the tree.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		bool  -  True if found, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiBST<ItemType>::Contains(const ItemType &anEntry) const noexcept
+{
+	CBinaryNode<BucketType> *nodePtr;
+	nodePtr = FindBucket(CKeyTraits<ItemType>::GetKey(anEntry));
+
+	if (nodePtr == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<ItemType> &items = nodePtr->GetItemRef().m_items;
+	for (size_t index = 0; index < items.size(); ++index)
+	{
+		if (items[index] == anEntry)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+// ==== Count =================================================================
+//
+// Counts the items with a key.
+//
+// Input:
+//		key	[IN] - the key to count
+//
+// Output:
+//		int  -  the number of items with the key
+//
+// ============================================================================
+template<class ItemType>
+int CMultiBST<ItemType>::Count(const KeyType &key) const
+{
+	CBinaryNode<BucketType> *nodePtr = FindBucket(key);
+
+	return (nodePtr == nullptr) ? 0 : (int)nodePtr->GetItemRef().m_items.size();
+}
+
+
+
+// ==== EqualRange ============================================================
+//
+// Copies the items with a key, in the order they were added.
+//
+// Input:
+//		key		[IN] - the key to look up
+//		items	[OUT] - receives the items
+//
+// Output:
+//		int  -  the number of items with the key
+//
+// ============================================================================
+template<class ItemType>
+int CMultiBST<ItemType>::EqualRange(const KeyType &key,
+									std::vector<ItemType> &items) const
+{
+	CBinaryNode<BucketType> *nodePtr = FindBucket(key);
+
+	if (nodePtr == nullptr)
+	{
+		items.clear();
+		return 0;
+	}
+
+	items = nodePtr->GetItemRef().m_items;
+
+	return (int)items.size();
+}
+
+
+
+// ==== RemoveAll =============================================================
+//
+// Removes every item with a key by removing its bucket.
+//
+// Input:
+//		key	[IN] - the key to remove
+//
+// Output:
+//		int  -  the number of items removed
+//
+// ============================================================================
+template<class ItemType>
+int CMultiBST<ItemType>::RemoveAll(const KeyType &key)
+{
+	CBinaryNode<BucketType> *nodePtr = FindBucket(key);
+
+	if (nodePtr == nullptr)
+	{
+		return 0;
+	}
+
+	int count = (int)nodePtr->GetItemRef().m_items.size();
+	CBST<BucketType>::Remove(nodePtr->GetItem());
+
+	return count;
+}
+
+
+
+// ==== GetNumberOfItems ======================================================
+//
+// Counts every item in the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of items
+//
+// ============================================================================
+template<class ItemType>
+int CMultiBST<ItemType>::GetNumberOfItems() const
+{
+	return CountItemsHelper(this->GetRootPtr());
+}
+
+
+
+// ==== InorderTraverse =======================================================
+//
+// Visits every item in key order.
+//
+// Input:
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiBST<ItemType>::InorderTraverse(void Visit(ItemType &item)) const
+{
+	ItemHelper(this->GetRootPtr(), nullptr, nullptr, Visit);
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// Visits, in key order, every item whose key lies in [low, high].
+//
+// Input:
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiBST<ItemType>::RangeTraverse(const KeyType &low,
+										const KeyType &high,
+										void Visit(ItemType &item)) const
+{
+	ItemHelper(this->GetRootPtr(), &low, &high, Visit);
+}
+
+
+
+// ==== Load ==================================================================
+//
+// Replaces the tree with the contents of a snapshot.  The snapshot is loaded
+// into a separate tree and checked there, so a file that breaks the one
+// bucket per key rule leaves this tree as it was; a good one is moved in
+// with Join, which relinks its nodes instead of copying them.
+//
+// Input:
+//		path	[IN] - the file to read
+//
+// Output:
+//		bool  -  True if the snapshot was loaded, false if the file could not
+//				 be read or failed validation
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiBST<ItemType>::Load(const std::string &path)
+{
+	CMultiBST<ItemType> loaded;
+	const KeyType *previous = nullptr;
+
+	if (!loaded.CBST<BucketType>::Load(path) ||
+		!loaded.CheckBuckets(loaded.GetRootPtr(), previous))
+	{
+		return false;
+	}
+
+	this->Clear();
+	CBST<BucketType>::Join(loaded);
+
+	return true;
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the buckets of rhs.
+//
+// Input:
+//		rhs	[IN] - A const CMultiBST reference object.
+//
+// Output:
+//		CMultiBST - a CMultiBST reference object
+//
+// ============================================================================
+template<class ItemType>
+CMultiBST<ItemType>& CMultiBST<ItemType>::operator=(
+											const CMultiBST<ItemType> &rhs)
+{
+	CBST<BucketType>::operator=(rhs);
+
+	return *this;
+}
+
+
+
+// ==== FindBucket ============================================================
+//
+// Finds the node holding a key's bucket by comparing keys only, so no
+// bucket is copied on the way down.
+//
+// Input:
+//		key	[IN] - the key to find
+//
+// Output:
+//		CBinaryNode  -  the node, or nullptr if the key is not in the tree
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<CKeyBucket<ItemType> >* CMultiBST<ItemType>::FindBucket(
+												const KeyType &key) const
+{
+	CBinaryNode<BucketType> *nodePtr = this->GetRootPtr();
+
+	while (nodePtr != nullptr)
+	{
+		const KeyType &nodeKey = nodePtr->GetItemRef().m_key;
+		if (key < nodeKey)
+		{
+			nodePtr = nodePtr->GetLeftChildPtr();
+		}
+		else if (nodeKey < key)
+		{
+			nodePtr = nodePtr->GetRightChildPtr();
+		}
+		else
+		{
+			return nodePtr;
+		}
+	}
+
+	return nullptr;
+}
+
+
+
+// ==== ItemHelper ============================================================
+//
+// Recursive helper for the item traversals.  Subtrees that cannot hold a
+// key in range are skipped.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//		low		[IN] - the smallest key to visit, or nullptr
+//		high	[IN] - the largest key to visit, or nullptr
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiBST<ItemType>::ItemHelper(CBinaryNode<BucketType> *treePtr,
+									 const KeyType *low, const KeyType *high,
+									 void Visit(ItemType &item)) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	const KeyType &key = treePtr->GetItemRef().m_key;
+	bool aboveLow = (low == nullptr) || !(key < *low);
+	bool belowHigh = (high == nullptr) || !(*high < key);
+
+	if (aboveLow)
+	{
+		ItemHelper(treePtr->GetLeftChildPtr(), low, high, Visit);
+	}
+
+	if (aboveLow && belowHigh)
+	{
+		std::vector<ItemType> &items = treePtr->GetItemRef().m_items;
+		for (size_t index = 0; index < items.size(); ++index)
+		{
+			ItemType itemContents = items[index];
+			Visit(itemContents);
+		}
+	}
+
+	if (belowHigh)
+	{
+		ItemHelper(treePtr->GetRightChildPtr(), low, high, Visit);
+	}
+}
+
+
+
+// ==== CheckBuckets ==========================================================
+//
+// Walks a subtree in order, checking that its keys are strictly increasing
+// and that every bucket is non-empty and holds only items of its key.
+//
+// Input:
+//		treePtr		[IN] - the root of the subtree
+//		previous	[IN/OUT] - the key visited last, or nullptr
+//
+// Output:
+//		bool  -  True if the subtree keeps those rules
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiBST<ItemType>::CheckBuckets(const CBinaryNode<BucketType> *treePtr,
+									   const KeyType *&previous) const
+{
+	if (treePtr == nullptr)
+	{
+		return true;
+	}
+
+	if (!CheckBuckets(treePtr->GetLeftChildPtr(), previous))
+	{
+		return false;
+	}
+
+	const BucketType &bucket = treePtr->GetItemRef();
+	if (bucket.m_items.empty() ||
+		(previous != nullptr && !(*previous < bucket.m_key)))
+	{
+		return false;
+	}
+	for (size_t index = 0; index < bucket.m_items.size(); ++index)
+	{
+		const KeyType key = CKeyTraits<ItemType>::GetKey(bucket.m_items[index]);
+		if (key < bucket.m_key || bucket.m_key < key)
+		{
+			return false;
+		}
+	}
+	previous = &bucket.m_key;
+
+	return CheckBuckets(treePtr->GetRightChildPtr(), previous);
+}
+
+
+
+// ==== CountItemsHelper ======================================================
+//
+// Recursive helper for GetNumberOfItems.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//
+// Output:
+//		int  -  the number of items in the subtree
+//
+// ============================================================================
+template<class ItemType>
+int CMultiBST<ItemType>::CountItemsHelper(
+								const CBinaryNode<BucketType> *treePtr) const
+{
+	if (treePtr == nullptr)
+	{
+		return 0;
+	}
+
+	return (int)treePtr->GetItemRef().m_items.size() +
+		   CountItemsHelper(treePtr->GetLeftChildPtr()) +
+		   CountItemsHelper(treePtr->GetRightChildPtr());
+}
@@ -0,0 +1,227 @@
+// ============================================================================
+// File: CMultiIndex.h
+// ============================================================================
+// Header file for the class CMultiIndex (one record pool, several orderings)
+// ============================================================================
+
+#ifndef CMULTIINDEX_HEADER
+#define CMULTIINDEX_HEADER
+
+#include <vector>
+
+template<class ItemType>
+class CMultiIndex
+{
+public:
+   /** Orders two items for one index.  Must be a strict weak ordering. */
+   typedef bool (*LessFunction)(const ItemType &lhs, const ItemType &rhs);
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates a container with no records and no indexes. */
+   CMultiIndex();
+
+   /** Compiler provided copy constructor and destructor will suffice, since
+       every link is a record number rather than a pointer. */
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Adds an ordering over the records.  Records already in the container
+       are indexed right away.
+    @param Less: The ordering of the new index.
+    @return  The number of the new index, used by the lookup functions. */
+   int AddIndex(LessFunction Less);
+
+   /** Stores a record once and links it into every index.  Its slot, its
+       links in every index and the scratch space a rebalance needs are all
+       reserved before any index is changed, so if an allocation fails the
+       container is left as it was.
+    @param newEntry: The record to add.
+    @return  The record number, which stays valid until it is removed. */
+   int Add(const ItemType &newEntry);
+
+   /** Unlinks a record from every index and frees its slot.  As with Add,
+       storage is reserved before any index is changed.
+    @param record: A record number returned by Add.
+    @return  True if the record was removed, or false if it did not exist. */
+   bool RemoveRecord(int record);
+
+   /** Removes the first record that is == anEntry.
+    @param anEntry: The record to remove.
+    @return  True if a record was removed, or false if none matched. */
+   bool Remove(const ItemType &anEntry);
+
+   /** Returns a stored record.
+    @param record: A record number returned by Add.
+    @return  A const reference to the record. */
+   const ItemType& GetRecord(int record) const;
+
+   /** Checks if a record number refers to a stored record.
+    @param record: The record number to check.
+    @return  True if the record exists, or false if it does not. */
+   bool IsRecord(int record) const;
+
+   /** Finds a record equivalent to probe under one index's ordering (for the
+       name index, a probe only needs its first and last name set).
+    @param index: The index to search.
+    @param probe: The record to search for.
+    @return  The record number, or -1 if no record is equivalent. */
+   int Find(int index, const ItemType &probe) const;
+
+   /** Visits, in the order of one index, every record that is not less than
+       low and not greater than high.
+    @param index: The index to walk.
+    @param low: The smallest record to visit.
+    @param high: The largest record to visit.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void RangeTraverse(int index, const ItemType &low, const ItemType &high,
+                      void Visit(ItemType &item)) const;
+
+   /** Visits every record in the order of one index.
+    @param index: The index to walk.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void InorderTraverse(int index, void Visit(ItemType &item)) const;
+
+   /** Returns the number of stored records.
+    @param Nothing.
+    @return  The number of records. */
+   int GetNumberOfRecords() const;
+
+   /** Returns the height of one index.
+    @param index: The index to measure.
+    @return  The height of the index. */
+   int GetHeight(int index) const;
+
+   /** Removes every record (the indexes are kept).
+    @param Nothing.
+    @return  Nothing. */
+   void Clear();
+
+private:
+   // =========================================================================
+   //      Private Types
+   // =========================================================================
+
+   // the child links of one record in one index
+   struct CLinks
+   {
+      int   m_left;
+      int   m_right;
+   };
+
+   // one ordering over the records
+   struct CIndex
+   {
+      LessFunction          m_less;
+      int                   m_root;
+      int                   m_size;
+      int                   m_maxSize;    // Largest size since last rebuild
+      std::vector<CLinks>   m_links;      // Indexed by record number
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Reserves the storage that linking or unlinking one record needs, so
+       Link and Unlink never allocate.
+    @param slots: The number of record slots after the change.
+    @return  Nothing. */
+   void Reserve(size_t slots);
+
+   /** Links a record into one index as a leaf, rebuilding the lowest
+       unbalanced subtree on the path if the leaf ends up too deep.
+    @param index: The index.
+    @param record: The record to link.
+    @return  Nothing. */
+   void Link(CIndex &index, int record);
+
+   /** Unlinks a record from one index.
+    @param index: The index.
+    @param record: The record to unlink.
+    @return  Nothing. */
+   void Unlink(CIndex &index, int record);
+
+   /** Finds the link that points at a record (the root or a child link).
+    @param index: The index.
+    @param record: The record to find.
+    @return  A pointer to the link, or nullptr if the record is not found. */
+   int* FindLink(CIndex &index, int record);
+
+   /** Orders two stored records within one index, breaking ties by record
+       number.
+    @param index: The index.
+    @param lhs: A record number.
+    @param rhs: A record number.
+    @return  True if lhs comes before rhs in the index. */
+   bool Before(const CIndex &index, int lhs, int rhs) const;
+
+   /** Finds a record that is == anEntry among the records of a subtree
+       that are equivalent to it.
+    @param index: The index.
+    @param node: The root of the subtree.
+    @param anEntry: The record to find.
+    @return  The record number, or -1 if none matched. */
+   int FindMatch(const CIndex &index, int node, const ItemType &anEntry) const;
+
+   /** Counts the records in a subtree.
+    @param index: The index.
+    @param node: The root of the subtree.
+    @return  The number of records. */
+   int CountNodes(const CIndex &index, int node) const;
+
+   /** Appends the records of a subtree in order.
+    @param index: The index.
+    @param node: The root of the subtree.
+    @param records: The vector to append to.
+    @return  Nothing. */
+   void Flatten(const CIndex &index, int node, std::vector<int> &records) const;
+
+   /** Links sorted records into a perfectly balanced subtree, the same way
+       CBST::ArrayToTreeHelper does.
+    @param index: The index.
+    @param records: The records in order.
+    @param start: First position to use.
+    @param end: Last position to use.
+    @return  The root of the subtree, or -1 if it is empty. */
+   int BuildBalanced(CIndex &index, const std::vector<int> &records,
+                     int start, int end);
+
+   /** Recursive helper for RangeTraverse and InorderTraverse.
+    @param index: The index.
+    @param node: The root of the subtree.
+    @param low: The smallest record to visit, or nullptr for no bound.
+    @param high: The largest record to visit, or nullptr for no bound.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void RangeHelper(const CIndex &index, int node, const ItemType *low,
+                    const ItemType *high, void Visit(ItemType &item)) const;
+
+   /** Returns the height of a subtree.
+    @param index: The index.
+    @param node: The root of the subtree.
+    @return  The height. */
+   int HeightHelper(const CIndex &index, int node) const;
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   std::vector<ItemType>   m_records;   // Every record, stored once
+   std::vector<bool>       m_live;      // True if the slot holds a record
+   std::vector<int>        m_free;      // Slots free for reuse
+   std::vector<CIndex>     m_indexes;
+   int                     m_count;
+   std::vector<int>        m_path;      // Scratch: Link's path from the root
+   std::vector<int>        m_flat;      // Scratch: a subtree being rebuilt
+}; // end CMultiIndex
+
+#include "CMultiIndex.tpp"
+
+#endif  // CMULTIINDEX_HEADER
@@ -0,0 +1,894 @@
+// ============================================================================
+// File: CMultiIndex.tpp
+// ============================================================================
+// This is the implementation file for the class CMultiIndex.  Records live in
+// one pool and are named by their slot number.  Each index is a binary search
+// tree over slot numbers whose child links are kept in an array beside the
+// pool, so adding an index costs two ints per record instead of a copy of
+// every record.
+//
+// An index is kept balanced the way a scapegoat tree is: a new leaf that
+// lands deeper than log1.5(size) causes its lowest ancestor that is more
+// than 2/3 one-sided to be rebuilt perfectly balanced (as CBST's
+// ArrayToTreeHelper does for the whole tree), and the whole index is rebuilt
+// once removals shrink it below 2/3 of its largest size.  Both keep the
+// height O(log n) at O(log n) amortized cost per change.
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include "CMultiIndex.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates a container with no records and no indexes.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CMultiIndex<ItemType>::CMultiIndex() : m_count(0)
+{
+
+}
+
+
+
+// ==== AddIndex ==============================================================
+//
+// Adds an ordering over the records and indexes the existing records by
+// sorting them once and building the tree balanced.
+//
+// Input:
+//		Less	[IN] - the ordering of the new index
+//
+// Output:
+//		int  -  the number of the new index
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::AddIndex(LessFunction Less)
+{
+	CIndex index;
+	index.m_less = Less;
+	index.m_root = -1;
+	index.m_size = m_count;
+	index.m_maxSize = m_count;
+	CLinks empty = { -1, -1 };
+	index.m_links.assign(m_records.size(), empty);
+
+	std::vector<int> records;
+	for (size_t slot = 0; slot < m_records.size(); ++slot)
+	{
+		if (m_live[slot])
+		{
+			records.push_back((int)slot);
+		}
+	}
+
+	const std::vector<ItemType> &pool = m_records;
+	std::stable_sort(records.begin(), records.end(),
+					 [&pool, Less](int lhs, int rhs)
+					 {
+						 return Less(pool[lhs], pool[rhs]);
+					 });
+	//the sort is stable over ascending record numbers, which is the
+	//tie-break Before uses
+
+	index.m_root = BuildBalanced(index, records, 0, (int)records.size() - 1);
+	m_indexes.push_back(index);
+
+	return (int)m_indexes.size() - 1;
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Stores a record once and links it into every index.  Every allocation
+// happens before the first index is changed: Reserve makes room for the new
+// slot and for Link's scratch space, and the record itself is copied in
+// before anything else is touched.
+//
+// Input:
+//		newEntry	[IN] - the record to add
+//
+// Output:
+//		int  -  the record number
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::Add(const ItemType &newEntry)
+{
+	int record;
+
+	Reserve(m_records.size() + (m_free.empty() ? 1 : 0));
+
+	if (!m_free.empty())
+	{
+		record = m_free.back();
+		m_records[record] = newEntry;
+		m_free.pop_back();
+	}
+	else
+	{
+		//only the copy of the record can throw from here on
+		record = (int)m_records.size();
+		m_records.push_back(newEntry);
+		m_live.push_back(false);
+
+		CLinks empty = { -1, -1 };
+		for (size_t index = 0; index < m_indexes.size(); ++index)
+		{
+			m_indexes[index].m_links.push_back(empty);
+		}
+	}
+
+	m_live[record] = true;
+	++m_count;
+
+	for (size_t index = 0; index < m_indexes.size(); ++index)
+	{
+		Link(m_indexes[index], record);
+	}
+
+	return record;
+}
+
+
+
+// ==== RemoveRecord ==========================================================
+//
+// Unlinks a record from every index and frees its slot.
+//
+// Input:
+//		record	[IN] - a record number returned by Add
+//
+// Output:
+//		bool  -  True if the record was removed, false if it did not exist
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiIndex<ItemType>::RemoveRecord(int record)
+{
+	if (!IsRecord(record))
+	{
+		return false;
+	}
+
+	//a copied container starts without scratch space
+	Reserve(m_records.size());
+	m_free.reserve(m_free.size() + 1);
+
+	for (size_t index = 0; index < m_indexes.size(); ++index)
+	{
+		Unlink(m_indexes[index], record);
+	}
+
+	m_records[record] = ItemType();
+	m_live[record] = false;
+	m_free.push_back(record);
+	--m_count;
+
+	return true;
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Removes the first record that is == anEntry.  With an index only the
+// records equivalent to anEntry in index 0 are compared; without one the
+// pool is scanned.
+//
+// Input:
+//		anEntry	[IN] - the record to remove
+//
+// Output:
+//		bool  -  True if a record was removed, false if none matched
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiIndex<ItemType>::Remove(const ItemType &anEntry)
+{
+	if (!m_indexes.empty())
+	{
+		return RemoveRecord(FindMatch(m_indexes[0], m_indexes[0].m_root,
+									  anEntry));
+	}
+
+	for (size_t slot = 0; slot < m_records.size(); ++slot)
+	{
+		if (m_live[slot] && m_records[slot] == anEntry)
+		{
+			return RemoveRecord((int)slot);
+		}
+	}
+
+	return false;
+}
+
+
+
+// ==== GetRecord =============================================================
+//
+// Returns a stored record.
+//
+// Input:
+//		record	[IN] - a record number returned by Add
+//
+// Output:
+//		ItemType  -  a const reference to the record
+//
+// ============================================================================
+template<class ItemType>
+const ItemType& CMultiIndex<ItemType>::GetRecord(int record) const
+{
+	return m_records[record];
+}
+
+
+
+// ==== IsRecord ==============================================================
+//
+// Checks if a record number refers to a stored record.
+//
+// Input:
+//		record	[IN] - the record number to check
+//
+// Output:
+//		bool  -  True if the record exists
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiIndex<ItemType>::IsRecord(int record) const
+{
+	return record >= 0 && record < (int)m_records.size() && m_live[record];
+}
+
+
+
+// ==== Find ==================================================================
+//
+// Finds a record equivalent to probe under one index's ordering.
+//
+// Input:
+//		index	[IN] - the index to search
+//		probe	[IN] - the record to search for
+//
+// Output:
+//		int  -  the record number, or -1 if no record is equivalent
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::Find(int index, const ItemType &probe) const
+{
+	const CIndex &tree = m_indexes[index];
+	int node = tree.m_root;
+
+	while (node != -1)
+	{
+		if (tree.m_less(probe, m_records[node]))
+		{
+			node = tree.m_links[node].m_left;
+		}
+		else if (tree.m_less(m_records[node], probe))
+		{
+			node = tree.m_links[node].m_right;
+		}
+		else
+		{
+			return node;
+		}
+	}
+
+	return -1;
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// Visits, in the order of one index, every record in [low, high].
+//
+// Input:
+//		index	[IN] - the index to walk
+//		low		[IN] - the smallest record to visit
+//		high	[IN] - the largest record to visit
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::RangeTraverse(int index, const ItemType &low,
+										  const ItemType &high,
+										  void Visit(ItemType &item)) const
+{
+	RangeHelper(m_indexes[index], m_indexes[index].m_root, &low, &high, Visit);
+}
+
+
+
+// ==== InorderTraverse =======================================================
+//
+// Visits every record in the order of one index.
+//
+// Input:
+//		index	[IN] - the index to walk
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::InorderTraverse(int index,
+											void Visit(ItemType &item)) const
+{
+	RangeHelper(m_indexes[index], m_indexes[index].m_root, nullptr, nullptr,
+				Visit);
+}
+
+
+
+// ==== GetNumberOfRecords ====================================================
+//
+// Returns the number of stored records.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of records
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::GetNumberOfRecords() const
+{
+	return m_count;
+}
+
+
+
+// ==== GetHeight =============================================================
+//
+// Returns the height of one index.
+//
+// Input:
+//		index	[IN] - the index to measure
+//
+// Output:
+//		int  -  the height of the index
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::GetHeight(int index) const
+{
+	return HeightHelper(m_indexes[index], m_indexes[index].m_root);
+}
+
+
+
+// ==== Clear =================================================================
+//
+// Removes every record (the indexes are kept).
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::Clear()
+{
+	m_records.clear();
+	m_live.clear();
+	m_free.clear();
+	m_count = 0;
+
+	for (size_t index = 0; index < m_indexes.size(); ++index)
+	{
+		m_indexes[index].m_root = -1;
+		m_indexes[index].m_size = 0;
+		m_indexes[index].m_maxSize = 0;
+		m_indexes[index].m_links.clear();
+	}
+}
+
+
+
+// ==== Reserve ===============================================================
+//
+// Reserves the storage that linking or unlinking one record needs: room for
+// slots records in the pool and in every index's links, and room for a path
+// or a flattened subtree as long as every record.  Capacity grows
+// geometrically, so this costs nothing on most calls.
+//
+// Input:
+//		slots	[IN] - the number of record slots after the change
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::Reserve(size_t slots)
+{
+	size_t room = std::max(slots, 2 * m_records.capacity());
+
+	if (m_records.capacity() < slots)
+	{
+		m_records.reserve(room);
+	}
+	if (m_live.capacity() < slots)
+	{
+		m_live.reserve(room);
+	}
+	for (size_t index = 0; index < m_indexes.size(); ++index)
+	{
+		if (m_indexes[index].m_links.capacity() < slots)
+		{
+			m_indexes[index].m_links.reserve(room);
+		}
+	}
+	if (m_path.capacity() < slots)
+	{
+		m_path.reserve(room);
+	}
+	if (m_flat.capacity() < slots)
+	{
+		m_flat.reserve(room);
+	}
+}
+
+
+
+// ==== Link ==================================================================
+//
+// Links a record into one index as a leaf.  If the leaf lands deeper than
+// log1.5(size), the lowest ancestor on the path whose child holds more than
+// 2/3 of its records is rebuilt perfectly balanced.  The path and the
+// rebuilt subtree use the scratch vectors Reserve sized, so nothing here
+// allocates.
+//
+// Input:
+//		index	[IN/OUT] - the index
+//		record	[IN] - the record to link
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::Link(CIndex &index, int record)
+{
+	index.m_links[record].m_left = -1;
+	index.m_links[record].m_right = -1;
+
+	//walk down, remembering the path (Reserve made room for it)
+	std::vector<int> &path = m_path;
+	path.clear();
+	int *link = &index.m_root;
+	while (*link != -1)
+	{
+		path.push_back(*link);
+		if (Before(index, record, *link))
+		{
+			link = &index.m_links[*link].m_left;
+		}
+		else
+		{
+			link = &index.m_links[*link].m_right;
+		}
+	}
+	*link = record;
+	path.push_back(record);
+
+	++index.m_size;
+	index.m_maxSize = std::max(index.m_maxSize, index.m_size);
+
+	int depth = (int)path.size() - 1;
+	if (depth <= (int)(std::log((double)index.m_size) / std::log(1.5)))
+	{
+		return;
+	}
+
+	//find the lowest scapegoat on the path
+	int scapegoat = -1;
+	int childSize = 1;
+	for (int pos = (int)path.size() - 2; pos >= 0; --pos)
+	{
+		int node = path[pos];
+		int child = path[pos + 1];
+		int sibling = (index.m_links[node].m_left == child) ?
+					  index.m_links[node].m_right : index.m_links[node].m_left;
+		int nodeSize = childSize + CountNodes(index, sibling) + 1;
+
+		if (3 * childSize > 2 * nodeSize)
+		{
+			scapegoat = pos;
+			break;
+		}
+		childSize = nodeSize;
+	}
+
+	if (scapegoat == -1)
+	{
+		return;
+	}
+
+	m_flat.clear();
+	Flatten(index, path[scapegoat], m_flat);
+	int subRoot = BuildBalanced(index, m_flat, 0, (int)m_flat.size() - 1);
+
+	if (scapegoat == 0)
+	{
+		index.m_root = subRoot;
+	}
+	else
+	{
+		CLinks &parent = index.m_links[path[scapegoat - 1]];
+		if (parent.m_left == path[scapegoat])
+		{
+			parent.m_left = subRoot;
+		}
+		else
+		{
+			parent.m_right = subRoot;
+		}
+	}
+}
+
+
+
+// ==== Unlink ================================================================
+//
+// Unlinks a record from one index.  A record with two children is replaced
+// by its in-order successor, which is relinked rather than copied because
+// the record itself is shared with the other indexes.
+//
+// Input:
+//		index	[IN/OUT] - the index
+//		record	[IN] - the record to unlink
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::Unlink(CIndex &index, int record)
+{
+	int *link = FindLink(index, record);
+	if (link == nullptr)
+	{
+		return;
+	}
+
+	CLinks &node = index.m_links[record];
+	if (node.m_left == -1)
+	{
+		*link = node.m_right;
+	}
+	else if (node.m_right == -1)
+	{
+		*link = node.m_left;
+	}
+	else
+	{
+		int *minLink = &node.m_right;
+		while (index.m_links[*minLink].m_left != -1)
+		{
+			minLink = &index.m_links[*minLink].m_left;
+		}
+
+		int successor = *minLink;
+		*minLink = index.m_links[successor].m_right;
+		index.m_links[successor].m_left = node.m_left;
+		index.m_links[successor].m_right = node.m_right;
+		*link = successor;
+	}
+
+	node.m_left = -1;
+	node.m_right = -1;
+	--index.m_size;
+
+	//rebuild once the index has shrunk well below its largest size
+	if (3 * index.m_size < 2 * index.m_maxSize)
+	{
+		m_flat.clear();
+		Flatten(index, index.m_root, m_flat);
+		index.m_root = BuildBalanced(index, m_flat, 0, (int)m_flat.size() - 1);
+		index.m_maxSize = index.m_size;
+	}
+}
+
+
+
+// ==== FindLink ==============================================================
+//
+// Finds the link that points at a record.
+//
+// Input:
+//		index	[IN] - the index
+//		record	[IN] - the record to find
+//
+// Output:
+//		int*  -  a pointer to the link, or nullptr if not found
+//
+// ============================================================================
+template<class ItemType>
+int* CMultiIndex<ItemType>::FindLink(CIndex &index, int record)
+{
+	int *link = &index.m_root;
+
+	while (*link != -1 && *link != record)
+	{
+		if (Before(index, record, *link))
+		{
+			link = &index.m_links[*link].m_left;
+		}
+		else
+		{
+			link = &index.m_links[*link].m_right;
+		}
+	}
+
+	return (*link == -1) ? nullptr : link;
+}
+
+
+
+// ==== Before ================================================================
+//
+// Orders two stored records within one index.  Records the index's ordering
+// cannot tell apart are ordered by record number, so every record has
+// exactly one place in every index and can be found in O(log n) even when
+// many records share a key.
+//
+// Input:
+//		index	[IN] - the index
+//		lhs		[IN] - a record number
+//		rhs		[IN] - a record number
+//
+// Output:
+//		bool  -  True if lhs comes before rhs in the index
+//
+// ============================================================================
+template<class ItemType>
+bool CMultiIndex<ItemType>::Before(const CIndex &index, int lhs, int rhs) const
+{
+	if (index.m_less(m_records[lhs], m_records[rhs]))
+	{
+		return true;
+	}
+	if (index.m_less(m_records[rhs], m_records[lhs]))
+	{
+		return false;
+	}
+
+	return lhs < rhs;
+}
+
+
+
+// ==== FindMatch =============================================================
+//
+// Finds a record that is == anEntry among the records of a subtree that are
+// equivalent to it, searching both sides of every equivalent node.
+//
+// Input:
+//		index	[IN] - the index
+//		node	[IN] - the root of the subtree
+//		anEntry	[IN] - the record to find
+//
+// Output:
+//		int  -  the record number, or -1 if none matched
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::FindMatch(const CIndex &index, int node,
+									 const ItemType &anEntry) const
+{
+	while (node != -1)
+	{
+		if (index.m_less(anEntry, m_records[node]))
+		{
+			node = index.m_links[node].m_left;
+		}
+		else if (index.m_less(m_records[node], anEntry))
+		{
+			node = index.m_links[node].m_right;
+		}
+		else
+		{
+			if (m_records[node] == anEntry)
+			{
+				return node;
+			}
+
+			int found = FindMatch(index, index.m_links[node].m_left, anEntry);
+			if (found != -1)
+			{
+				return found;
+			}
+			node = index.m_links[node].m_right;
+		}
+	}
+
+	return -1;
+}
+
+
+
+// ==== CountNodes ============================================================
+//
+// Counts the records in a subtree.
+//
+// Input:
+//		index	[IN] - the index
+//		node	[IN] - the root of the subtree
+//
+// Output:
+//		int  -  the number of records
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::CountNodes(const CIndex &index, int node) const
+{
+	if (node == -1)
+	{
+		return 0;
+	}
+
+	return 1 + CountNodes(index, index.m_links[node].m_left) +
+			   CountNodes(index, index.m_links[node].m_right);
+}
+
+
+
+// ==== Flatten ===============================================================
+//
+// Appends the records of a subtree in order.
+//
+// Input:
+//		index	[IN] - the index
+//		node	[IN] - the root of the subtree
+//		records	[IN/OUT] - the vector to append to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::Flatten(const CIndex &index, int node,
+									std::vector<int> &records) const
+{
+	if (node == -1)
+	{
+		return;
+	}
+
+	Flatten(index, index.m_links[node].m_left, records);
+	records.push_back(node);
+	Flatten(index, index.m_links[node].m_right, records);
+}
+
+
+
+// ==== BuildBalanced =========================================================
+//
+// Links sorted records into a perfectly balanced subtree.
+//
+// Input:
+//		index	[IN/OUT] - the index
+//		records	[IN] - the records in order
+//		start	[IN] - first position to use
+//		end		[IN] - last position to use
+//
+// Output:
+//		int  -  the root of the subtree, or -1 if it is empty
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::BuildBalanced(CIndex &index,
+										 const std::vector<int> &records,
+										 int start, int end)
+{
+	if (start > end)
+	{
+		return -1;
+	}
+
+	int mid = (start + end) / 2;
+	int node = records[mid];
+	index.m_links[node].m_left = BuildBalanced(index, records, start, mid - 1);
+	index.m_links[node].m_right = BuildBalanced(index, records, mid + 1, end);
+
+	return node;
+}
+
+
+
+// ==== RangeHelper ===========================================================
+//
+// Recursive helper for RangeTraverse and InorderTraverse.  Visit gets a copy
+// so it cannot reorder a record under the indexes.
+//
+// Input:
+//		index	[IN] - the index
+//		node	[IN] - the root of the subtree
+//		low		[IN] - the smallest record to visit, or nullptr
+//		high	[IN] - the largest record to visit, or nullptr
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CMultiIndex<ItemType>::RangeHelper(const CIndex &index, int node,
+										const ItemType *low,
+										const ItemType *high,
+										void Visit(ItemType &item)) const
+{
+	if (node == -1)
+	{
+		return;
+	}
+
+	const ItemType &record = m_records[node];
+	bool aboveLow = (low == nullptr) || !index.m_less(record, *low);
+	bool belowHigh = (high == nullptr) || !index.m_less(*high, record);
+
+	if (aboveLow)
+	{
+		RangeHelper(index, index.m_links[node].m_left, low, high, Visit);
+	}
+
+	if (aboveLow && belowHigh)
+	{
+		ItemType itemContents = record;
+		Visit(itemContents);
+	}
+
+	if (belowHigh)
+	{
+		RangeHelper(index, index.m_links[node].m_right, low, high, Visit);
+	}
+}
+
+
+
+// ==== HeightHelper ==========================================================
+//
+// Returns the height of a subtree.
+//
+// Input:
+//		index	[IN] - the index
+//		node	[IN] - the root of the subtree
+//
+// Output:
+//		int  -  the height
+//
+// ============================================================================
+template<class ItemType>
+int CMultiIndex<ItemType>::HeightHelper(const CIndex &index, int node) const
+{
+	if (node == -1)
+	{
+		return 0;
+	}
+
+	return 1 + std::max(HeightHelper(index, index.m_links[node].m_left),
+						HeightHelper(index, index.m_links[node].m_right));
+}
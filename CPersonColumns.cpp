@@ -0,0 +1,193 @@
+// ============================================================================
+// File: CPersonColumns.cpp
+// ============================================================================
+// Implimentation file for the struct CPersonColumns
+// ============================================================================
+
+#include <string>
+#include <string_view>
+using namespace std;
+#include "CPersonColumns.h"
+
+// ==== Default Constructor ===================================================
+//
+// Creates columns with no rows.  m_nameOffsets always holds one more
+// offset than there are names, the end of the last name.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CPersonColumns::CPersonColumns() : m_nameOffsets(1, 0)
+{
+
+}
+
+
+
+// ==== Clear =================================================================
+//
+// Removes every row, keeping the memory of the columns.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CPersonColumns::Clear()
+{
+	m_ages.clear();
+	m_checking.clear();
+	m_savings.clear();
+	m_nameOffsets.assign(1, 0);
+	m_names.clear();
+}
+
+
+
+// ==== Append ================================================================
+//
+// Appends a person as the last row.
+//
+// Input:
+//		person	[IN] - the person to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CPersonColumns::Append(const CPersonInfo &person)
+{
+	m_ages.push_back(person.GetAge());
+	m_checking.push_back(person.GetChecking());
+	m_savings.push_back(person.GetSavings());
+
+	m_names += person.GetFirstName();
+	m_nameOffsets.push_back(m_names.size());
+	m_names += person.GetLastName();
+	m_nameOffsets.push_back(m_names.size());
+}
+
+
+
+// ==== GetCount ==============================================================
+//
+// Returns the number of rows.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		size_t  -  the number of rows
+//
+// ============================================================================
+size_t CPersonColumns::GetCount() const
+{
+	return m_ages.size();
+}
+
+
+
+// ==== GetFirstName ==========================================================
+//
+// Returns the first name of a row.
+//
+// Input:
+//		row	[IN] - the row
+//
+// Output:
+//		string_view  -  the name
+//
+// ============================================================================
+string_view CPersonColumns::GetFirstName(size_t row) const
+{
+	return string_view(m_names).substr(m_nameOffsets[2 * row],
+									   m_nameOffsets[2 * row + 1] -
+									   m_nameOffsets[2 * row]);
+}
+
+
+
+// ==== GetLastName ===========================================================
+//
+// Returns the last name of a row.
+//
+// Input:
+//		row	[IN] - the row
+//
+// Output:
+//		string_view  -  the name
+//
+// ============================================================================
+string_view CPersonColumns::GetLastName(size_t row) const
+{
+	return string_view(m_names).substr(m_nameOffsets[2 * row + 1],
+									   m_nameOffsets[2 * row + 2] -
+									   m_nameOffsets[2 * row + 1]);
+}
+
+
+
+// ==== AggregateChecking =====================================================
+//
+// Aggregates the checking balances of an age range with ScanAggregate.
+//
+// Input:
+//		lowAge	[IN] - the youngest age to include
+//		highAge	[IN] - the oldest age to include
+//
+// Output:
+//		CColumnAggregate  -  the count, sum, minimum and maximum
+//
+// ============================================================================
+CColumnAggregate CPersonColumns::AggregateChecking(int lowAge,
+												   int highAge) const
+{
+	return ScanAggregate(m_ages.data(), m_checking.data(), m_ages.size(),
+						 lowAge, highAge);
+}
+
+
+
+// ==== AggregateSavings ======================================================
+//
+// Aggregates the savings balances of an age range with ScanAggregate.
+//
+// Input:
+//		lowAge	[IN] - the youngest age to include
+//		highAge	[IN] - the oldest age to include
+//
+// Output:
+//		CColumnAggregate  -  the count, sum, minimum and maximum
+//
+// ============================================================================
+CColumnAggregate CPersonColumns::AggregateSavings(int lowAge,
+												  int highAge) const
+{
+	return ScanAggregate(m_ages.data(), m_savings.data(), m_ages.size(),
+						 lowAge, highAge);
+}
+
+
+
+// ==== CountAges =============================================================
+//
+// Counts the people in an age range with ScanCount.
+//
+// Input:
+//		lowAge	[IN] - the youngest age to count
+//		highAge	[IN] - the oldest age to count
+//
+// Output:
+//		long long  -  the number of people
+//
+// ============================================================================
+long long CPersonColumns::CountAges(int lowAge, int highAge) const
+{
+	return ScanCount(m_ages.data(), m_ages.size(), lowAge, highAge);
+}
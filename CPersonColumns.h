@@ -0,0 +1,82 @@
+// ============================================================================
+// File: CPersonColumns.h
+// ============================================================================
+// Header file for the struct CPersonColumns, CPersonInfo objects laid out
+// one column per member (see CBST::ExportColumns).  Reports that add up one
+// member over many people read that member's column from start to end
+// instead of chasing tree nodes, and the scans of CColumnScan.h aggregate
+// a balance column filtered by age without a branch per person.
+// ============================================================================
+
+#ifndef CPERSONCOLUMNS_HEADER
+#define CPERSONCOLUMNS_HEADER
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CColumnScan.h"
+#include "CPersonInfo.h"
+
+struct CPersonColumns
+{
+   /** Creates columns with no rows. */
+   CPersonColumns();
+
+   /** Removes every row, keeping the memory of the columns.
+    @param Nothing.
+    @return  Nothing. */
+   void Clear();
+
+   /** Appends a person as the last row.
+    @param person: The person to append.
+    @return  Nothing. */
+   void Append(const CPersonInfo &person);
+
+   /** Returns the number of rows.
+    @param Nothing.
+    @return  The number of rows. */
+   size_t GetCount() const;
+
+   /** Returns the first name of a row.
+    @param row: The row, from 0 to GetCount() - 1.
+    @return  A view of the name, valid until the columns next change. */
+   std::string_view GetFirstName(size_t row) const;
+
+   /** Returns the last name of a row.
+    @param row: The row, from 0 to GetCount() - 1.
+    @return  A view of the name, valid until the columns next change. */
+   std::string_view GetLastName(size_t row) const;
+
+   /** Aggregates the checking balances of the people aged lowAge to
+       highAge, inclusive.
+    @param lowAge: The youngest age to include.
+    @param highAge: The oldest age to include.
+    @return  The count, sum, minimum and maximum of the balances. */
+   CColumnAggregate AggregateChecking(int lowAge, int highAge) const;
+
+   /** Aggregates the savings balances of the people aged lowAge to
+       highAge, inclusive.
+    @param lowAge: The youngest age to include.
+    @param highAge: The oldest age to include.
+    @return  The count, sum, minimum and maximum of the balances. */
+   CColumnAggregate AggregateSavings(int lowAge, int highAge) const;
+
+   /** Counts the people aged lowAge to highAge, inclusive.
+    @param lowAge: The youngest age to count.
+    @param highAge: The oldest age to count.
+    @return  The number of people. */
+   long long CountAges(int lowAge, int highAge) const;
+
+   std::vector<int>     m_ages;
+   std::vector<double>  m_checking;
+   std::vector<double>  m_savings;
+
+   // The names of every row, back to back in m_names: row r's first name
+   // starts at m_nameOffsets[2r] and its last name at m_nameOffsets[2r + 1],
+   // each ending where the next begins
+   std::vector<size_t>  m_nameOffsets;
+   std::string          m_names;
+}; // end CPersonColumns
+
+#endif  // CPERSONCOLUMNS_HEADER
@@ -7,6 +7,48 @@
 #include <iostream>
 using namespace std;
 #include "CPersonInfo.h"
+#include "CSnapshotIO.h"
+#include "CTreeStats.h"
+#ifdef CBST_COMPACT_RECORDS
+#include <cmath>
+#include "CStringArena.h"
+
+// ==== ToCents ===============================================================
+//
+// Converts an amount of money to whole cents, rounding to the nearest.
+//
+// Input:
+//		amount	[IN] - the amount
+//
+// Output:
+//		long long  -  the amount in cents
+//
+// ============================================================================
+static long long ToCents(double amount)
+{
+	return llround(amount * 100);
+}
+
+
+
+// ==== BlankNameId ===========================================================
+//
+// Returns the ID of the name a default constructed person has, interning it
+// only once.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		unsigned int  -  the ID in PersonNameArena
+//
+// ============================================================================
+static unsigned int BlankNameId()
+{
+	static const unsigned int blankId = PersonNameArena().Intern(" ");
+	return blankId;
+}
+#endif
 
 // =========================================================================
 //      Constructors and Destructor
@@ -23,8 +65,14 @@ using namespace std;
 //		nothing
 //
 // ============================================================================
+#ifdef CBST_COMPACT_RECORDS
+CPersonInfo::CPersonInfo() : m_age(0), m_fnameId(BlankNameId()),
+							 m_lnameId(BlankNameId()), m_checkingCents(0),
+							 m_savingsCents(0)
+#else
 CPersonInfo::CPersonInfo() : m_fname(" "), m_lname(" "), m_age(0), m_checking(0),
 							 m_savings(0)
+#endif
 {
 	
 }
@@ -44,9 +92,16 @@ CPersonInfo::CPersonInfo() : m_fname(" "), m_lname(" "), m_age(0), m_checking(0)
 //
 // ============================================================================
 CPersonInfo::CPersonInfo(const string &fname, const string &lname,
-            int age, double checking, double savings): m_fname(fname),
-            m_lname(lname), m_age(age), m_checking(checking),
+            int age, double checking, double savings):
+#ifdef CBST_COMPACT_RECORDS
+            m_age(age), m_fnameId(PersonNameArena().Intern(fname)),
+            m_lnameId(PersonNameArena().Intern(lname)),
+            m_checkingCents(ToCents(checking)),
+            m_savingsCents(ToCents(savings))
+#else
+            m_fname(fname), m_lname(lname), m_age(age), m_checking(checking),
             m_savings(savings)
+#endif
 {
  	
 }
@@ -66,7 +121,11 @@ CPersonInfo::CPersonInfo(const string &fname, const string &lname,
 // ============================================================================
 void CPersonInfo::SetFirstName(const string &fname)
 {
+#ifdef CBST_COMPACT_RECORDS
+   	m_fnameId = PersonNameArena().Intern(fname);
+#else
    	m_fname = fname;
+#endif
 }
 
 
@@ -84,7 +143,11 @@ void CPersonInfo::SetFirstName(const string &fname)
 // ============================================================================
 void CPersonInfo::SetLastName(const string &lname)
 {
+#ifdef CBST_COMPACT_RECORDS
+   	m_lnameId = PersonNameArena().Intern(lname);
+#else
    	m_lname = lname;
+#endif
 }
 
 
@@ -120,7 +183,11 @@ void CPersonInfo::SetAge(int age)
 // ============================================================================
 void CPersonInfo::SetChecking(double checking)
 {
+#ifdef CBST_COMPACT_RECORDS
+   	m_checkingCents = ToCents(checking);
+#else
    	m_checking = checking;
+#endif
 }
 
 
@@ -138,7 +205,11 @@ void CPersonInfo::SetChecking(double checking)
 // ============================================================================
 void CPersonInfo::SetSavings(double savings)
 {
+#ifdef CBST_COMPACT_RECORDS
+   	m_savingsCents = ToCents(savings);
+#else
    	m_savings = savings;
+#endif
 }
 
 
@@ -154,9 +225,13 @@ void CPersonInfo::SetSavings(double savings)
 //		string  -  first name data member
 //
 // ============================================================================
-string CPersonInfo::GetFirstName() const
+const string& CPersonInfo::GetFirstName() const
 {
+#ifdef CBST_COMPACT_RECORDS
+   	return PersonNameArena().GetString(m_fnameId);
+#else
    	return m_fname;
+#endif
 }
 
 
@@ -172,9 +247,13 @@ string CPersonInfo::GetFirstName() const
 //		string  -  last name data member
 //
 // ============================================================================/
-string CPersonInfo::GetLastName() const
+const string& CPersonInfo::GetLastName() const
 {
+#ifdef CBST_COMPACT_RECORDS
+   	return PersonNameArena().GetString(m_lnameId);
+#else
    	return m_lname;
+#endif
 }
 
 
@@ -210,7 +289,11 @@ int CPersonInfo::GetAge() const
 // ============================================================================
 double CPersonInfo::GetChecking() const
 {
+#ifdef CBST_COMPACT_RECORDS
+   	return m_checkingCents / 100.0;
+#else
    	return m_checking;
+#endif
 }
 
 
@@ -228,7 +311,11 @@ double CPersonInfo::GetChecking() const
 // ============================================================================
 double CPersonInfo::GetSavings() const
 {
+#ifdef CBST_COMPACT_RECORDS
+   	return m_savingsCents / 100.0;
+#else
    	return m_savings;
+#endif
 }
 
 
@@ -250,11 +337,18 @@ double CPersonInfo::GetSavings() const
 //		bool  -  True if they are the same, false otherwise.
 //
 // ============================================================================
-bool CPersonInfo::operator==(const CPersonInfo &rhs)
+bool CPersonInfo::operator==(const CPersonInfo &rhs) const
 {
+#ifdef CBST_COMPACT_RECORDS
+	// Equal names are interned once, so their IDs are equal too
+	if (m_age == rhs.m_age && m_fnameId == rhs.m_fnameId &&
+		m_lnameId == rhs.m_lnameId && m_checkingCents == rhs.m_checkingCents &&
+		m_savingsCents == rhs.m_savingsCents)
+#else
 	if (m_fname == rhs.GetFirstName() && m_lname == rhs.GetLastName() &&
         m_age == rhs.GetAge() && m_checking == rhs.GetChecking() &&
    		m_savings == rhs.GetSavings())
+#endif
    	{
    		return true;
    	}
@@ -278,7 +372,7 @@ bool CPersonInfo::operator==(const CPersonInfo &rhs)
 //		bool  -  True if it is greater, false otherwise.
 //
 // ============================================================================
-bool CPersonInfo::operator>(const CPersonInfo &rhs)
+bool CPersonInfo::operator>(const CPersonInfo &rhs) const
 {
    	if (m_age > rhs.GetAge())
    	{
@@ -304,7 +398,7 @@ bool CPersonInfo::operator>(const CPersonInfo &rhs)
 //		bool  -  True if it is greater, false otherwise.
 //
 // ============================================================================
-bool CPersonInfo::operator<(const CPersonInfo &rhs)
+bool CPersonInfo::operator<(const CPersonInfo &rhs) const
 {
   	if (m_age < rhs.GetAge())
    	{
@@ -374,11 +468,262 @@ std::istream& operator>>(std::istream &ins, CPersonInfo &person)
 // ============================================================================
 std::ostream& operator<<(std::ostream &outs, const CPersonInfo &person)
 {
-	outs << "First Name: " << person.GetFirstName() << endl;
-	outs << "Last Name: " << person.GetLastName() << endl;
-	outs << "Age: " << person.GetAge() << endl;
-	outs << "Checking: " << person.GetChecking() << endl;
-	outs << "Savings: " << person.GetSavings() << endl;
+	outs << "First Name: " << person.GetFirstName() << '\n';
+	outs << "Last Name: " << person.GetLastName() << '\n';
+	outs << "Age: " << person.GetAge() << '\n';
+	outs << "Checking: " << person.GetChecking() << '\n';
+	outs << "Savings: " << person.GetSavings() << '\n';
 
 	return outs;
 }
+
+
+
+// =========================================================================
+//      Projection functions
+// =========================================================================
+
+// ==== PersonChecking ========================================================
+//
+//  Returns the checking balance of a person.
+//
+// Input:
+//		person	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		double  -  the checking balance
+//
+// ============================================================================
+double PersonChecking(const CPersonInfo &person)
+{
+	return person.GetChecking();
+}
+
+
+
+// ==== PersonSavings =========================================================
+//
+//  Returns the savings balance of a person.
+//
+// Input:
+//		person	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		double  -  the savings balance
+//
+// ============================================================================
+double PersonSavings(const CPersonInfo &person)
+{
+	return person.GetSavings();
+}
+
+
+
+// =========================================================================
+//      Ordering functions
+// =========================================================================
+
+// ==== PersonAgeLess =========================================================
+//
+//  Orders two people by age.
+//
+// Input:
+//		lhs	[IN]: A reference to a CPersonInfo object.
+//		rhs	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		bool  -  True if lhs is younger than rhs
+//
+// ============================================================================
+bool PersonAgeLess(const CPersonInfo &lhs, const CPersonInfo &rhs)
+{
+	return lhs.GetAge() < rhs.GetAge();
+}
+
+
+
+// ==== PersonNameLess ========================================================
+//
+//  Orders two people by last name, then by first name.
+//
+// Input:
+//		lhs	[IN]: A reference to a CPersonInfo object.
+//		rhs	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		bool  -  True if lhs sorts before rhs
+//
+// ============================================================================
+bool PersonNameLess(const CPersonInfo &lhs, const CPersonInfo &rhs)
+{
+	int order = lhs.GetLastName().compare(rhs.GetLastName());
+	if (order != 0)
+	{
+		return order < 0;
+	}
+
+	return lhs.GetFirstName() < rhs.GetFirstName();
+}
+
+
+
+// ==== PersonBalanceLess =====================================================
+//
+//  Orders two people by total balance (checking plus savings).
+//
+// Input:
+//		lhs	[IN]: A reference to a CPersonInfo object.
+//		rhs	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		bool  -  True if lhs has less money than rhs
+//
+// ============================================================================
+bool PersonBalanceLess(const CPersonInfo &lhs, const CPersonInfo &rhs)
+{
+	return lhs.GetChecking() + lhs.GetSavings() <
+		   rhs.GetChecking() + rhs.GetSavings();
+}
+
+
+
+// =========================================================================
+//      Snapshot encoding functions
+// =========================================================================
+
+// ==== SnapshotWrite =========================================================
+//
+//  Appends a CPersonInfo object to a snapshot buffer.
+//
+// Input:
+//		buffer	[IN/OUT]: the buffer to append to
+//		person	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void SnapshotWrite(std::string &buffer, const CPersonInfo &person)
+{
+	SnapshotWrite(buffer, person.GetFirstName());
+	SnapshotWrite(buffer, person.GetLastName());
+	SnapshotWrite(buffer, person.GetAge());
+	SnapshotWrite(buffer, person.GetChecking());
+	SnapshotWrite(buffer, person.GetSavings());
+}
+
+
+
+// ==== SnapshotRead ==========================================================
+//
+//  Reads a CPersonInfo object written by SnapshotWrite.
+//
+// Input:
+//		pos		[IN/OUT]: the current read position
+//		end		[IN]: one past the last readable byte
+//		person	[OUT]: A reference to the CPersonInfo object to fill in.
+//
+// Output:
+//		bool  -  True if the object was read, false if the buffer was short
+//
+// ============================================================================
+bool SnapshotRead(const char *&pos, const char *end, CPersonInfo &person)
+{
+	std::string fname;
+	std::string lname;
+	int age;
+	double checking;
+	double savings;
+
+	if (!SnapshotRead(pos, end, fname) || !SnapshotRead(pos, end, lname) ||
+		!SnapshotRead(pos, end, age) || !SnapshotRead(pos, end, checking) ||
+		!SnapshotRead(pos, end, savings))
+	{
+		return false;
+	}
+
+	person = CPersonInfo(fname, lname, age, checking, savings);
+
+	return true;
+}
+
+
+
+// =========================================================================
+//      Dump functions
+// =========================================================================
+
+// ==== DumpWrite =============================================================
+//
+//  Appends a CPersonInfo object to a dump.  DUMP_TEXT writes the same bytes
+//  operator<< does with a stream's default precision; DUMP_CSV writes the
+//  balances in their shortest exact form.
+//
+// Input:
+//		writer	[IN/OUT]: The writer to append to.
+//		person	[IN]: A reference to a CPersonInfo object.
+//		format	[IN]: The layout of the dump.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void DumpWrite(CDumpWriter &writer, const CPersonInfo &person,
+			   CDumpFormat format)
+{
+	if (format == DUMP_CSV)
+	{
+		writer.AppendCsvField(person.GetFirstName());
+		writer.Append(',');
+		writer.AppendCsvField(person.GetLastName());
+		writer.Append(',');
+		writer.AppendNumber(person.GetAge());
+		writer.Append(',');
+		writer.AppendNumber(person.GetChecking());
+		writer.Append(',');
+		writer.AppendNumber(person.GetSavings());
+		writer.Append('\n');
+		return;
+	}
+
+	writer.Append("First Name: ");
+	writer.Append(person.GetFirstName());
+	writer.Append("\nLast Name: ");
+	writer.Append(person.GetLastName());
+	writer.Append("\nAge: ");
+	writer.AppendNumber(person.GetAge());
+	writer.Append("\nChecking: ");
+	writer.AppendNumber(person.GetChecking(), DUMP_TEXT_PRECISION);
+	writer.Append("\nSavings: ");
+	writer.AppendNumber(person.GetSavings(), DUMP_TEXT_PRECISION);
+	writer.Append('\n');
+}
+
+
+
+// =========================================================================
+//      Memory accounting functions
+// =========================================================================
+
+// ==== HeapBytes =============================================================
+//
+//  Returns the heap memory a CPersonInfo object owns.  A compact record
+//  owns none.
+//
+// Input:
+//		person	[IN]: A reference to a CPersonInfo object.
+//
+// Output:
+//		size_t  -  the number of bytes
+//
+// ============================================================================
+size_t HeapBytes(const CPersonInfo &person)
+{
+#ifdef CBST_COMPACT_RECORDS
+	// The names belong to PersonNameArena, shared with everyone else
+	(void)person;
+	return 0;
+#else
+	return HeapBytes(person.GetFirstName()) + HeapBytes(person.GetLastName());
+#endif
+}
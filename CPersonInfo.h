@@ -2,12 +2,19 @@
 // File: CPersonInfo.h
 // ============================================================================
 // Header file for the class CPersonInfo
+//
+// With CBST_COMPACT_RECORDS defined (the CMake option of the same name) a
+// CPersonInfo is a 32-byte record: the age first, the names as IDs into
+// PersonNameArena, and the balances as whole cents.  The interface is the
+// same either way, except that balances are rounded to the cent.
 // ============================================================================
 
 #ifndef CPERSONINFO_HEADER
 #define CPERSONINFO_HEADER
 
 #include <iostream>
+#include "CDumpWriter.h"
+#include "CKeyTraits.h"
 
 class CPersonInfo
 {
@@ -57,13 +64,13 @@ public:
 
    /** Returns the first name of the class private data member
     @param Nothing.
-    @return  A string. */
-   std::string GetFirstName() const;
+    @return  A const reference to a string. */
+   const std::string& GetFirstName() const;
 
    /** Returns the last name of the class private data member
     @param Nothing.
-    @return  A string. */
-   std::string GetLastName() const;
+    @return  A const reference to a string. */
+   const std::string& GetLastName() const;
 
    /** Returns the age of the class private data member
     @param Nothing.
@@ -87,35 +94,60 @@ public:
    /** Checks if two CPersonInfo classes are exactly the same.
     @param rhs: A const reference to a CPersonInfo object.
     @return  True if they are the same, false otherwise. */
-   bool operator==(const CPersonInfo &rhs);
+   bool operator==(const CPersonInfo &rhs) const;
 
    /** Checks which CPersonInfo class is greater. For our case, we will
        distinguish what is greater by the m_age private data member. May switch
        in the future, but this is a good start.
     @param rhs: A const reference to a CPersonInfo object.
     @return  True if it is greater, false otherwise. */
-   bool operator>(const CPersonInfo &rhs);
+   bool operator>(const CPersonInfo &rhs) const;
 
    /** Checks which CPersonInfo class is lesser. For our case, we will
        distinguish what is lesser by the m_age private data member. May switch
        in the future, but this is a good start.
     @param rhs: A const reference to a CPersonInfo object.
     @return  True if it is lesser, false otherwise. */
-   bool operator<(const CPersonInfo &rhs);
+   bool operator<(const CPersonInfo &rhs) const;
 
 private:
    // =========================================================================
    //      Data Members
    // =========================================================================
 
+#ifdef CBST_COMPACT_RECORDS
+   // The key comes first, so a comparison reads only the start of a record
+   int m_age;
+   unsigned int m_fnameId;          // IDs in PersonNameArena
+   unsigned int m_lnameId;
+   long long m_checkingCents;
+   long long m_savingsCents;
+#else
    std::string m_fname;
    std::string m_lname;
    int m_age;
    double m_checking;
    double m_savings;
+#endif
 
 }; // end CPersonInfo
 
+// =========================================================================
+//      Key traits
+// =========================================================================
+
+/** A CPersonInfo is ordered by its age, so the age is its key. */
+template<>
+struct CKeyTraits<CPersonInfo>
+{
+   typedef int KeyType;
+
+   static KeyType GetKey(const CPersonInfo &item)
+   {
+      return item.GetAge();
+   }
+};
+
 // =========================================================================
 //      Overloaded stream operators prototypes
 // =========================================================================
@@ -132,4 +164,85 @@ std::istream &operator>>(std::istream &ins, CPersonInfo &person);
     @return  An output reference stream. */
 std::ostream &operator<<(std::ostream &outs, const CPersonInfo &person);
 
+// =========================================================================
+//      Projection functions (for CAggregateBST policies)
+// =========================================================================
+
+/** Returns the checking balance of a person.
+    @param person: A reference to a CPersonInfo object.
+    @return  A double. */
+double PersonChecking(const CPersonInfo &person);
+
+/** Returns the savings balance of a person.
+    @param person: A reference to a CPersonInfo object.
+    @return  A double. */
+double PersonSavings(const CPersonInfo &person);
+
+// =========================================================================
+//      Ordering functions (for CMultiIndex indexes)
+// =========================================================================
+
+/** Orders two people by age.
+    @param lhs: A reference to a CPersonInfo object.
+    @param rhs: A reference to a CPersonInfo object.
+    @return  True if lhs is younger than rhs. */
+bool PersonAgeLess(const CPersonInfo &lhs, const CPersonInfo &rhs);
+
+/** Orders two people by last name, then by first name.
+    @param lhs: A reference to a CPersonInfo object.
+    @param rhs: A reference to a CPersonInfo object.
+    @return  True if lhs sorts before rhs. */
+bool PersonNameLess(const CPersonInfo &lhs, const CPersonInfo &rhs);
+
+/** Orders two people by total balance (checking plus savings).
+    @param lhs: A reference to a CPersonInfo object.
+    @param rhs: A reference to a CPersonInfo object.
+    @return  True if lhs has less money than rhs. */
+bool PersonBalanceLess(const CPersonInfo &lhs, const CPersonInfo &rhs);
+
+// =========================================================================
+//      Snapshot encoding prototypes
+// =========================================================================
+
+/** Appends a CPersonInfo object to a snapshot buffer: the two names as
+    length-prefixed strings followed by the age, checking and savings.
+    @param buffer: The buffer to append to.
+    @param person: A reference to a CPersonInfo object.
+    @return  Nothing. */
+void SnapshotWrite(std::string &buffer, const CPersonInfo &person);
+
+/** Reads a CPersonInfo object written by SnapshotWrite.
+    @param pos: The current read position, advanced past the object.
+    @param end: One past the last readable byte.
+    @param person: A reference to the CPersonInfo object to fill in.
+    @return  True if the object was read, or false if the buffer was short. */
+bool SnapshotRead(const char *&pos, const char *end, CPersonInfo &person);
+
+// =========================================================================
+//      Dump prototypes (for CBST::Dump)
+// =========================================================================
+
+// The first line of a CSV dump of CPersonInfo objects
+const char PERSON_CSV_HEADER[] = "first_name,last_name,age,checking,savings\n";
+
+/** Appends a CPersonInfo object to a dump.  DUMP_TEXT writes what
+    operator<< writes; DUMP_CSV writes one line in the columns of
+    PERSON_CSV_HEADER, with the balances in their shortest exact form.
+    @param writer: The writer to append to.
+    @param person: A reference to a CPersonInfo object.
+    @param format: The layout of the dump.
+    @return  Nothing. */
+void DumpWrite(CDumpWriter &writer, const CPersonInfo &person,
+               CDumpFormat format);
+
+// =========================================================================
+//      Memory accounting prototypes (for CTreeStats)
+// =========================================================================
+
+/** Returns the heap memory a CPersonInfo object owns: whatever its names
+    do not fit inside their string objects.
+    @param person: A reference to a CPersonInfo object.
+    @return  The number of bytes. */
+size_t HeapBytes(const CPersonInfo &person);
+
 #endif
@@ -0,0 +1,419 @@
+// ============================================================================
+// File: CPersonLoader.cpp
+// ============================================================================
+// Implimentation file for the class CPersonLoader.  Loading is a three stage
+// pipeline:
+//
+//   reader thread  --chunks-->  parser threads  --batches-->  final stage
+//
+// The reader cuts the file into chunks that end on a line boundary, the
+// parsers turn each chunk into a batch of CPersonInfo records, and the final
+// stage (the calling thread) puts the batches back in file order.  Both
+// queues are bounded, so a slow stage stalls the ones before it instead of
+// letting chunks pile up in memory.
+// ============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <thread>
+#include <iostream>
+using namespace std;
+#include "CPersonLoader.h"
+#include "CBoundedQueue.h"
+
+// a piece of the file that ends on a line boundary
+struct CChunk
+{
+	long long	m_sequence;
+	string		m_bytes;
+};
+
+// the records parsed from one chunk
+struct CPersonBatch
+{
+	long long			m_sequence;
+	vector<CPersonInfo>	m_people;
+};
+
+// ==== IsSpace ===============================================================
+//
+// Checks if a character separates tokens.
+//
+// Input:
+//		ch	[IN] - the character to test
+//
+// Output:
+//		bool  -  True if ch is whitespace
+//
+// ============================================================================
+static inline bool IsSpace(char ch)
+{
+	return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' ||
+		   ch == '\v' || ch == '\f';
+}
+
+
+
+// ==== SkipSpace =============================================================
+//
+// Advances past any whitespace.
+//
+// Input:
+//		pos	[IN] - the current position
+//		end	[IN] - one past the last character
+//
+// Output:
+//		const char*  -  the first non-whitespace position (or end)
+//
+// ============================================================================
+static inline const char* SkipSpace(const char *pos, const char *end)
+{
+	while (pos < end && IsSpace(*pos))
+	{
+		++pos;
+	}
+	return pos;
+}
+
+
+
+// ==== ReadToken =============================================================
+//
+// Reads one whitespace delimited token.
+//
+// Input:
+//		pos		[IN/OUT] - the current position, advanced past the token
+//		end		[IN] - one past the last character
+//		token	[OUT] - receives the token
+//
+// Output:
+//		bool  -  True if a token was read
+//
+// ============================================================================
+static inline bool ReadToken(const char *&pos, const char *end, string &token)
+{
+	pos = SkipSpace(pos, end);
+	const char *start = pos;
+	while (pos < end && !IsSpace(*pos))
+	{
+		++pos;
+	}
+	token.assign(start, pos - start);
+
+	return pos != start;
+}
+
+
+
+// ==== ReadNumber ============================================================
+//
+// Reads one number that starts at pos, never looking at or past end (so a
+// chunk need not be followed by a delimiter or NUL).
+//
+// Input:
+//		pos		[IN/OUT] - the current position, advanced past the number
+//		end		[IN] - one past the last character
+//		value	[OUT] - receives the number
+//
+// Output:
+//		bool  -  True if a number was read
+//
+// ============================================================================
+template <typename NumberType>
+static inline bool ReadNumber(const char *&pos, const char *end,
+							  NumberType &value)
+{
+	pos = SkipSpace(pos, end);
+	if (pos < end && *pos == '+')
+	{
+		++pos;
+	}
+
+	from_chars_result result = from_chars(pos, end, value);
+	if (result.ec != errc() || result.ptr == pos)
+	{
+		return false;
+	}
+	pos = result.ptr;
+
+	return true;
+}
+
+
+
+// =========================================================================
+//      Constructors and Destructor
+// =========================================================================
+
+// ==== Type Constructor ======================================================
+//
+// Initializes the pipeline settings.
+//
+// Input:
+//		parserThreads	[IN] - number of parser threads, 0 for one per core
+//		chunkBytes		[IN] - approximate size of each chunk
+//		queueDepth		[IN] - chunks/batches allowed in flight per queue
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CPersonLoader::CPersonLoader(int parserThreads, int chunkBytes, int queueDepth)
+						: m_parserThreads(parserThreads),
+						  m_chunkBytes(chunkBytes), m_queueDepth(queueDepth)
+{
+	if (m_parserThreads <= 0)
+	{
+		m_parserThreads = (int)thread::hardware_concurrency();
+		if (m_parserThreads <= 0)
+		{
+			m_parserThreads = 1;
+		}
+	}
+	if (m_chunkBytes < 4096)
+	{
+		m_chunkBytes = 4096;
+	}
+	if (m_queueDepth < 2)
+	{
+		m_queueDepth = 2;
+	}
+}
+
+
+
+// =========================================================================
+//      Member Functions
+// =========================================================================
+
+// ==== LoadFile ==============================================================
+//
+// Reads every record of a whitespace separated file using a reader thread,
+// m_parserThreads parser threads and the calling thread as the final stage.
+//
+// Input:
+//		path		[IN] - the file to read
+//		people		[OUT] - receives the records in file order
+//		skipHeader	[IN] - true if the first line is a header
+//
+// Output:
+//		bool  -  True if the file was read, false if it could not be opened
+//
+// ============================================================================
+bool CPersonLoader::LoadFile(const string &path, vector<CPersonInfo> &people,
+							 bool skipHeader) const
+{
+	ifstream inFile(path.c_str(), ios::in | ios::binary);
+	if (inFile.fail())
+	{
+		return false;
+	}
+
+	CBoundedQueue<CChunk> chunkQueue(m_queueDepth);
+	CBoundedQueue<CPersonBatch> batchQueue(m_queueDepth);
+	atomic<int> parsersLeft(m_parserThreads);
+	int chunkBytes = m_chunkBytes;
+
+	//stage 1: cut the file into chunks that end on a newline
+	thread reader([&inFile, &chunkQueue, chunkBytes, skipHeader]()
+	{
+		string carry;
+		long long sequence = 0;
+		bool headerPending = skipHeader;
+		vector<char> block(chunkBytes);
+
+		while (inFile)
+		{
+			inFile.read(&block[0], chunkBytes);
+			streamsize got = inFile.gcount();
+			if (got <= 0)
+			{
+				break;
+			}
+			carry.append(&block[0], (size_t)got);
+
+			if (headerPending)
+			{
+				size_t newline = carry.find('\n');
+				if (newline == string::npos)
+				{
+					continue;
+				}
+				carry.erase(0, newline + 1);
+				headerPending = false;
+			}
+
+			//hand over everything up to the last complete line
+			size_t lastNewline = carry.rfind('\n');
+			if (lastNewline == string::npos)
+			{
+				continue;
+			}
+
+			CChunk chunk;
+			chunk.m_sequence = sequence++;
+			chunk.m_bytes = carry.substr(0, lastNewline + 1);
+			carry.erase(0, lastNewline + 1);
+			chunkQueue.Push(chunk);
+		}
+
+		//the last line may not end with a newline
+		if (!headerPending && !carry.empty())
+		{
+			CChunk chunk;
+			chunk.m_sequence = sequence++;
+			chunk.m_bytes.swap(carry);
+			chunkQueue.Push(chunk);
+		}
+
+		chunkQueue.Close();
+	});
+
+	//stage 2: parse chunks into batches
+	vector<thread> parsers;
+	for (int index = 0; index < m_parserThreads; ++index)
+	{
+		parsers.push_back(thread([&chunkQueue, &batchQueue, &parsersLeft]()
+		{
+			CChunk chunk;
+			while (chunkQueue.Pop(chunk))
+			{
+				CPersonBatch batch;
+				batch.m_sequence = chunk.m_sequence;
+				const char *begin = chunk.m_bytes.data();
+				ParseChunk(begin, begin + chunk.m_bytes.size(), batch.m_people);
+				batchQueue.Push(batch);
+			}
+
+			//the last parser out closes the batch queue
+			if (parsersLeft.fetch_sub(1) == 1)
+			{
+				batchQueue.Close();
+			}
+		}));
+	}
+
+	//stage 3: put the batches back in file order
+	vector< vector<CPersonInfo> > ordered;
+	size_t total = 0;
+	CPersonBatch batch;
+	while (batchQueue.Pop(batch))
+	{
+		if ((size_t)batch.m_sequence >= ordered.size())
+		{
+			ordered.resize((size_t)batch.m_sequence + 1);
+		}
+		total += batch.m_people.size();
+		ordered[(size_t)batch.m_sequence].swap(batch.m_people);
+		batch.m_people.clear();
+	}
+
+	reader.join();
+	for (size_t index = 0; index < parsers.size(); ++index)
+	{
+		parsers[index].join();
+	}
+
+	people.clear();
+	people.reserve(total);
+	for (size_t index = 0; index < ordered.size(); ++index)
+	{
+		for (size_t item = 0; item < ordered[index].size(); ++item)
+		{
+			people.push_back(std::move(ordered[index][item]));
+		}
+		vector<CPersonInfo>().swap(ordered[index]);
+	}
+
+	return true;
+}
+
+
+
+// ==== LoadTree ==============================================================
+//
+// Reads every record of a file, sorts the records by age and bulk-builds a
+// balanced tree from them, so no record goes through Add (and the rebuild
+// that Add performs).
+//
+// Input:
+//		path		[IN] - the file to read
+//		tree		[OUT] - the tree to replace with the file's records
+//		skipHeader	[IN] - true if the first line is a header
+//
+// Output:
+//		bool  -  True if the file was read, false if it could not be opened
+//
+// ============================================================================
+bool CPersonLoader::LoadTree(const string &path, CBST<CPersonInfo> &tree,
+							 bool skipHeader) const
+{
+	vector<CPersonInfo> people;
+	if (!LoadFile(path, people, skipHeader))
+	{
+		return false;
+	}
+
+	//stable so that equal ages keep their file order
+	stable_sort(people.begin(), people.end(),
+				[](const CPersonInfo &lhs, const CPersonInfo &rhs)
+				{
+					return lhs.GetAge() < rhs.GetAge();
+				});
+
+	tree.BuildFromSortedArray(people.empty() ? nullptr : &people[0],
+							  (int)people.size());
+
+	return true;
+}
+
+
+
+// ==== ParseChunk ============================================================
+//
+// Parses every complete record in [begin, end) without going through the
+// stream operators.  The range must end on a record boundary; nothing at or
+// past end is read, so it need not be followed by a delimiter or NUL.
+//
+// Input:
+//		begin	[IN] - first character of the chunk
+//		end		[IN] - one past the last character of the chunk
+//		people	[OUT] - receives the parsed records
+//
+// Output:
+//		int  -  the number of records parsed
+//
+// ============================================================================
+int CPersonLoader::ParseChunk(const char *begin, const char *end,
+							  vector<CPersonInfo> &people)
+{
+	const char *pos = begin;
+	string fname;
+	string lname;
+	int count = 0;
+
+	for (;;)
+	{
+		if (!ReadToken(pos, end, fname) || !ReadToken(pos, end, lname))
+		{
+			break;
+		}
+
+		int age;
+		double checking;
+		double savings;
+		if (!ReadNumber(pos, end, age) || !ReadNumber(pos, end, checking)
+			|| !ReadNumber(pos, end, savings))
+		{
+			break;
+		}
+
+		people.push_back(CPersonInfo(fname, lname, age, checking,
+									 savings));
+		++count;
+	}
+
+	return count;
+}
@@ -0,0 +1,76 @@
+// ============================================================================
+// File: CPersonLoader.h
+// ============================================================================
+// Header file for the class CPersonLoader
+// ============================================================================
+
+#ifndef CPERSONLOADER_HEADER
+#define CPERSONLOADER_HEADER
+
+#include <string>
+#include <vector>
+#include "CPersonInfo.h"
+#include "CBST.h"
+
+class CPersonLoader
+{
+public:
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Initializes the pipeline settings.  A parserThreads value of 0 uses one
+       parser per hardware thread.
+    @param parserThreads: Number of threads that turn chunks into records.
+    @param chunkBytes: Approximate size of each chunk handed to a parser.
+    @param queueDepth: Number of chunks/batches allowed in flight per queue.
+                       Together with chunkBytes this caps the memory used by
+                       the pipeline regardless of the size of the input. */
+   CPersonLoader(int parserThreads = 0, int chunkBytes = 1 << 20,
+                 int queueDepth = 8);
+
+   /** Compiler provided copy constructor and destructor will suffice.  */
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Reads every record of a whitespace separated file (first, last, age,
+       checking, savings) using a reader thread, parserThreads parser threads
+       and the calling thread as the final stage.
+    @param path: The file to read.
+    @param people: Receives the records in file order.
+    @param skipHeader: True if the first line of the file is a header.
+    @return  True if the file was read, or false if it could not be opened. */
+   bool LoadFile(const std::string &path, std::vector<CPersonInfo> &people,
+                 bool skipHeader = true) const;
+
+   /** Reads every record of a file like LoadFile, sorts them by age and
+       bulk-builds a balanced tree from the sorted records.
+    @param path: The file to read.
+    @param tree: The tree to replace with the file's records.
+    @param skipHeader: True if the first line of the file is a header.
+    @return  True if the file was read, or false if it could not be opened. */
+   bool LoadTree(const std::string &path, CBST<CPersonInfo> &tree,
+                 bool skipHeader = true) const;
+
+   /** Parses every complete record in [begin, end) and appends it to people.
+       The range must end on a record boundary.
+    @param begin: First character of the chunk.
+    @param end: One past the last character of the chunk.
+    @param people: Receives the parsed records.
+    @return  The number of records parsed. */
+   static int ParseChunk(const char *begin, const char *end,
+                         std::vector<CPersonInfo> &people);
+
+private:
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   int   m_parserThreads;
+   int   m_chunkBytes;
+   int   m_queueDepth;
+}; // end CPersonLoader
+
+#endif
@@ -0,0 +1,219 @@
+// ============================================================================
+// File: CShardedBST.h
+// ============================================================================
+// Header file for the class CShardedBST (CBSTs partitioned by key range)
+// ============================================================================
+
+#ifndef CSHARDEDBST_HEADER
+#define CSHARDEDBST_HEADER
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "CBST.h"
+
+// A shard is split once it holds this many times its share of the items...
+const int SHARD_SPLIT_FACTOR = 2;
+// ...and never while it holds fewer items than this
+const int SHARD_MIN_SPLIT = 256;
+
+template<class ItemType>
+class CShardedBST
+{
+public:
+   typedef typename CBST<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates one shard holding every key.  It is split as items arrive.
+    @param targetShards: The number of shards to spread the items over (0
+                         picks four per hardware thread). */
+   CShardedBST(int targetShards = 0);
+
+   /** Creates count + 1 shards split at the given keys: shard i holds the
+       keys in [separators[i - 1], separators[i]).  The target number of
+       shards is count + 1.
+    @param separators: Strictly increasing keys.
+    @param count: The number of separators. */
+   CShardedBST(const KeyType separators[], int count);
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Adds an item to the shard that owns its key, holding only that
+       shard's lock, so writers to different shards run in parallel and
+       share no written cache line.  A shard that grows past
+       SHARD_SPLIT_FACTOR times its share of the items (the item count at
+       the last Rebalance over the target number of shards) is split.
+    @param newEntry: The item to add.
+    @return  True. */
+   bool Add(const ItemType &newEntry);
+
+   /** Removes an item from the shard that owns its key.  A shard that,
+       with a neighbor, falls below half a share is merged with it.
+    @param anEntry: The item to remove.
+    @return  True if the item was removed, or false if it was not found. */
+   bool Remove(const ItemType &anEntry);
+
+   /** Checks if an item is in the tree.  Lookups share the shard's lock,
+       so readers of one shard run in parallel.
+    @param anEntry: The item to look for.
+    @return  True if found, or false if it is not. */
+   bool Contains(const ItemType &anEntry) const;
+
+   /** Visits, in key order, every item whose key lies in [low, high],
+       walking each shard that overlaps the range under its own lock.  Each
+       shard is seen consistently, but writes to later shards may land
+       while earlier ones are being visited.
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void RangeTraverse(const KeyType &low, const KeyType &high,
+                      void Visit(ItemType &item)) const;
+
+   /** Visits every item in key order (see RangeTraverse).
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void InorderTraverse(void Visit(ItemType &item)) const;
+
+   /** Returns the number of items in all shards, summed over the shards'
+       own counts.
+    @param Nothing.
+    @return  The number of items. */
+   int GetNumberOfNodes() const;
+
+   /** Returns the number of shards.
+    @param Nothing.
+    @return  The number of shards. */
+   int GetShardCount() const;
+
+   /** Splits every shard that is much larger than its share and merges
+       every pair of neighbors that together hold under half a share, using
+       CBST::Split and CBST::Join so no item is copied.  Add and Remove call
+       it when a shard crosses a threshold; it can also be called directly.
+       A shard whose items all share one key cannot be split; it is not
+       tried again until it doubles in size.
+    @param Nothing.
+    @return  Nothing. */
+   void Rebalance();
+
+   /** Removes every item, keeping the shards.
+    @param Nothing.
+    @return  Nothing. */
+   void Clear();
+
+private:
+   // =========================================================================
+   //      Private Types
+   // =========================================================================
+
+   // Each shard is allocated on its own cache lines, so writers to two
+   // shards never touch the same line.
+   struct alignas(64) CShard
+   {
+      CShard() : m_size(0), m_splitFloor(0) {}
+
+      CBST<ItemType>             m_tree;
+      mutable std::shared_mutex  m_mutex;       // Shared by lookups
+      std::atomic<int>           m_size;        // Changed under m_mutex
+      int                        m_splitFloor;  // No split at or below
+   };
+
+   // Which shard owns which keys.  A table is never changed once published;
+   // Rebalance publishes a new one instead.
+   struct CRouteTable
+   {
+      std::vector<KeyType>    m_separators;
+      std::vector<CShard*>    m_shards;
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Finds the shard that owns a key in a routing table.
+    @param table: The routing table.
+    @param key: The key to route.
+    @return  The index of the shard. */
+   static int Route(const CRouteTable &table, const KeyType &key);
+
+   /** Finds and locks the shard that owns a key without taking any lock
+       shared by all shards: the current table is read, the shard it names
+       is locked, and if a Rebalance published a new table in between, the
+       lock is dropped and the lookup retried.
+    @param key: The key to route.
+    @param lock: Receives the lock on the shard (a std::unique_lock or
+                 std::shared_lock of std::shared_mutex).
+    @param index: Receives the index of the shard in the table.
+    @return  The table the shard was found in. */
+   template<class LockType>
+   const CRouteTable* LockShard(const KeyType &key, LockType &lock,
+                                int &index) const;
+
+   /** Locks a shard for Rebalance unless it is already locked.
+    @param shard: The shard to lock.
+    @param locks: The locks Rebalance holds.
+    @return  Nothing. */
+   static void LockForRebalance(CShard &shard,
+                 std::vector<std::unique_lock<std::shared_mutex> > &locks);
+
+   /** Returns an empty shard, reusing one a merge left behind if there is
+       one.  The caller holds m_rebalanceMutex.
+    @param Nothing.
+    @return  The shard. */
+   CShard* NewShard();
+
+   /** Makes a routing table current.  The caller holds m_rebalanceMutex.
+    @param table: The table to publish.
+    @return  Nothing. */
+   void Publish(std::unique_ptr<CRouteTable> table);
+
+   /** Returns the size above which a shard is split.
+    @param Nothing.
+    @return  The split threshold. */
+   int SplitThreshold() const;
+
+   /** Checks if a shard is large enough to split.
+    @param shard: The shard.
+    @param size: The number of items in the shard.
+    @return  True if it should be split. */
+   bool ShouldSplit(const CShard &shard, int size) const;
+
+   /** Checks if two neighboring shards are small enough to merge.
+    @param size: The number of items in the two shards.
+    @return  True if they should be merged. */
+   bool ShouldMerge(int size) const;
+
+   /** Copying would copy the locks; disallow it. */
+   CShardedBST(const CShardedBST<ItemType> &tree);
+   CShardedBST<ItemType>& operator=(const CShardedBST<ItemType> &rhs);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   // Add, Remove and Contains read m_table and lock one shard, so the only
+   // lines they share are read-mostly.  Rebalance, Clear and the traversals
+   // hold m_rebalanceMutex.  A lookup may still be reading a table or shard
+   // that Rebalance has replaced, so replaced tables are kept until the
+   // container is destroyed (one key and one pointer per shard each), and
+   // shards emptied by a merge are kept for reuse.
+   std::atomic<const CRouteTable*>        m_table;
+   std::atomic<int>                       m_countEstimate; // At last Rebalance
+   int                                    m_targetShards;
+   mutable std::mutex                     m_rebalanceMutex;
+   std::vector<std::unique_ptr<CRouteTable> > m_tables;    // Newest last
+   std::vector<std::unique_ptr<CShard> >  m_shardPool;     // Every shard
+   std::vector<CShard*>                   m_freeShards;    // Merged away
+}; // end CShardedBST
+
+#include "CShardedBST.tpp"
+
+#endif  // CSHARDEDBST_HEADER
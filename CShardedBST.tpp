@@ -0,0 +1,655 @@
+// ============================================================================
+// File: CShardedBST.tpp
+// ============================================================================
+// This is the implementation file for the class CShardedBST.  Each shard is
+// an independent CBST owning one key range; a sorted separator array routes
+// a key to its shard with one binary search.  Because every CBST::Add
+// rebuilds its tree, the cost of a write is also proportional to the size
+// of its shard rather than of the whole container.
+//
+// The separators and shard pointers form a routing table that is never
+// changed once published.  A writer reads the current table without a lock,
+// locks the shard it names, and checks that the table is still current;
+// Rebalance publishes its new table while it still holds the locks of every
+// shard it changed, so a writer that gets one of those locks afterwards
+// sees the new table and routes again.
+// ============================================================================
+
+#include <algorithm>
+#include "CShardedBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates one shard holding every key.
+//
+// Input:
+//		targetShards	[IN] - the number of shards to aim for (0 = four per
+//							   hardware thread)
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CShardedBST<ItemType>::CShardedBST(int targetShards) : m_table(nullptr),
+											m_countEstimate(0),
+											m_targetShards(targetShards)
+{
+	if (m_targetShards <= 0)
+	{
+		m_targetShards = 4 * std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	std::unique_ptr<CRouteTable> table(new CRouteTable);
+	table->m_shards.push_back(NewShard());
+	Publish(std::move(table));
+}
+
+
+
+// ==== Type Constructor ======================================================
+//
+// Creates count + 1 shards split at the given keys.
+//
+// Input:
+//		separators	[IN] - strictly increasing keys
+//		count		[IN] - the number of separators
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CShardedBST<ItemType>::CShardedBST(const KeyType separators[], int count) :
+											m_table(nullptr),
+											m_countEstimate(0),
+											m_targetShards(count + 1)
+{
+	std::unique_ptr<CRouteTable> table(new CRouteTable);
+	table->m_separators.assign(separators, separators + count);
+	for (int index = 0; index <= count; ++index)
+	{
+		table->m_shards.push_back(NewShard());
+	}
+	Publish(std::move(table));
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Adds an item to the shard that owns its key.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True
+//
+// ============================================================================
+template<class ItemType>
+bool CShardedBST<ItemType>::Add(const ItemType &newEntry)
+{
+	bool split;
+	{
+		std::unique_lock<std::shared_mutex> lock;
+		int index;
+		const CRouteTable *table;
+		table = LockShard(CKeyTraits<ItemType>::GetKey(newEntry), lock, index);
+
+		CShard &shard = *table->m_shards[index];
+		shard.m_tree.Add(newEntry);
+		int size = ++shard.m_size;
+		split = ShouldSplit(shard, size);
+	}
+
+	if (split)
+	{
+		Rebalance();
+	}
+
+	return true;
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Removes an item from the shard that owns its key.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if the item was removed, false if it was not found
+//
+// ============================================================================
+template<class ItemType>
+bool CShardedBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	bool removed;
+	bool merge = false;
+	{
+		std::unique_lock<std::shared_mutex> lock;
+		int index;
+		const CRouteTable *table;
+		table = LockShard(CKeyTraits<ItemType>::GetKey(anEntry), lock, index);
+
+		CShard &shard = *table->m_shards[index];
+		const std::vector<CShard*> &shards = table->m_shards;
+		removed = shard.m_tree.Remove(anEntry);
+
+		//merge once this shard and its smaller neighbor would together pass
+		//the test Rebalance applies; the neighbors' counts are only read
+		//once this shard alone is small enough
+		int size = removed ? --shard.m_size : 0;
+		if (removed && ShouldMerge(size))
+		{
+			int neighbor = -1;
+			if (index > 0)
+			{
+				neighbor = shards[index - 1]->m_size;
+			}
+			if (index + 1 < (int)shards.size() &&
+				(neighbor < 0 || shards[index + 1]->m_size < neighbor))
+			{
+				neighbor = shards[index + 1]->m_size;
+			}
+			merge = (neighbor >= 0 && ShouldMerge(size + neighbor));
+		}
+	}
+
+	if (merge)
+	{
+		Rebalance();
+	}
+
+	return removed;
+}
+
+
+
+// ==== Contains ==============================================================
+//
+// Checks if an item is in the tree.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		bool  -  True if found, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CShardedBST<ItemType>::Contains(const ItemType &anEntry) const
+{
+	std::shared_lock<std::shared_mutex> lock;
+	int index;
+	const CRouteTable *table;
+	table = LockShard(CKeyTraits<ItemType>::GetKey(anEntry), lock, index);
+
+	return table->m_shards[index]->m_tree.Contains(anEntry);
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// Visits, in key order, every item whose key lies in [low, high].  Visit
+// may change the items, so each shard is locked exclusively.  Holding
+// m_rebalanceMutex keeps the table from changing during the walk.
+//
+// Input:
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::RangeTraverse(const KeyType &low,
+										  const KeyType &high,
+										  void Visit(ItemType &item)) const
+{
+	if (high < low)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> rebalance(m_rebalanceMutex);
+	const CRouteTable &table = *m_table.load(std::memory_order_acquire);
+	int last = Route(table, high);
+
+	for (int index = Route(table, low); index <= last; ++index)
+	{
+		const CShard &shard = *table.m_shards[index];
+		std::lock_guard<std::shared_mutex> lock(shard.m_mutex);
+		shard.m_tree.RangeTraverse(low, high, Visit);
+	}
+}
+
+
+
+// ==== InorderTraverse =======================================================
+//
+// Visits every item in key order.
+//
+// Input:
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::InorderTraverse(void Visit(ItemType &item)) const
+{
+	std::lock_guard<std::mutex> rebalance(m_rebalanceMutex);
+	const CRouteTable &table = *m_table.load(std::memory_order_acquire);
+
+	for (size_t index = 0; index < table.m_shards.size(); ++index)
+	{
+		const CShard &shard = *table.m_shards[index];
+		std::lock_guard<std::shared_mutex> lock(shard.m_mutex);
+		shard.m_tree.InorderTraverse(Visit);
+	}
+}
+
+
+
+// ==== GetNumberOfNodes ======================================================
+//
+// Returns the number of items in all shards.  Holding m_rebalanceMutex
+// keeps a merge from moving items between the shards being summed.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of items
+//
+// ============================================================================
+template<class ItemType>
+int CShardedBST<ItemType>::GetNumberOfNodes() const
+{
+	std::lock_guard<std::mutex> rebalance(m_rebalanceMutex);
+	const CRouteTable &table = *m_table.load(std::memory_order_acquire);
+
+	int count = 0;
+	for (size_t index = 0; index < table.m_shards.size(); ++index)
+	{
+		count += table.m_shards[index]->m_size;
+	}
+
+	return count;
+}
+
+
+
+// ==== GetShardCount =========================================================
+//
+// Returns the number of shards.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of shards
+//
+// ============================================================================
+template<class ItemType>
+int CShardedBST<ItemType>::GetShardCount() const
+{
+	return (int)m_table.load(std::memory_order_acquire)->m_shards.size();
+}
+
+
+
+// ==== Rebalance =============================================================
+//
+// Splits shards much larger than their share at their median, found at the
+// root once the shard is rebalanced, and merges neighbors that together
+// hold less than half a share.  When the median is also the smallest key,
+// the shard is split above it instead, at the next larger key; when there
+// is none, every key is the same and the shard is left until it doubles.
+//
+// The changes are made to a copy of the routing table.  Every shard that is
+// changed stays locked until the copy is published, so no writer can use a
+// changed shard through the old table.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::Rebalance()
+{
+	std::lock_guard<std::mutex> rebalance(m_rebalanceMutex);
+	std::vector<std::unique_lock<std::shared_mutex> > locks;
+	std::unique_ptr<CRouteTable> table(
+					new CRouteTable(*m_table.load(std::memory_order_acquire)));
+	std::vector<KeyType> &separators = table->m_separators;
+	std::vector<CShard*> &shards = table->m_shards;
+	bool changed = false;
+
+	//the thresholds below are shares of the count as of now
+	int count = 0;
+	for (size_t index = 0; index < shards.size(); ++index)
+	{
+		count += shards[index]->m_size;
+	}
+	m_countEstimate = count;
+
+	//split large shards
+	for (size_t index = 0; index < shards.size(); ++index)
+	{
+		CShard &shard = *shards[index];
+		if (!ShouldSplit(shard, shard.m_size))
+		{
+			continue;
+		}
+		LockForRebalance(shard, locks);
+
+		shard.m_tree.Rebalance();
+		KeyType splitKey = CKeyTraits<ItemType>::GetKey(
+											shard.m_tree.GetRootData());
+		if (!(CKeyTraits<ItemType>::GetKey(*shard.m_tree.Min()) < splitKey))
+		{
+			//nothing lies below the median, so split above it
+			const ItemType *abovePtr = shard.m_tree.Successor(splitKey);
+			if (abovePtr == nullptr)
+			{
+				//every key is the median; there is nothing to split at
+				shard.m_splitFloor = 2 * shard.m_size;
+				continue;
+			}
+			splitKey = CKeyTraits<ItemType>::GetKey(*abovePtr);
+		}
+
+		CShard *upper = NewShard();
+		LockForRebalance(*upper, locks);
+		CBST<ItemType> lower;
+		shard.m_tree.Split(splitKey, lower, upper->m_tree);
+		shard.m_tree.Join(lower);
+		shard.m_tree.Rebalance();
+		upper->m_tree.Rebalance();
+
+		upper->m_size = upper->m_tree.GetNumberOfNodes();
+		shard.m_size = shard.m_size - upper->m_size;
+		shard.m_splitFloor = 0;
+		separators.insert(separators.begin() + index, splitKey);
+		shards.insert(shards.begin() + index + 1, upper);
+		changed = true;
+		--index;	//the lower half may still be too large
+	}
+
+	//merge small neighbors
+	for (size_t index = 0; index + 1 < shards.size(); )
+	{
+		CShard &shard = *shards[index];
+		CShard &next = *shards[index + 1];
+		if (!ShouldMerge(shard.m_size + next.m_size))
+		{
+			++index;
+			continue;
+		}
+		LockForRebalance(shard, locks);
+		LockForRebalance(next, locks);
+
+		shard.m_tree.Join(next.m_tree);
+		shard.m_tree.Rebalance();
+		shard.m_size = shard.m_size + next.m_size;
+		shard.m_splitFloor = 0;
+		next.m_size = 0;
+		next.m_splitFloor = 0;
+		m_freeShards.push_back(&next);
+		separators.erase(separators.begin() + index);
+		shards.erase(shards.begin() + index + 1);
+		changed = true;
+	}
+
+	if (changed)
+	{
+		Publish(std::move(table));
+	}
+}
+
+
+
+// ==== Clear =================================================================
+//
+// Removes every item, keeping the shards.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::Clear()
+{
+	std::lock_guard<std::mutex> rebalance(m_rebalanceMutex);
+	const CRouteTable &table = *m_table.load(std::memory_order_acquire);
+
+	for (size_t index = 0; index < table.m_shards.size(); ++index)
+	{
+		CShard &shard = *table.m_shards[index];
+		std::lock_guard<std::shared_mutex> lock(shard.m_mutex);
+		shard.m_tree.Clear();
+		shard.m_size = 0;
+		shard.m_splitFloor = 0;
+	}
+	m_countEstimate = 0;
+}
+
+
+
+// ==== Route =================================================================
+//
+// Finds the shard that owns a key: the number of separators not greater
+// than it.
+//
+// Input:
+//		table	[IN] - the routing table
+//		key		[IN] - the key to route
+//
+// Output:
+//		int  -  the index of the shard
+//
+// ============================================================================
+template<class ItemType>
+int CShardedBST<ItemType>::Route(const CRouteTable &table, const KeyType &key)
+{
+	return (int)(std::upper_bound(table.m_separators.begin(),
+								  table.m_separators.end(), key) -
+				 table.m_separators.begin());
+}
+
+
+
+// ==== LockShard =============================================================
+//
+// Finds and locks the shard that owns a key.  The table is read without a
+// lock; if it is no longer current once the shard is locked, a Rebalance
+// may have moved the key, so the lock is dropped and the key routed again.
+//
+// Input:
+//		key		[IN] - the key to route
+//		lock	[OUT] - receives the lock on the shard
+//		index	[OUT] - receives the index of the shard in the table
+//
+// Output:
+//		const CRouteTable*  -  the table the shard was found in
+//
+// ============================================================================
+template<class ItemType>
+template<class LockType>
+const typename CShardedBST<ItemType>::CRouteTable*
+CShardedBST<ItemType>::LockShard(const KeyType &key, LockType &lock,
+								 int &index) const
+{
+	for (;;)
+	{
+		const CRouteTable *table = m_table.load(std::memory_order_acquire);
+		index = Route(*table, key);
+
+		LockType shardLock(table->m_shards[index]->m_mutex);
+		if (m_table.load(std::memory_order_acquire) == table)
+		{
+			lock = std::move(shardLock);
+			return table;
+		}
+	}
+}
+
+
+
+// ==== LockForRebalance ======================================================
+//
+// Locks a shard for Rebalance unless it is already locked.
+//
+// Input:
+//		shard	[IN] - the shard to lock
+//		locks	[IN/OUT] - the locks Rebalance holds
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::LockForRebalance(CShard &shard,
+				std::vector<std::unique_lock<std::shared_mutex> > &locks)
+{
+	for (size_t index = 0; index < locks.size(); ++index)
+	{
+		if (locks[index].mutex() == &shard.m_mutex)
+		{
+			return;
+		}
+	}
+
+	locks.push_back(std::unique_lock<std::shared_mutex>(shard.m_mutex));
+}
+
+
+
+// ==== NewShard ==============================================================
+//
+// Returns an empty shard, reusing one a merge left behind if there is one.
+// A writer still holding an old table may lock a reused shard, but it then
+// finds the table has changed and routes again.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CShard*  -  the shard
+//
+// ============================================================================
+template<class ItemType>
+typename CShardedBST<ItemType>::CShard* CShardedBST<ItemType>::NewShard()
+{
+	if (!m_freeShards.empty())
+	{
+		CShard *shard = m_freeShards.back();
+		m_freeShards.pop_back();
+		return shard;
+	}
+
+	m_shardPool.push_back(std::unique_ptr<CShard>(new CShard));
+
+	return m_shardPool.back().get();
+}
+
+
+
+// ==== Publish ===============================================================
+//
+// Makes a routing table current.  The table it replaces is kept, since a
+// writer may still be routing through it.
+//
+// Input:
+//		table	[IN] - the table to publish
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CShardedBST<ItemType>::Publish(std::unique_ptr<CRouteTable> table)
+{
+	m_tables.push_back(std::move(table));
+	m_table.store(m_tables.back().get(), std::memory_order_release);
+}
+
+
+
+// ==== SplitThreshold ========================================================
+//
+// Returns the size above which a shard is split.  It is a share of the
+// count at the last Rebalance, which writers only read, rather than of a
+// count every Add would have to update.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the split threshold
+//
+// ============================================================================
+template<class ItemType>
+int CShardedBST<ItemType>::SplitThreshold() const
+{
+	return std::max(SHARD_MIN_SPLIT,
+					SHARD_SPLIT_FACTOR * (m_countEstimate / m_targetShards));
+}
+
+
+
+// ==== ShouldSplit ===========================================================
+//
+// Checks if a shard is larger than the split threshold and than the size
+// at which it last failed to split.
+//
+// Input:
+//		shard	[IN] - the shard
+//		size	[IN] - the number of items in the shard
+//
+// Output:
+//		bool  -  True if it should be split
+//
+// ============================================================================
+template<class ItemType>
+bool CShardedBST<ItemType>::ShouldSplit(const CShard &shard, int size) const
+{
+	return size > SplitThreshold() && size > shard.m_splitFloor;
+}
+
+
+
+// ==== ShouldMerge ===========================================================
+//
+// Checks if two neighboring shards together hold less than half a share
+// of the count at the last Rebalance.
+//
+// Input:
+//		size	[IN] - the number of items in the two shards
+//
+// Output:
+//		bool  -  True if they should be merged
+//
+// ============================================================================
+template<class ItemType>
+bool CShardedBST<ItemType>::ShouldMerge(int size) const
+{
+	return 2 * size * m_targetShards < m_countEstimate;
+}
@@ -0,0 +1,205 @@
+// ============================================================================
+// File: CSnapshotIO.cpp
+// ============================================================================
+// Implimentation file for the non-templated snapshot encoding helpers
+// ============================================================================
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+using namespace std;
+#include "CSnapshotIO.h"
+
+
+
+// ==== SnapshotWrite =========================================================
+//
+// Appends a string as a 32-bit length followed by its characters.
+//
+// Input:
+//		buffer	[IN/OUT] - the buffer to append to
+//		value	[IN] - the string to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void SnapshotWrite(string &buffer, const string &value)
+{
+	unsigned int length = (unsigned int)value.size();
+
+	SnapshotWrite(buffer, length);
+	buffer.append(value);
+}
+
+
+
+// ==== SnapshotRead ==========================================================
+//
+// Reads a length-prefixed string and advances pos past it.
+//
+// Input:
+//		pos		[IN/OUT] - the current read position
+//		end		[IN] - one past the last readable byte
+//		value	[OUT] - receives the string
+//
+// Output:
+//		bool  -  True if the string was read, false if the buffer was short
+//
+// ============================================================================
+bool SnapshotRead(const char *&pos, const char *end, string &value)
+{
+	unsigned int length;
+
+	if (!SnapshotRead(pos, end, length) || (size_t)(end - pos) < length)
+	{
+		return false;
+	}
+
+	value.assign(pos, length);
+	pos += length;
+
+	return true;
+}
+
+
+
+// ==== SnapshotChecksum ======================================================
+//
+// Computes the 64-bit FNV-1a checksum of a block of bytes.
+//
+// Input:
+//		data	[IN] - the first byte of the block
+//		size	[IN] - the number of bytes in the block
+//
+// Output:
+//		unsigned long long  -  the checksum
+//
+// ============================================================================
+unsigned long long SnapshotChecksum(const char *data, size_t size)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (size_t index = 0; index < size; ++index)
+	{
+		hash = hash ^ (unsigned char)data[index];
+		hash = hash * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+
+
+// ==== SnapshotReadFile ======================================================
+//
+// Reads a whole file into a buffer with a single read.
+//
+// Input:
+//		path	[IN] - the file to read
+//		buffer	[OUT] - receives the contents of the file
+//
+// Output:
+//		bool  -  True if the file was read, false if it could not be
+//
+// ============================================================================
+bool SnapshotReadFile(const string &path, string &buffer)
+{
+	ifstream inFile(path.c_str(), ios::in | ios::binary | ios::ate);
+	if (inFile.fail())
+	{
+		return false;
+	}
+
+	streamoff size = inFile.tellg();
+	if (size < 0)
+	{
+		return false;
+	}
+
+	buffer.resize((size_t)size);
+	inFile.seekg(0, ios::beg);
+	if (size > 0)
+	{
+		inFile.read(&buffer[0], size);
+	}
+
+	return !inFile.fail();
+}
+
+
+
+// ==== SnapshotWriteFile =====================================================
+//
+// Writes a buffer to path by writing a temporary file next to it and renaming
+// it over path.  The temporary file is flushed to disk before the rename and
+// the directory after it, so once this returns true the new contents survive
+// a crash, and a crash part way through leaves the old contents in place.
+//
+// Input:
+//		path	[IN] - the file to replace
+//		buffer	[IN] - the bytes to write
+//
+// Output:
+//		bool  -  True if the file was written, false if it could not be
+//
+// ============================================================================
+bool SnapshotWriteFile(const string &path, const string &buffer)
+{
+	string tempPath = path + ".tmp";
+
+	int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	const char *pos = buffer.data();
+	size_t left = buffer.size();
+	while (left > 0)
+	{
+		ssize_t written = write(fd, pos, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			close(fd);
+			unlink(tempPath.c_str());
+			return false;
+		}
+		pos += written;
+		left -= (size_t)written;
+	}
+
+	if (fsync(fd) != 0)
+	{
+		close(fd);
+		unlink(tempPath.c_str());
+		return false;
+	}
+	close(fd);
+
+	if (rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		unlink(tempPath.c_str());
+		return false;
+	}
+
+	//make the rename itself durable
+	size_t slash = path.rfind('/');
+	string directory = (slash == string::npos) ? "." :
+					   (slash == 0 ? "/" : path.substr(0, slash));
+	int dirFd = open(directory.c_str(), O_RDONLY);
+	if (dirFd >= 0)
+	{
+		fsync(dirFd);
+		close(dirFd);
+	}
+
+	return true;
+}
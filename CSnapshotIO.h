@@ -0,0 +1,88 @@
+// ============================================================================
+// File: CSnapshotIO.h
+// ============================================================================
+// Header file for the snapshot encoding helpers.  These append values to a
+// byte buffer and read them back in the compact binary form used by the
+// CBST snapshot (Save/Load).  Numbers are stored in host byte order, so a
+// snapshot is meant to be reloaded on the same kind of machine.
+//
+// A class that wants to be stored in a snapshot provides its own
+// SnapshotWrite/SnapshotRead overloads next to its stream operators (see
+// CPersonInfo.h).
+// ============================================================================
+
+#ifndef CSNAPSHOTIO_HEADER
+#define CSNAPSHOTIO_HEADER
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+// =========================================================================
+//      Snapshot file constants
+// =========================================================================
+
+// first 8 bytes of every CBST snapshot file
+const char           SNAPSHOT_MAGIC[] = "CBSTSNAP";
+const size_t         SNAPSHOT_MAGIC_SIZE = 8;
+
+// bumped whenever the layout of the snapshot changes
+const unsigned int   SNAPSHOT_VERSION = 1;
+
+// =========================================================================
+//      Snapshot encoding functions
+// =========================================================================
+
+/** Appends the raw bytes of a number to the buffer.
+    @param buffer: The buffer to append to.
+    @param value: The number to append.
+    @return  Nothing. */
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value>::type
+SnapshotWrite(std::string &buffer, const ItemType &value);
+
+/** Reads a number written by SnapshotWrite and advances pos past it.
+    @param pos: The current read position.
+    @param end: One past the last readable byte.
+    @param value: Receives the number.
+    @return  True if the number was read, or false if the buffer was short. */
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value, bool>::type
+SnapshotRead(const char *&pos, const char *end, ItemType &value);
+
+/** Appends a string as a 32-bit length followed by its characters.
+    @param buffer: The buffer to append to.
+    @param value: The string to append.
+    @return  Nothing. */
+void SnapshotWrite(std::string &buffer, const std::string &value);
+
+/** Reads a length-prefixed string and advances pos past it.
+    @param pos: The current read position.
+    @param end: One past the last readable byte.
+    @param value: Receives the string.
+    @return  True if the string was read, or false if the buffer was short. */
+bool SnapshotRead(const char *&pos, const char *end, std::string &value);
+
+/** Computes the 64-bit FNV-1a checksum of a block of bytes.
+    @param data: The first byte of the block.
+    @param size: The number of bytes in the block.
+    @return  The checksum. */
+unsigned long long SnapshotChecksum(const char *data, size_t size);
+
+/** Reads a whole file into a buffer.
+    @param path: The file to read.
+    @param buffer: Receives the contents of the file.
+    @return  True if the file was read, or false if it could not be. */
+bool SnapshotReadFile(const std::string &path, std::string &buffer);
+
+/** Writes a buffer to path by writing a temporary file next to it, flushing
+    it to disk and renaming it over path, so a crash never leaves a half
+    written file and a successful return means the data is durable.
+    @param path: The file to replace.
+    @param buffer: The bytes to write.
+    @return  True if the file was written, or false if it could not be. */
+bool SnapshotWriteFile(const std::string &path, const std::string &buffer);
+
+#include "CSnapshotIO.tpp"
+
+#endif  // CSNAPSHOTIO_HEADER
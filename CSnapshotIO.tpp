@@ -0,0 +1,60 @@
+// ============================================================================
+// File: CSnapshotIO.tpp
+// ============================================================================
+// This is the implementation file for the templated snapshot encoding
+// helpers
+// ============================================================================
+
+#include <cstring>
+#include "CSnapshotIO.h"
+
+
+
+// ==== SnapshotWrite =========================================================
+//
+// Appends the raw bytes of a number to the buffer.
+//
+// Input:
+//		buffer	[IN/OUT] - the buffer to append to
+//		value	[IN] - the number to append
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value>::type
+SnapshotWrite(std::string &buffer, const ItemType &value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(ItemType));
+}
+
+
+
+// ==== SnapshotRead ==========================================================
+//
+// Reads a number written by SnapshotWrite and advances pos past it.
+//
+// Input:
+//		pos		[IN/OUT] - the current read position
+//		end		[IN] - one past the last readable byte
+//		value	[OUT] - receives the number
+//
+// Output:
+//		bool  -  True if the number was read, false if the buffer was short
+//
+// ============================================================================
+template<class ItemType>
+typename std::enable_if<std::is_arithmetic<ItemType>::value, bool>::type
+SnapshotRead(const char *&pos, const char *end, ItemType &value)
+{
+	if ((size_t)(end - pos) < sizeof(ItemType))
+	{
+		return false;
+	}
+
+	std::memcpy(&value, pos, sizeof(ItemType));
+	pos += sizeof(ItemType);
+
+	return true;
+}
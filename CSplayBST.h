@@ -0,0 +1,104 @@
+// ============================================================================
+// File: CSplayBST.h
+// ============================================================================
+// Header file for the class CSplayBST (CBST that moves accessed keys up)
+// ============================================================================
+
+#ifndef CSPLAYBST_HEADER
+#define CSPLAYBST_HEADER
+
+#include "CBST.h"
+
+template<class ItemType>
+class CSplayBST : public CBST<ItemType>
+{
+public:
+   typedef typename CBST<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree.
+    @param splayDepth: Items found at this depth or shallower are left where
+                       they are (the root is depth 0).  0 splays on every
+                       access like a classic splay tree; a few levels stop
+                       the hottest items from being rotated back and forth,
+                       which saves most of the writes lookups would make. */
+   CSplayBST(int splayDepth = 0);
+
+   /** Copy constructor. */
+   CSplayBST(const CSplayBST<ItemType> &tree);
+
+   /** Destructor. */
+   virtual ~CSplayBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Splays the key of newEntry to the root and puts the new item above
+       it, in amortized O(log n) and without the rebuild CBST::Add does.
+    @param newEntry: The item to add.
+    @return  True. */
+   bool Add(const ItemType &newEntry) override;
+
+   /** Splays the key of anEntry to the root and removes the item, joining
+       its subtrees by splaying the largest key of the left one.
+    @param anEntry: The item to remove.
+    @return  True if the item was removed, or false if it was not found. */
+   bool Remove(const ItemType &anEntry) override;
+
+   /** Checks if an item is in the tree.  Unlike CBST::Contains, it moves
+       the item's key toward the root (see FindOrNull).
+    @post  The items are unchanged, but the shape of the tree may not be.
+    @param anEntry: The item to look for.
+    @return  True if found, or false if it is not. */
+   bool Contains(const ItemType &anEntry) const noexcept override;
+
+   /** Finds an item, moving its key toward the root.  Contains, GetEntry
+       and TryGetEntry all go through it.  Although const, lookups relink
+       the nodes, so a traversal must not look items up, and a CSplayBST
+       must not be read from several threads at once, even through const
+       functions, without a lock that excludes every other access.
+    @post  The items are unchanged, but the shape of the tree may not be.
+    @param anEntry: The item to look for.
+    @return  A pointer to the item in the tree, or nullptr if it is not
+             found. */
+   const ItemType* FindOrNull(const ItemType &anEntry) const
+                                                   noexcept override;
+
+   /** Overloaded assignment operator.
+    @param rhs: A const CSplayBST reference object.
+    @return  CSplayBST reference object. */
+   CSplayBST<ItemType>& operator=(const CSplayBST<ItemType> &rhs);
+
+private:
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Top-down splay: restructures a subtree so the node with key, or the
+       last node on its search path, becomes its root.
+    @param treePtr: The root of the subtree.
+    @param key: The key to splay.
+    @return  The new root of the subtree. */
+   CBinaryNode<ItemType>* Splay(CBinaryNode<ItemType> *treePtr,
+                                const KeyType &key) const;
+
+   /** Finds a node with key and splays it to the root if it is deeper
+       than m_splayDepth.  Called by the const lookups, hence const.
+    @param key: The key that was accessed.
+    @return  A node with the key, or nullptr if there is none. */
+   CBinaryNode<ItemType>* Access(const KeyType &key) const;
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   int   m_splayDepth;   // Deepest access that is left in place
+}; // end CSplayBST
+
+#include "CSplayBST.tpp"
+
+#endif  // CSPLAYBST_HEADER
@@ -0,0 +1,442 @@
+// ============================================================================
+// File: CSplayBST.tpp
+// ============================================================================
+// This is the implementation file for the class CSplayBST.  Instead of
+// rebuilding a perfectly balanced tree after every change, the tree is
+// restructured by splaying on every access, so keys that are used often
+// stay near the root.  Splaying is done top-down (Sleator and Tarjan), in
+// one pass with no parent pointers and no recursion.
+// ============================================================================
+
+#include "CSplayBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree.
+//
+// Input:
+//		splayDepth	[IN] - accesses at this depth or shallower do not splay
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplayBST<ItemType>::CSplayBST(int splayDepth) : m_splayDepth(splayDepth)
+{
+
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the tree and its splay depth.
+//
+// Input:
+//		tree	[IN] - a const CSplayBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplayBST<ItemType>::CSplayBST(const CSplayBST<ItemType> &tree) :
+					CBST<ItemType>(tree), m_splayDepth(tree.m_splayDepth)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST releases.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplayBST<ItemType>::~CSplayBST()
+{
+
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Splays the new key to the root and makes the new node the root above it.
+// Items with an equal key end up on either side, as they can in CBST.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True
+//
+// ============================================================================
+template<class ItemType>
+bool CSplayBST<ItemType>::Add(const ItemType &newEntry)
+{
+	BST_TIME(TREE_OP_ADD);
+
+	CBinaryNode<ItemType> *newNode = new CBinaryNode<ItemType>(newEntry);
+	KeyType key = CKeyTraits<ItemType>::GetKey(newEntry);
+	CBinaryNode<ItemType> *rootPtr = Splay(this->GetRootPtr(), key);
+
+	if (rootPtr != nullptr)
+	{
+		if (key < CKeyTraits<ItemType>::GetKey(rootPtr->GetItemRef()))
+		{
+			newNode->SetLeftChildPtr(rootPtr->GetLeftChildPtr());
+			newNode->SetRightChildPtr(rootPtr);
+			rootPtr->SetLeftChildPtr(nullptr);
+		}
+		else
+		{
+			newNode->SetRightChildPtr(rootPtr->GetRightChildPtr());
+			newNode->SetLeftChildPtr(rootPtr);
+			rootPtr->SetRightChildPtr(nullptr);
+		}
+	}
+
+	this->SetRootPtr(newNode);
+	this->OnContentsChanged();
+
+	return true;
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Splays the key to the root and removes the item.  When the root holds a
+// different item with the same key, CBST::RemoveValue finds it instead.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if the item was removed, false if it was not found
+//
+// ============================================================================
+template<class ItemType>
+bool CSplayBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	BST_TIME(TREE_OP_REMOVE);
+
+	KeyType key = CKeyTraits<ItemType>::GetKey(anEntry);
+	CBinaryNode<ItemType> *rootPtr = Splay(this->GetRootPtr(), key);
+
+	if (rootPtr == nullptr)
+	{
+		return false;
+	}
+
+	bool success = false;
+	if (rootPtr->GetItemRef() == anEntry)
+	{
+		CBinaryNode<ItemType> *leftPtr = rootPtr->GetLeftChildPtr();
+		CBinaryNode<ItemType> *rightPtr = rootPtr->GetRightChildPtr();
+		delete rootPtr;
+
+		//every key on the left is at most key, so splaying key there brings
+		//up its largest node; only items with an equal key can remain on
+		//its right, and the right subtree goes below the last of them
+		if (leftPtr == nullptr)
+		{
+			rootPtr = rightPtr;
+		}
+		else
+		{
+			rootPtr = Splay(leftPtr, key);
+			CBinaryNode<ItemType> *lastPtr = rootPtr;
+			while (lastPtr->GetRightChildPtr() != nullptr)
+			{
+				lastPtr = lastPtr->GetRightChildPtr();
+			}
+			lastPtr->SetRightChildPtr(rightPtr);
+		}
+		success = true;
+	}
+	else
+	{
+		rootPtr = this->RemoveValue(rootPtr, anEntry, success);
+	}
+
+	this->SetRootPtr(rootPtr);
+	if (success)
+	{
+		this->OnContentsChanged();
+	}
+
+	return success;
+}
+
+
+
+// ==== Contains ==============================================================
+//
+// Checks if an item is in the tree, moving its key toward the root.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		bool  -  True if found, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CSplayBST<ItemType>::Contains(const ItemType &anEntry) const noexcept
+{
+	return FindOrNull(anEntry) != nullptr;
+}
+
+
+
+// ==== FindOrNull ============================================================
+//
+// Finds an item, moving its key toward the root.  When the node with the
+// key holds a different item, the other items with that key are searched.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		const ItemType*  -  the item in the tree, or nullptr if not found
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplayBST<ItemType>::FindOrNull(const ItemType &anEntry)
+															const noexcept
+{
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<ItemType> *nodePtr = Access(CKeyTraits<ItemType>::GetKey(
+																anEntry));
+	if (nodePtr != nullptr && !(nodePtr->GetItemRef() == anEntry))
+	{
+		nodePtr = this->FindNode(this->GetRootPtr(), anEntry);
+	}
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &nodePtr->GetItemRef();
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the items of rhs and its splay depth.
+//
+// Input:
+//		rhs	[IN] - A const CSplayBST reference object.
+//
+// Output:
+//		CSplayBST - a CSplayBST reference object
+//
+// ============================================================================
+template<class ItemType>
+CSplayBST<ItemType>& CSplayBST<ItemType>::operator=(
+											const CSplayBST<ItemType> &rhs)
+{
+	CBST<ItemType>::operator=(rhs);
+	m_splayDepth = rhs.m_splayDepth;
+
+	return *this;
+}
+
+
+
+// ==== Splay =================================================================
+//
+// Top-down splay.  Walking down from the root, nodes passed on the left are
+// hung off the right end of a "left tree" and nodes passed on the right off
+// the left end of a "right tree"; two steps the same way rotate first
+// (zig-zig).  The node where the walk stops becomes the root over both.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//		key		[IN] - the key to splay
+//
+// Output:
+//		CBinaryNode  -  the new root of the subtree
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CSplayBST<ItemType>::Splay(
+				CBinaryNode<ItemType> *treePtr, const KeyType &key) const
+{
+	if (treePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	//the left tree holds the nodes passed on the left, the right tree those
+	//passed on the right; both start empty, so no dummy node (and no item)
+	//has to be made to anchor them
+	CBinaryNode<ItemType> *leftTree = nullptr;
+	CBinaryNode<ItemType> *leftTreeMax = nullptr;
+	CBinaryNode<ItemType> *rightTree = nullptr;
+	CBinaryNode<ItemType> *rightTreeMin = nullptr;
+
+	for (;;)
+	{
+		if (key < CKeyTraits<ItemType>::GetKey(treePtr->GetItemRef()))
+		{
+			CBinaryNode<ItemType> *childPtr = treePtr->GetLeftChildPtr();
+			if (childPtr == nullptr)
+			{
+				break;
+			}
+			if (key < CKeyTraits<ItemType>::GetKey(childPtr->GetItemRef()))
+			{
+				//zig-zig: rotate right
+				BST_COUNT(TREE_ROTATIONS, 1);
+				treePtr->SetLeftChildPtr(childPtr->GetRightChildPtr());
+				childPtr->SetRightChildPtr(treePtr);
+				treePtr = childPtr;
+				if (treePtr->GetLeftChildPtr() == nullptr)
+				{
+					break;
+				}
+			}
+			if (rightTreeMin == nullptr)
+			{
+				rightTree = treePtr;
+			}
+			else
+			{
+				rightTreeMin->SetLeftChildPtr(treePtr);
+			}
+			rightTreeMin = treePtr;
+			treePtr = treePtr->GetLeftChildPtr();
+		}
+		else if (CKeyTraits<ItemType>::GetKey(treePtr->GetItemRef()) < key)
+		{
+			CBinaryNode<ItemType> *childPtr = treePtr->GetRightChildPtr();
+			if (childPtr == nullptr)
+			{
+				break;
+			}
+			if (CKeyTraits<ItemType>::GetKey(childPtr->GetItemRef()) < key)
+			{
+				//zag-zag: rotate left
+				BST_COUNT(TREE_ROTATIONS, 1);
+				treePtr->SetRightChildPtr(childPtr->GetLeftChildPtr());
+				childPtr->SetLeftChildPtr(treePtr);
+				treePtr = childPtr;
+				if (treePtr->GetRightChildPtr() == nullptr)
+				{
+					break;
+				}
+			}
+			if (leftTreeMax == nullptr)
+			{
+				leftTree = treePtr;
+			}
+			else
+			{
+				leftTreeMax->SetRightChildPtr(treePtr);
+			}
+			leftTreeMax = treePtr;
+			treePtr = treePtr->GetRightChildPtr();
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	//reassemble
+	if (leftTreeMax != nullptr)
+	{
+		leftTreeMax->SetRightChildPtr(treePtr->GetLeftChildPtr());
+		treePtr->SetLeftChildPtr(leftTree);
+	}
+	if (rightTreeMin != nullptr)
+	{
+		rightTreeMin->SetLeftChildPtr(treePtr->GetRightChildPtr());
+		treePtr->SetRightChildPtr(rightTree);
+	}
+
+	return treePtr;
+}
+
+
+
+// ==== Access ================================================================
+//
+// Finds a node with key, splaying it to the root if the search goes deeper
+// than m_splayDepth.  The items do not change, only the shape, so
+// OnContentsChanged is not called.
+//
+// Input:
+//		key	[IN] - the key that was accessed
+//
+// Output:
+//		CBinaryNode  -  a node with the key, or nullptr if there is none
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<ItemType>* CSplayBST<ItemType>::Access(const KeyType &key) const
+{
+	CBinaryNode<ItemType> *nodePtr = this->GetRootPtr();
+	int depth = 0;
+
+	//the lookups are const for callers, but splaying is how this tree
+	//balances itself
+	CSplayBST<ItemType> *self = const_cast<CSplayBST<ItemType>*>(this);
+
+	if (m_splayDepth <= 0)
+	{
+		//every access splays, so there is no need to measure the depth first
+		nodePtr = Splay(nodePtr, key);
+		self->SetRootPtr(nodePtr);
+		if (nodePtr == nullptr ||
+			key < CKeyTraits<ItemType>::GetKey(nodePtr->GetItemRef()) ||
+			CKeyTraits<ItemType>::GetKey(nodePtr->GetItemRef()) < key)
+		{
+			return nullptr;
+		}
+		return nodePtr;
+	}
+
+	while (nodePtr != nullptr)
+	{
+		const KeyType &nodeKey = CKeyTraits<ItemType>::GetKey(
+													nodePtr->GetItemRef());
+		if (key < nodeKey)
+		{
+			nodePtr = nodePtr->GetLeftChildPtr();
+		}
+		else if (nodeKey < key)
+		{
+			nodePtr = nodePtr->GetRightChildPtr();
+		}
+		else
+		{
+			break;
+		}
+		++depth;
+	}
+
+	if (nodePtr == nullptr || depth <= m_splayDepth)
+	{
+		return nodePtr;
+	}
+
+	self->SetRootPtr(Splay(this->GetRootPtr(), key));
+
+	return this->GetRootPtr();
+}
@@ -0,0 +1,247 @@
+// ============================================================================
+// File: CSplitBST.h
+// ============================================================================
+// Header file for the class CSplitBST (CBST with keys in the nodes and the
+// records stored apart)
+// ============================================================================
+
+#ifndef CSPLITBST_HEADER
+#define CSPLITBST_HEADER
+
+#include <utility>
+#include <vector>
+#include "CBST.h"
+#include "CKeyHandle.h"
+
+template<class ItemType>
+class CSplitBST : private CBST< CKeyHandle<ItemType> >
+{
+public:
+   typedef CKeyHandle<ItemType> HandleType;
+   typedef typename CKeyTraits<ItemType>::KeyType KeyType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an empty tree. */
+   CSplitBST();
+
+   /** Copy constructor.  Handles are record numbers, so copying the nodes
+       and the record store copies the tree. */
+   CSplitBST(const CSplitBST<ItemType> &tree);
+
+   /** Destructor. */
+   virtual ~CSplitBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Stores an item in the record store and adds a handle to it.  Only the
+       handles are copied by the rebuild that follows.  If adding the handle
+       throws before it is linked, the record is freed again.
+    @param newEntry: The item to add.
+    @return  True. */
+   bool Add(const ItemType &newEntry);
+
+   /** Replaces the tree with the items of a sorted array in O(n), copying
+       them into the record store.
+    @param arr: The items, sorted by key.
+    @param count: The number of items in arr.
+    @return  Nothing. */
+   void BuildFromSortedArray(const ItemType arr[], int count);
+
+   /** Removes one item that is == anEntry and frees its record.
+    @param anEntry: The item to remove.
+    @return  True if an item was removed, or false if none matched. */
+   bool Remove(const ItemType &anEntry);
+
+   /** Removes every item and every record.
+    @param Nothing.
+    @return  Nothing. */
+   void Clear() override;
+
+   /** Checks if an item that is == anEntry is in the tree.
+    @param anEntry: The item to look for.
+    @return  True if found, or false if it is not. */
+   bool Contains(const ItemType &anEntry) const noexcept;
+
+   /** Finds an item without throwing.  The descent compares keys in the
+       nodes; a record is read only where the key matches.
+    @param anEntry: The item to look for.
+    @return  A pointer to the stored item, valid until the tree next
+             changes, or nullptr if it is not found. */
+   const ItemType* FindOrNull(const ItemType &anEntry) const noexcept;
+
+   /** Finds an item with a key without reading any other record.
+    @param key: The key to look for.
+    @return  A pointer to a stored item with the key, valid until the tree
+             next changes, or nullptr if no item has it. */
+   const ItemType* FindKey(const KeyType &key) const noexcept;
+
+   /** Finds an item with the greatest key not greater than key, comparing
+       keys only.
+    @param key: The key to search below.
+    @return  A pointer to the stored item, valid until the tree next
+             changes, or nullptr if every key is greater. */
+   const ItemType* Floor(const KeyType &key) const;
+
+   /** Finds an item with the least key not less than key.
+    @param key: The key to search above.
+    @return  A pointer to the stored item, or nullptr if every key is
+             less. */
+   const ItemType* Ceiling(const KeyType &key) const;
+
+   /** Finds an item with the greatest key less than key.
+    @param key: The key to search below.
+    @return  A pointer to the stored item, or nullptr if there is no
+             smaller key. */
+   const ItemType* Predecessor(const KeyType &key) const;
+
+   /** Finds an item with the least key greater than key.
+    @param key: The key to search above.
+    @return  A pointer to the stored item, or nullptr if there is no
+             greater key. */
+   const ItemType* Successor(const KeyType &key) const;
+
+   /** Finds the least item of the tree.
+    @param Nothing.
+    @return  A pointer to the stored item, or nullptr if it is empty. */
+   const ItemType* Min() const;
+
+   /** Finds the greatest item of the tree.
+    @param Nothing.
+    @return  A pointer to the stored item, or nullptr if it is empty. */
+   const ItemType* Max() const;
+
+   /** Removes and returns the least item of the tree and frees its record.
+    @param Nothing.
+    @return  The item removed.
+    @throw   PrecondViolatedExcept if the tree is empty. */
+   ItemType PopMin();
+
+   /** Removes and returns the greatest item of the tree and frees its
+       record.
+    @param Nothing.
+    @return  The item removed.
+    @throw   PrecondViolatedExcept if the tree is empty. */
+   ItemType PopMax();
+
+   /** Retrieves an entry from the tree.
+    @param anEntry: The item to look for.
+    @return  A copy of the stored item.
+    @throw   NotFoundException if the item is not in the tree. */
+   ItemType GetEntry(const ItemType &anEntry) const;
+
+   /** Visits every item in key order.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void InorderTraverse(void Visit(ItemType &item)) const;
+
+   /** Visits, in key order, every item whose key lies in [low, high].
+    @param low: The smallest key to visit.
+    @param high: The largest key to visit.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void RangeTraverse(const KeyType &low, const KeyType &high,
+                      void Visit(ItemType &item)) const;
+
+   /** Writes every item, in key order, to a set of columns in one pass,
+       after clearing them.
+    @param columns: Any object with Clear() and Append(const ItemType&).
+    @return  Nothing. */
+   template<class ColumnsType>
+   void ExportColumns(ColumnsType &columns) const;
+
+   /** Writes every item, in key order, to a dump in one pass and flushes
+       the writer.
+    @param writer: The writer to write to.
+    @param format: DUMP_TEXT or DUMP_CSV.
+    @return  True if every write succeeded. */
+   bool Dump(CDumpWriter &writer, CDumpFormat format) const;
+
+   /** Reports the shape of the tree of handles, counting the record store
+       as payload heap memory.
+    @param Nothing.
+    @return  A CTreeStats describing the tree. */
+   CTreeStats Stats() const override;
+
+   /** Overloaded assignment operator.
+    @param rhs: A const CSplitBST reference object.
+    @return  CSplitBST reference object. */
+   CSplitBST<ItemType>& operator=(const CSplitBST<ItemType> &rhs);
+
+   // =========================================================================
+   //      Forwarded Member Functions
+   // =========================================================================
+
+   // The tree of handles is a private base, so nothing outside this class
+   // can add, drop, change or read a handle without the record store (nor
+   // reach them through a CBST reference).  These only measure or reshape
+   // the tree of handles.
+   using CBST<HandleType>::IsEmpty;
+   using CBST<HandleType>::GetHeight;
+   using CBST<HandleType>::GetNumberOfNodes;
+   using CBST<HandleType>::ContainsBatch;
+   using CBST<HandleType>::Rebalance;
+
+private:
+   /** Columns for handles that append the records the handles name, so the
+       export of the tree of handles writes records. */
+   template<class ColumnsType>
+   struct CRecordColumns
+   {
+      void Clear() { m_columns.Clear(); }
+      void Append(const HandleType &handle)
+      {
+         m_columns.Append(m_records[handle.m_record]);
+      }
+
+      ColumnsType                  &m_columns;
+      const std::vector<ItemType>  &m_records;
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Returns the stored item a handle names.
+    @param handlePtr: The handle, or nullptr.
+    @return  A pointer to the stored item, or nullptr if handlePtr is. */
+   const ItemType* GetRecordPtr(const HandleType *handlePtr) const;
+
+   /** Takes the record out of the store and frees it.
+    @param handle: The handle of a record just removed from the tree.
+    @return  The item the record held. */
+   ItemType ReleaseRecord(const HandleType &handle);
+
+   /** Finds the node whose handle names a record == anEntry.
+    @param treePtr: The root of the subtree to search.
+    @param key: The key of anEntry.
+    @param anEntry: The item to find.
+    @return  The node, or nullptr if no record matches. */
+   CBinaryNode<HandleType>* FindRecordNode(CBinaryNode<HandleType> *treePtr,
+                                           const KeyType &key,
+                                           const ItemType &anEntry) const;
+
+   /** Recursive helper for the item traversals.
+    @param treePtr: The root of the subtree.
+    @param low: The smallest key to visit, or nullptr for no bound.
+    @param high: The largest key to visit, or nullptr for no bound.
+    @param Visit: A function that processes an ItemType object.
+    @return  Nothing. */
+   void ItemHelper(CBinaryNode<HandleType> *treePtr, const KeyType *low,
+                   const KeyType *high, void Visit(ItemType &item)) const;
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   std::vector<ItemType>      m_records;       // Indexed by record number
+   std::vector<unsigned int>  m_freeRecords;   // Numbers of removed records
+}; // end CSplitBST
+
+#include "CSplitBST.tpp"
+
+#endif  // CSPLITBST_HEADER
@@ -0,0 +1,804 @@
+// ============================================================================
+// File: CSplitBST.tpp
+// ============================================================================
+// This is the implementation file for the class CSplitBST.  The tree holds
+// one CKeyHandle per item: the item's key and the number of its record in
+// m_records.  A descent reads only the small handle nodes, and an add or
+// remove rebuilds the tree by copying handles rather than whole records.
+// A record is read only when its key matches, or when it is returned.
+// ============================================================================
+
+#include "CSplitBST.h"
+
+
+
+// ==== Default Constructor ===================================================
+//
+// Creates an empty tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplitBST<ItemType>::CSplitBST()
+{
+
+}
+
+
+
+// ==== Copy Constructor ======================================================
+//
+// Copies the handles and the record store of the tree.
+//
+// Input:
+//		tree	[IN] - a const CSplitBST
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplitBST<ItemType>::CSplitBST(const CSplitBST<ItemType> &tree) :
+											CBST<HandleType>(tree),
+											m_records(tree.m_records),
+											m_freeRecords(tree.m_freeRecords)
+{
+
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Nothing to release beyond what CBST and the record store release.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CSplitBST<ItemType>::~CSplitBST()
+{
+
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Stores an item in a free record, or a new one, and adds a handle to it.
+// If adding the handle throws before it is linked, the record is freed.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True
+//
+// ============================================================================
+template<class ItemType>
+bool CSplitBST<ItemType>::Add(const ItemType &newEntry)
+{
+	unsigned int record;
+	bool fresh = m_freeRecords.empty();
+
+	if (fresh)
+	{
+		record = (unsigned int)m_records.size();
+		m_records.push_back(newEntry);
+	}
+	else
+	{
+		record = m_freeRecords.back();
+		m_records[record] = newEntry;
+		m_freeRecords.pop_back();
+	}
+
+	HandleType handle(newEntry, record);
+	try
+	{
+		return CBST<HandleType>::Add(handle);
+	}
+	catch (...)
+	{
+		//give the record back unless its handle was linked before the throw
+		if (CBST<HandleType>::FindOrNull(handle) == nullptr)
+		{
+			if (fresh)
+			{
+				m_records.pop_back();
+			}
+			else
+			{
+				m_freeRecords.push_back(record);	//fits: it was just popped
+			}
+		}
+		throw;
+	}
+}
+
+
+
+// ==== BuildFromSortedArray ==================================================
+//
+// Replaces the tree with the items of a sorted array.  The handles name
+// records 0 to count - 1, so the record store is replaced outright and no
+// record is left free.
+//
+// Input:
+//		arr		[IN] - the items, sorted by key
+//		count	[IN] - the number of items in arr
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CSplitBST<ItemType>::BuildFromSortedArray(const ItemType arr[],
+											   int count)
+{
+	std::vector<HandleType> handles;
+	handles.reserve(count);
+	for (int index = 0; index < count; ++index)
+	{
+		handles.push_back(HandleType(arr[index], (unsigned int)index));
+	}
+
+	CBST<HandleType>::BuildFromSortedArray(handles.data(), count);
+	m_records.assign(arr, arr + count);
+	m_freeRecords.clear();
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Removes the handle of one item that is == anEntry and frees its record.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if an item was removed, false if none matched
+//
+// ============================================================================
+template<class ItemType>
+bool CSplitBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	CBinaryNode<HandleType> *nodePtr;
+	nodePtr = FindRecordNode(this->GetRootPtr(),
+							 CKeyTraits<ItemType>::GetKey(anEntry), anEntry);
+
+	if (nodePtr == nullptr)
+	{
+		return false;
+	}
+
+	HandleType handle = nodePtr->GetItem();
+	CBST<HandleType>::Remove(handle);
+
+	//the record is reset so that it holds on to nothing while it is free
+	m_records[handle.m_record] = ItemType();
+	m_freeRecords.push_back(handle.m_record);
+
+	return true;
+}
+
+
+
+// ==== Clear =================================================================
+//
+// Removes every handle and every record.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CSplitBST<ItemType>::Clear()
+{
+	CBST<HandleType>::Clear();
+	m_records.clear();
+	m_freeRecords.clear();
+}
+
+
+
+// ==== Contains ==============================================================
+//
+// Checks if an item that is == anEntry is in the tree.  This function calls
+// FindOrNull.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		bool  -  True if found, false if it is not
+//
+// ============================================================================
+template<class ItemType>
+bool CSplitBST<ItemType>::Contains(const ItemType &anEntry) const noexcept
+{
+	return FindOrNull(anEntry) != nullptr;
+}
+
+
+
+// ==== FindOrNull ============================================================
+//
+// Finds an item without throwing.  This function calls FindRecordNode.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if it is not found
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::FindOrNull(const ItemType &anEntry) const
+																	noexcept
+{
+	BST_TIME(TREE_OP_FIND);
+
+	CBinaryNode<HandleType> *nodePtr;
+	nodePtr = FindRecordNode(this->GetRootPtr(),
+							 CKeyTraits<ItemType>::GetKey(anEntry), anEntry);
+
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &m_records[nodePtr->GetItemRef().m_record];
+}
+
+
+
+// ==== FindKey ===============================================================
+//
+// Finds an item with a key by comparing keys only; the record of the first
+// node with the key is the only one read.
+//
+// Input:
+//		key	[IN] - the key to look for
+//
+// Output:
+//		const ItemType*  -  a stored item with the key, or nullptr
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::FindKey(const KeyType &key) const
+																	noexcept
+{
+	BST_TIME(TREE_OP_FIND);
+
+	unsigned long long visited = 0;
+	CBinaryNode<HandleType> *nodePtr = this->GetRootPtr();
+
+	while (nodePtr != nullptr)
+	{
+		++visited;
+		const KeyType &nodeKey = nodePtr->GetItemRef().m_key;
+		if (key < nodeKey)
+		{
+			nodePtr = nodePtr->GetLeftChildPtr();
+		}
+		else if (nodeKey < key)
+		{
+			nodePtr = nodePtr->GetRightChildPtr();
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	BST_COUNT(TREE_NODES_VISITED, visited);
+
+	if (nodePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &m_records[nodePtr->GetItemRef().m_record];
+}
+
+
+
+// ==== Floor =================================================================
+//
+// Finds an item with the greatest key not greater than key, comparing keys
+// only; the record found is the only one read.
+//
+// Input:
+//		key	[IN] - the key to search from
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if every key is greater
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Floor(const KeyType &key) const
+{
+	return GetRecordPtr(CBST<HandleType>::Floor(key));
+}
+
+
+
+// ==== Ceiling ===============================================================
+//
+// Finds an item with the least key not less than key.
+//
+// Input:
+//		key	[IN] - the key to search from
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if every key is less
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Ceiling(const KeyType &key) const
+{
+	return GetRecordPtr(CBST<HandleType>::Ceiling(key));
+}
+
+
+
+// ==== Predecessor ===========================================================
+//
+// Finds an item with the greatest key less than key.
+//
+// Input:
+//		key	[IN] - the key to search from
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if no key is less
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Predecessor(const KeyType &key) const
+{
+	return GetRecordPtr(CBST<HandleType>::Predecessor(key));
+}
+
+
+
+// ==== Successor =============================================================
+//
+// Finds an item with the least key greater than key.
+//
+// Input:
+//		key	[IN] - the key to search from
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if no key is greater
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Successor(const KeyType &key) const
+{
+	return GetRecordPtr(CBST<HandleType>::Successor(key));
+}
+
+
+
+// ==== Min ===================================================================
+//
+// Finds the least item of the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if the tree is empty
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Min() const
+{
+	return GetRecordPtr(CBST<HandleType>::Min());
+}
+
+
+
+// ==== Max ===================================================================
+//
+// Finds the greatest item of the tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if the tree is empty
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::Max() const
+{
+	return GetRecordPtr(CBST<HandleType>::Max());
+}
+
+
+
+// ==== PopMin ================================================================
+//
+// Removes the least handle of the tree and takes its record out of the
+// store.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		ItemType  -  the item removed
+//
+// ============================================================================
+template<class ItemType>
+ItemType CSplitBST<ItemType>::PopMin()
+{
+	return ReleaseRecord(CBST<HandleType>::PopMin());
+}
+
+
+
+// ==== PopMax ================================================================
+//
+// Removes the greatest handle of the tree and takes its record out of the
+// store.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		ItemType  -  the item removed
+//
+// ============================================================================
+template<class ItemType>
+ItemType CSplitBST<ItemType>::PopMax()
+{
+	return ReleaseRecord(CBST<HandleType>::PopMax());
+}
+
+
+
+// ==== GetEntry ==============================================================
+//
+// Retrieves an entry from the tree.  This function calls FindOrNull.
+//
+// Input:
+//		anEntry	[IN] - the item to look for
+//
+// Output:
+//		ItemType  -  a copy of the stored item
+//
+// ============================================================================
+template<class ItemType>
+ItemType CSplitBST<ItemType>::GetEntry(const ItemType &anEntry) const
+{
+	const ItemType *entryPtr = FindOrNull(anEntry);
+	if (entryPtr == nullptr)
+	{
+		NotFoundException exception("Entry does not exhist");
+		throw exception;
+	}
+
+	return *entryPtr;
+}
+
+
+
+// ==== InorderTraverse =======================================================
+//
+// Visits every item in key order.
+//
+// Input:
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CSplitBST<ItemType>::InorderTraverse(void Visit(ItemType &item)) const
+{
+	ItemHelper(this->GetRootPtr(), nullptr, nullptr, Visit);
+}
+
+
+
+// ==== RangeTraverse =========================================================
+//
+// Visits, in key order, every item whose key lies in [low, high].
+//
+// Input:
+//		low		[IN] - the smallest key to visit
+//		high	[IN] - the largest key to visit
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CSplitBST<ItemType>::RangeTraverse(const KeyType &low,
+										const KeyType &high,
+										void Visit(ItemType &item)) const
+{
+	ItemHelper(this->GetRootPtr(), &low, &high, Visit);
+}
+
+
+
+// ==== ExportColumns =========================================================
+//
+// Writes every item, in key order, to a set of columns in one pass.  The
+// export of the tree of handles writes through CRecordColumns, which
+// swaps each handle for the record it names.
+//
+// Input:
+//		columns	[OUT] - cleared, then receives the items in key order
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+template<class ColumnsType>
+void CSplitBST<ItemType>::ExportColumns(ColumnsType &columns) const
+{
+	CRecordColumns<ColumnsType> recordColumns = {columns, m_records};
+
+	CBST<HandleType>::ExportColumns(recordColumns);
+}
+
+
+
+// ==== Dump ==================================================================
+//
+// Writes every item, in key order, to a dump in one pass.
+//
+// Input:
+//		writer	[IN/OUT] - the writer to write to
+//		format	[IN] - DUMP_TEXT or DUMP_CSV
+//
+// Output:
+//		bool  -  True if every write succeeded
+//
+// ============================================================================
+template<class ItemType>
+bool CSplitBST<ItemType>::Dump(CDumpWriter &writer, CDumpFormat format) const
+{
+	CDumpColumns dumpColumns = {writer, format};
+	ExportColumns(dumpColumns);
+
+	return writer.Flush();
+}
+
+
+
+// ==== Stats =================================================================
+//
+// Reports the shape of the tree of handles.  The nodes hold no records, so
+// the record store and whatever its records own are counted as payload
+// heap memory.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CTreeStats  -  the report
+//
+// ============================================================================
+template<class ItemType>
+CTreeStats CSplitBST<ItemType>::Stats() const
+{
+	CTreeStats stats = CBST<HandleType>::Stats();
+
+	stats.m_payloadHeapBytes += m_records.capacity() * sizeof(ItemType) +
+								m_freeRecords.capacity() * sizeof(unsigned int);
+	for (size_t record = 0; record < m_records.size(); ++record)
+	{
+		stats.m_payloadHeapBytes += HeapBytes(m_records[record]);
+	}
+
+	return stats;
+}
+
+
+
+// ==== Overloaded Assignment Operator ========================================
+//
+// Copies the handles and the record store of rhs.
+//
+// Input:
+//		rhs	[IN] - A const CSplitBST reference object.
+//
+// Output:
+//		CSplitBST - a CSplitBST reference object
+//
+// ============================================================================
+template<class ItemType>
+CSplitBST<ItemType>& CSplitBST<ItemType>::operator=(
+											const CSplitBST<ItemType> &rhs)
+{
+	if (this != &rhs)
+	{
+		CBST<HandleType>::operator=(rhs);
+		m_records = rhs.m_records;
+		m_freeRecords = rhs.m_freeRecords;
+	}
+
+	return *this;
+}
+
+
+
+// ==== GetRecordPtr ==========================================================
+//
+// Returns the stored item a handle names.
+//
+// Input:
+//		handlePtr	[IN] - the handle, or nullptr
+//
+// Output:
+//		const ItemType*  -  the stored item, or nullptr if handlePtr is
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CSplitBST<ItemType>::GetRecordPtr(
+										const HandleType *handlePtr) const
+{
+	if (handlePtr == nullptr)
+	{
+		return nullptr;
+	}
+
+	return &m_records[handlePtr->m_record];
+}
+
+
+
+// ==== ReleaseRecord =========================================================
+//
+// Moves the item out of the record a handle names and frees the record.
+//
+// Input:
+//		handle	[IN] - the handle of a record just removed from the tree
+//
+// Output:
+//		ItemType  -  the item the record held
+//
+// ============================================================================
+template<class ItemType>
+ItemType CSplitBST<ItemType>::ReleaseRecord(const HandleType &handle)
+{
+	ItemType item = std::move(m_records[handle.m_record]);
+
+	//the record is reset so that it holds on to nothing while it is free
+	m_records[handle.m_record] = ItemType();
+	m_freeRecords.push_back(handle.m_record);
+
+	return item;
+}
+
+
+
+// ==== FindRecordNode ========================================================
+//
+// Finds the node whose handle names a record == anEntry.  Keys decide the
+// way down; where a key matches, the record is read, and since a rebuild
+// can leave equal keys on both sides of a node, both subtrees are searched
+// if the record differs.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree to search
+//		key		[IN] - the key of anEntry
+//		anEntry	[IN] - the item to find
+//
+// Output:
+//		CBinaryNode  -  the node, or nullptr if no record matches
+//
+// ============================================================================
+template<class ItemType>
+CBinaryNode<CKeyHandle<ItemType> >* CSplitBST<ItemType>::FindRecordNode(
+											CBinaryNode<HandleType> *treePtr,
+											const KeyType &key,
+											const ItemType &anEntry) const
+{
+	unsigned long long visited = 0;
+
+	while (treePtr != nullptr)
+	{
+		++visited;
+		const HandleType &handle = treePtr->GetItemRef();
+		if (key < handle.m_key)
+		{
+			treePtr = treePtr->GetLeftChildPtr();
+		}
+		else if (handle.m_key < key)
+		{
+			treePtr = treePtr->GetRightChildPtr();
+		}
+		else if (m_records[handle.m_record] == anEntry)
+		{
+			break;
+		}
+		else
+		{
+			//same key, different record: it may be on either side
+			CBinaryNode<HandleType> *foundPtr;
+			foundPtr = FindRecordNode(treePtr->GetLeftChildPtr(), key,
+									  anEntry);
+			if (foundPtr == nullptr)
+			{
+				foundPtr = FindRecordNode(treePtr->GetRightChildPtr(), key,
+										  anEntry);
+			}
+			treePtr = foundPtr;
+			break;
+		}
+	}
+
+	BST_COUNT(TREE_NODES_VISITED, visited);
+
+	return treePtr;
+}
+
+
+
+// ==== ItemHelper ============================================================
+//
+// Recursive helper for the item traversals.  Subtrees that cannot hold a
+// key in range are skipped.
+//
+// Input:
+//		treePtr	[IN] - the root of the subtree
+//		low		[IN] - the smallest key to visit, or nullptr
+//		high	[IN] - the largest key to visit, or nullptr
+//		Visit	[IN] - A function that processes an ItemType object.
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CSplitBST<ItemType>::ItemHelper(CBinaryNode<HandleType> *treePtr,
+									 const KeyType *low, const KeyType *high,
+									 void Visit(ItemType &item)) const
+{
+	if (treePtr == nullptr)
+	{
+		return;
+	}
+
+	const KeyType &key = treePtr->GetItemRef().m_key;
+	bool aboveLow = (low == nullptr) || !(key < *low);
+	bool belowHigh = (high == nullptr) || !(*high < key);
+
+	if (aboveLow)
+	{
+		ItemHelper(treePtr->GetLeftChildPtr(), low, high, Visit);
+	}
+
+	if (aboveLow && belowHigh)
+	{
+		ItemType itemContents = m_records[treePtr->GetItemRef().m_record];
+		Visit(itemContents);
+	}
+
+	if (belowHigh)
+	{
+		ItemHelper(treePtr->GetRightChildPtr(), low, high, Visit);
+	}
+}
@@ -0,0 +1,195 @@
+// ============================================================================
+// File: CStringArena.cpp
+// ============================================================================
+// Implimentation file for the class CStringArena
+// ============================================================================
+
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+using namespace std;
+#include "CStringArena.h"
+#include "CTreeStats.h"
+
+// =========================================================================
+//      Constructors and Destructor
+// =========================================================================
+
+// ==== Default Constructor ===================================================
+//
+// Creates an arena holding only the empty string, whose ID is 0.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CStringArena::CStringArena() : m_count(0), m_heapBytes(0)
+{
+	for (unsigned int chunk = 0; chunk < ARENA_MAX_CHUNKS; ++chunk)
+	{
+		m_chunks[chunk].store(nullptr, memory_order_relaxed);
+	}
+
+	Intern(string());
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Releases every chunk of strings.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CStringArena::~CStringArena()
+{
+	for (unsigned int chunk = 0; chunk < ARENA_MAX_CHUNKS; ++chunk)
+	{
+		delete[] m_chunks[chunk].load(memory_order_relaxed);
+	}
+}
+
+
+
+// =========================================================================
+//      Member Functions
+// =========================================================================
+
+// ==== Intern ================================================================
+//
+// Returns the ID of a string.  Names repeat, so most calls find the string
+// already stored and only need the shared lock; a new string is stored at
+// the end of the last chunk under the exclusive lock, and a new chunk is
+// published only after its strings are constructed.
+//
+// Input:
+//		value	[IN] - the string
+//
+// Output:
+//		unsigned int  -  its ID
+//
+// ============================================================================
+unsigned int CStringArena::Intern(const string &value)
+{
+	{
+		shared_lock<shared_mutex> readLock(m_lock);
+		unordered_map<string_view, unsigned int>::const_iterator found =
+														m_index.find(value);
+		if (found != m_index.end())
+		{
+			return found->second;
+		}
+	}
+
+	unique_lock<shared_mutex> writeLock(m_lock);
+
+	// Another thread may have stored it between the two locks
+	unordered_map<string_view, unsigned int>::const_iterator found =
+														m_index.find(value);
+	if (found != m_index.end())
+	{
+		return found->second;
+	}
+
+	unsigned int id = m_count;
+	unsigned int chunk = id >> ARENA_CHUNK_BITS;
+	if (chunk >= ARENA_MAX_CHUNKS)
+	{
+		throw length_error("CStringArena is full");
+	}
+
+	string *chunkPtr = m_chunks[chunk].load(memory_order_relaxed);
+	if (chunkPtr == nullptr)
+	{
+		chunkPtr = new string[ARENA_CHUNK_SIZE];
+		m_chunks[chunk].store(chunkPtr, memory_order_release);
+	}
+
+	string &stored = chunkPtr[id & (ARENA_CHUNK_SIZE - 1)];
+	stored = value;
+	m_index.emplace(string_view(stored), id);
+	m_heapBytes += HeapBytes(stored);
+	++m_count;
+
+	return id;
+}
+
+
+
+// ==== GetCount ==============================================================
+//
+// Returns the number of distinct strings in the arena.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		size_t  -  the number of strings
+//
+// ============================================================================
+size_t CStringArena::GetCount() const
+{
+	shared_lock<shared_mutex> readLock(m_lock);
+	return m_count;
+}
+
+
+
+// ==== GetBytes ==============================================================
+//
+// Returns the memory the arena uses: itself, its chunks of string objects,
+// the characters those strings own, and an estimate of its index (a bucket
+// pointer per bucket and one allocation per entry).
+//
+// Input:
+//		nothing
+//
+// Output:
+//		size_t  -  the number of bytes
+//
+// ============================================================================
+size_t CStringArena::GetBytes() const
+{
+	shared_lock<shared_mutex> readLock(m_lock);
+
+	size_t chunks = (m_count + ARENA_CHUNK_SIZE - 1) >> ARENA_CHUNK_BITS;
+	size_t entryBytes = sizeof(void*) + sizeof(size_t) +
+						sizeof(pair<const string_view, unsigned int>);
+
+	return sizeof(*this) + chunks * ARENA_CHUNK_SIZE * sizeof(string) +
+		   m_heapBytes +
+		   m_index.bucket_count() * sizeof(void*) + m_index.size() * entryBytes;
+}
+
+
+
+// =========================================================================
+//      Shared arenas
+// =========================================================================
+
+// ==== PersonNameArena =======================================================
+//
+// Returns the arena every CPersonInfo interns its names in.  It is never
+// destroyed, so names stay readable from the destructors of static objects.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CStringArena&  -  the arena
+//
+// ============================================================================
+CStringArena& PersonNameArena()
+{
+	static CStringArena *arenaPtr = new CStringArena;
+	return *arenaPtr;
+}
@@ -0,0 +1,100 @@
+// ============================================================================
+// File: CStringArena.h
+// ============================================================================
+// Header file for the class CStringArena, a table of interned strings.  Each
+// distinct string is stored once and named by a 32-bit ID, so records that
+// repeat the same few strings (see the compact CPersonInfo) hold IDs instead
+// of strings of their own.
+//
+// Strings are never removed; an arena only grows.  Interning takes a lock,
+// but looking a string up by its ID does not, and the reference it returns
+// stays valid for the life of the arena, so any number of threads may read
+// while others intern.
+// ============================================================================
+
+#ifndef CSTRINGARENA_HEADER
+#define CSTRINGARENA_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Strings per chunk of the arena; a power of two
+const unsigned int   ARENA_CHUNK_BITS = 12;
+const unsigned int   ARENA_CHUNK_SIZE = 1u << ARENA_CHUNK_BITS;
+
+// Most chunks an arena may have, which caps it at 64M distinct strings
+const unsigned int   ARENA_MAX_CHUNKS = 1u << 14;
+
+class CStringArena
+{
+public:
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates an arena holding only the empty string, whose ID is 0. */
+   CStringArena();
+
+   /** Releases every string.  IDs and references from the arena become
+       invalid. */
+   ~CStringArena();
+
+   CStringArena(const CStringArena&) = delete;
+   CStringArena& operator=(const CStringArena&) = delete;
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Returns the ID of a string, storing the string first if the arena
+       does not have it yet.
+    @param value: The string.
+    @return  Its ID; equal strings always get the same ID.
+    @throw  std::length_error if the arena is full. */
+   unsigned int Intern(const std::string &value);
+
+   /** Returns the string an ID names.
+    @param id: An ID returned by Intern.
+    @return  A reference to the string, valid for the life of the arena. */
+   const std::string& GetString(unsigned int id) const
+   {
+      const std::string *chunkPtr =
+         m_chunks[id >> ARENA_CHUNK_BITS].load(std::memory_order_acquire);
+      return chunkPtr[id & (ARENA_CHUNK_SIZE - 1)];
+   }
+
+   /** Returns the number of distinct strings in the arena.
+    @param Nothing.
+    @return  The number of strings, the empty string included. */
+   size_t GetCount() const;
+
+   /** Returns the memory the arena uses for its strings and its index.
+    @param Nothing.
+    @return  The number of bytes. */
+   size_t GetBytes() const;
+
+private:
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   mutable std::shared_mutex     m_lock;        // Guards all but m_chunks
+   std::atomic<std::string*>     m_chunks[ARENA_MAX_CHUNKS];
+   unsigned int                  m_count;       // Strings stored so far
+   size_t                        m_heapBytes;   // Owned by those strings
+
+   // The ID of every string; the keys are views of the stored strings
+   std::unordered_map<std::string_view, unsigned int>  m_index;
+}; // end CStringArena
+
+/** Returns the arena every CPersonInfo interns its names in.
+    @param Nothing.
+    @return  The arena, which lives until the program exits. */
+CStringArena& PersonNameArena();
+
+#endif  // CSTRINGARENA_HEADER
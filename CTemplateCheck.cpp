@@ -0,0 +1,47 @@
+// ============================================================================
+// File: CTemplateCheck.cpp
+// ============================================================================
+// Explicitly instantiates every member of the newer tree templates with
+// CPersonInfo.  A template member is only compiled once something uses it,
+// and the demo and benchmarks use few of these members, if any; without
+// this file a member that does not compile for CPersonInfo would go
+// unnoticed until someone called it.  The CMake project compiles this file
+// on every build; nothing links it.
+// ============================================================================
+
+#include <string>
+#include "CAggregateBST.h"
+#include "CFrozenBST.h"
+#include "CMultiBST.h"
+#include "CMultiIndex.h"
+#include "CPersonInfo.h"
+#include "CShardedBST.h"
+
+// ==== SavingsOf =============================================================
+//
+// Projects a person onto their savings balance for the aggregate policies.
+// It is not static: a template argument with internal linkage would give
+// the instantiations internal linkage too, and an unused warning each.
+//
+// Input:
+//		person	[IN] - the person
+//
+// Output:
+//		double  -  the savings balance
+//
+// ============================================================================
+double SavingsOf(const CPersonInfo &person)
+{
+	return person.GetSavings();
+}
+
+template class CFrozenBST<CPersonInfo>;
+template class CAggregateBST<CPersonInfo,
+					CSumAggregate<CPersonInfo, double, &SavingsOf> >;
+template class CAggregateBST<CPersonInfo,
+					CMinAggregate<CPersonInfo, double, &SavingsOf> >;
+template class CAggregateBST<CPersonInfo,
+					CMaxAggregate<CPersonInfo, double, &SavingsOf> >;
+template class CMultiIndex<CPersonInfo>;
+template class CMultiBST<CPersonInfo>;
+template class CShardedBST<CPersonInfo>;
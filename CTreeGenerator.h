@@ -0,0 +1,150 @@
+// ============================================================================
+// File: CTreeGenerator.h
+// ============================================================================
+// Header file for the class CTreeGenerator, a lazy traversal of the nodes of
+// a tree (see CBinaryNodeTree::Inorder and the like).  It works as a C++20
+// generator would: each step walks only as far as the next node, keeping
+// its place on an explicit stack (a queue for level order), and hands back
+// a reference to the item in the node instead of a copy.  A consumer can
+// stop early, feed the items to another lazy stage, or step two generators
+// side by side, none of which the Visit callbacks allow.
+//
+// Like a generator, a CTreeGenerator is single pass: begin() may be called
+// once.  It reads the nodes in place, so it is invalidated by any change to
+// the tree, including the rebuild every Add and Remove of a CBST makes.
+// ============================================================================
+
+#ifndef CTREEGENERATOR_HEADER
+#define CTREEGENERATOR_HEADER
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <vector>
+#include "CBinaryNode.h"
+#include "CKeyTraits.h"
+
+// The orders a CTreeGenerator can visit nodes in
+enum CTraversalOrder
+{
+   TRAVERSE_PREORDER,
+   TRAVERSE_INORDER,
+   TRAVERSE_POSTORDER,
+   TRAVERSE_LEVEL_ORDER       // Breadth first, left to right
+};
+
+template<class ItemType>
+class CTreeGenerator
+{
+public:
+   /** The input iterator of a range-based for loop over the generator. */
+   class CIterator
+   {
+   public:
+      typedef std::input_iterator_tag  iterator_category;
+      typedef ItemType                 value_type;
+      typedef std::ptrdiff_t           difference_type;
+      typedef const ItemType*          pointer;
+      typedef const ItemType&          reference;
+
+      /** Creates an iterator over a generator, or the end iterator. */
+      explicit CIterator(CTreeGenerator<ItemType> *generatorPtr = nullptr);
+
+      /** Returns the current item. */
+      const ItemType& operator*() const;
+
+      /** Gives access to the members of the current item. */
+      const ItemType* operator->() const;
+
+      /** Steps the generator to the next item. */
+      CIterator& operator++();
+
+      /** Steps the generator to the next item. */
+      void operator++(int);
+
+      /** Compares iterators; only the end of the items equals end(). */
+      bool operator==(const CIterator &rhs) const;
+      bool operator!=(const CIterator &rhs) const;
+
+   private:
+      CTreeGenerator<ItemType>   *m_generatorPtr;   // nullptr at the end
+   };
+
+   // =========================================================================
+   //      Constructors
+   // =========================================================================
+
+   /** Creates a generator over the nodes below rootPtr.
+    @param rootPtr: The root of the tree, or nullptr for an empty tree.
+    @param order: The order to visit the nodes in. */
+   CTreeGenerator(const CBinaryNode<ItemType> *rootPtr,
+                  CTraversalOrder order);
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Advances to the next item.
+    @param Nothing.
+    @return  True if there is one, or false if every item has been
+             visited. */
+   bool Next();
+
+   /** Returns the current item, the one the last Next() moved to.
+    @param Nothing.
+    @return  A reference to the item in its node. */
+   const ItemType& GetValue() const;
+
+   /** Starts the traversal.
+    @param Nothing.
+    @return  An iterator at the first item, or end() if there is none. */
+   CIterator begin();
+
+   /** Marks the end of the items.
+    @param Nothing.
+    @return  The end iterator. */
+   CIterator end();
+
+   /** Skips an inorder traversal ahead to the first item whose key is not
+       less than key, walking one path down the tree.  It must be called
+       before the first Next(); other orders ignore it.
+    @param key: The least key to visit.
+    @return  Nothing. */
+   template<class KeyType>
+   void SeekCeiling(const KeyType &key);
+
+private:
+   // A node waiting on the stack.  Postorder takes a node off the stack
+   // twice: first to put it back below its children, then, expanded, to
+   // visit it.  The other orders only stack nodes expanded or only
+   // unexpanded.
+   struct CFrame
+   {
+      const CBinaryNode<ItemType>  *m_nodePtr;
+      bool                         m_expanded;
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Puts a node on the stack, unless it is nullptr.
+    @param nodePtr: The node.
+    @param expanded: True if it is to be visited when next taken off.
+    @return  Nothing. */
+   void Push(const CBinaryNode<ItemType> *nodePtr, bool expanded);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   CTraversalOrder                           m_order;
+   std::vector<CFrame>                       m_stack;
+   std::deque<const CBinaryNode<ItemType>*>  m_queue;        // Level order
+   const CBinaryNode<ItemType>               *m_descendPtr;  // Inorder
+   const CBinaryNode<ItemType>               *m_currentPtr;
+}; // end CTreeGenerator
+
+#include "CTreeGenerator.tpp"
+
+#endif  // CTREEGENERATOR_HEADER
@@ -0,0 +1,406 @@
+// ============================================================================
+// File: CTreeGenerator.tpp
+// ============================================================================
+// This is the implementation file for the class CTreeGenerator
+// ============================================================================
+
+#include "CTreeGenerator.h"
+
+
+
+// ==== CIterator Constructor =================================================
+//
+// Creates an iterator over a generator, or the end iterator.
+//
+// Input:
+//		generatorPtr	[IN] - the generator, or nullptr for the end
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType>::CIterator::CIterator(
+										CTreeGenerator<ItemType> *generatorPtr)
+	: m_generatorPtr(generatorPtr)
+{
+
+}
+
+
+
+// ==== CIterator::operator* ==================================================
+//
+// Returns the current item.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const ItemType&  -  the item in its node
+//
+// ============================================================================
+template<class ItemType>
+const ItemType& CTreeGenerator<ItemType>::CIterator::operator*() const
+{
+	return m_generatorPtr->GetValue();
+}
+
+
+
+// ==== CIterator::operator-> =================================================
+//
+// Gives access to the members of the current item.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const ItemType*  -  the item in its node
+//
+// ============================================================================
+template<class ItemType>
+const ItemType* CTreeGenerator<ItemType>::CIterator::operator->() const
+{
+	return &m_generatorPtr->GetValue();
+}
+
+
+
+// ==== CIterator::operator++ =================================================
+//
+// Steps the generator to the next item, becoming the end iterator after the
+// last.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CIterator&  -  this iterator
+//
+// ============================================================================
+template<class ItemType>
+typename CTreeGenerator<ItemType>::CIterator&
+CTreeGenerator<ItemType>::CIterator::operator++()
+{
+	if (!m_generatorPtr->Next())
+	{
+		m_generatorPtr = nullptr;
+	}
+
+	return *this;
+}
+
+
+
+// ==== CIterator::operator++ (postfix) =======================================
+//
+// Steps the generator to the next item.  An input iterator cannot hand back
+// its old position, so nothing is returned.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CTreeGenerator<ItemType>::CIterator::operator++(int)
+{
+	++*this;
+}
+
+
+
+// ==== CIterator::operator== =================================================
+//
+// Compares iterators.
+//
+// Input:
+//		rhs	[IN] - the iterator to compare with
+//
+// Output:
+//		bool  -  True if both are at the end or both step the same generator
+//
+// ============================================================================
+template<class ItemType>
+bool CTreeGenerator<ItemType>::CIterator::operator==(const CIterator &rhs) const
+{
+	return m_generatorPtr == rhs.m_generatorPtr;
+}
+
+
+
+// ==== CIterator::operator!= =================================================
+//
+// Compares iterators.
+//
+// Input:
+//		rhs	[IN] - the iterator to compare with
+//
+// Output:
+//		bool  -  True if they differ
+//
+// ============================================================================
+template<class ItemType>
+bool CTreeGenerator<ItemType>::CIterator::operator!=(const CIterator &rhs) const
+{
+	return m_generatorPtr != rhs.m_generatorPtr;
+}
+
+
+
+// ==== Constructor ===========================================================
+//
+// Creates a generator over the nodes below rootPtr.  Nothing is walked until
+// the first Next().
+//
+// Input:
+//		rootPtr	[IN] - the root of the tree, or nullptr
+//		order	[IN] - the order to visit the nodes in
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CTreeGenerator<ItemType>::CTreeGenerator(const CBinaryNode<ItemType> *rootPtr,
+										 CTraversalOrder order)
+	: m_order(order), m_descendPtr(nullptr), m_currentPtr(nullptr)
+{
+	if (rootPtr == nullptr)
+	{
+		return;
+	}
+
+	if (m_order == TRAVERSE_LEVEL_ORDER)
+	{
+		m_queue.push_back(rootPtr);
+	}
+	else if (m_order == TRAVERSE_INORDER)
+	{
+		m_descendPtr = rootPtr;
+	}
+	else
+	{
+		Push(rootPtr, false);
+	}
+}
+
+
+
+// ==== Next ==================================================================
+//
+// Advances to the next item.  A level order traversal takes the next node
+// off the queue and queues its children.  An inorder one stacks the left
+// spine below the last node's right child and visits the top of the stack.
+// A preorder one visits the node on top of the stack and stacks its
+// children in its place.  A postorder one takes nodes off the stack until
+// it finds one already expanded; an unexpanded node goes back on the stack,
+// expanded, below its children.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if there is a next item, false if there is none
+//
+// ============================================================================
+template<class ItemType>
+bool CTreeGenerator<ItemType>::Next()
+{
+	if (m_order == TRAVERSE_LEVEL_ORDER)
+	{
+		if (m_queue.empty())
+		{
+			m_currentPtr = nullptr;
+			return false;
+		}
+
+		m_currentPtr = m_queue.front();
+		m_queue.pop_front();
+		if (m_currentPtr->GetLeftChildPtr() != nullptr)
+		{
+			m_queue.push_back(m_currentPtr->GetLeftChildPtr());
+		}
+		if (m_currentPtr->GetRightChildPtr() != nullptr)
+		{
+			m_queue.push_back(m_currentPtr->GetRightChildPtr());
+		}
+		return true;
+	}
+
+	if (m_order == TRAVERSE_INORDER)
+	{
+		for (; m_descendPtr != nullptr;
+			 m_descendPtr = m_descendPtr->GetLeftChildPtr())
+		{
+			Push(m_descendPtr, true);
+		}
+		if (m_stack.empty())
+		{
+			m_currentPtr = nullptr;
+			return false;
+		}
+
+		m_currentPtr = m_stack.back().m_nodePtr;
+		m_stack.pop_back();
+		m_descendPtr = m_currentPtr->GetRightChildPtr();
+		return true;
+	}
+
+	while (!m_stack.empty())
+	{
+		CFrame frame = m_stack.back();
+		m_stack.pop_back();
+		if (frame.m_expanded)
+		{
+			m_currentPtr = frame.m_nodePtr;
+			return true;
+		}
+
+		const CBinaryNode<ItemType> *nodePtr = frame.m_nodePtr;
+		switch (m_order)
+		{
+			case TRAVERSE_PREORDER:
+				//a node comes before its children, so it needs no second trip
+				Push(nodePtr->GetRightChildPtr(), false);
+				Push(nodePtr->GetLeftChildPtr(), false);
+				m_currentPtr = nodePtr;
+				return true;
+
+			default:
+				Push(nodePtr, true);
+				Push(nodePtr->GetRightChildPtr(), false);
+				Push(nodePtr->GetLeftChildPtr(), false);
+				break;
+		}
+	}
+
+	m_currentPtr = nullptr;
+	return false;
+}
+
+
+
+// ==== GetValue ==============================================================
+//
+// Returns the current item.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		const ItemType&  -  the item in its node
+//
+// ============================================================================
+template<class ItemType>
+const ItemType& CTreeGenerator<ItemType>::GetValue() const
+{
+	return m_currentPtr->GetItemRef();
+}
+
+
+
+// ==== begin =================================================================
+//
+// Starts the traversal by advancing to the first item.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CIterator  -  at the first item, or end() if there is none
+//
+// ============================================================================
+template<class ItemType>
+typename CTreeGenerator<ItemType>::CIterator CTreeGenerator<ItemType>::begin()
+{
+	return Next() ? CIterator(this) : CIterator();
+}
+
+
+
+// ==== end ===================================================================
+//
+// Marks the end of the items.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CIterator  -  the end iterator
+//
+// ============================================================================
+template<class ItemType>
+typename CTreeGenerator<ItemType>::CIterator CTreeGenerator<ItemType>::end()
+{
+	return CIterator();
+}
+
+
+
+// ==== SeekCeiling ===========================================================
+//
+// Skips an inorder traversal ahead to the first item whose key is not less
+// than key.  Instead of the whole left spine of the root, it stacks the
+// nodes on the search path for key that are not less than key; each one
+// still waits for its left subtree to be visited, and everything left of
+// the path is less than key.  Other orders ignore it.
+//
+// Input:
+//		key	[IN] - the least key to visit
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+template<class KeyType>
+void CTreeGenerator<ItemType>::SeekCeiling(const KeyType &key)
+{
+	if (m_order != TRAVERSE_INORDER)
+	{
+		return;
+	}
+
+	const CBinaryNode<ItemType> *nodePtr = m_descendPtr;
+	m_descendPtr = nullptr;
+	while (nodePtr != nullptr)
+	{
+		if (CKeyTraits<ItemType>::GetKey(nodePtr->GetItemRef()) < key)
+		{
+			nodePtr = nodePtr->GetRightChildPtr();
+		}
+		else
+		{
+			Push(nodePtr, true);
+			nodePtr = nodePtr->GetLeftChildPtr();
+		}
+	}
+}
+
+
+
+// ==== Push ==================================================================
+//
+// Puts a node on the stack, unless it is nullptr.
+//
+// Input:
+//		nodePtr		[IN] - the node
+//		expanded	[IN] - True if it is to be visited when next taken off
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CTreeGenerator<ItemType>::Push(const CBinaryNode<ItemType> *nodePtr,
+									bool expanded)
+{
+	if (nodePtr != nullptr)
+	{
+		m_stack.push_back(CFrame{nodePtr, expanded});
+	}
+}
@@ -0,0 +1,656 @@
+// ============================================================================
+// File: CTreeInstrument.cpp
+// ============================================================================
+// Implimentation file for the tree instrumentation layer.  The snapshot
+// functions are always built; the per-thread blocks and their registry only
+// when CBST_INSTRUMENT is defined.
+// ============================================================================
+
+#include <cstdio>
+#include <string>
+using namespace std;
+#include "CTreeInstrument.h"
+
+#ifdef CBST_INSTRUMENT
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+// Names used by ToText, in the order of CTreeCounter and CTreeOperation
+static const char *const COUNTER_NAMES[TREE_COUNTER_COUNT] = {
+	"comparisons", "nodes visited", "rebuilds", "nodes allocated",
+	"nodes freed", "rotations" };
+static const char *const OPERATION_NAMES[TREE_OP_COUNT] = {
+	"add", "remove", "find", "rebuild" };
+
+
+
+// ==== CInstrumentSnapshot ===================================================
+//
+// Sets every count to zero.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CInstrumentSnapshot::CInstrumentSnapshot() : m_counters(), m_calls(),
+											 m_histograms()
+{
+
+}
+
+
+
+// ==== GetBucket =============================================================
+//
+// Returns the histogram bucket a latency falls in.  Latencies below
+// TREE_HISTOGRAM_SUB_BUCKETS each have a bucket; above that, every power of
+// two is split into TREE_HISTOGRAM_SUB_BUCKETS equal buckets.
+//
+// Input:
+//		nanos	[IN] - the latency in nanoseconds
+//
+// Output:
+//		int  -  the bucket index
+//
+// ============================================================================
+int CInstrumentSnapshot::GetBucket(unsigned long long nanos)
+{
+	if (nanos < (unsigned long long)TREE_HISTOGRAM_SUB_BUCKETS)
+	{
+		return (int)nanos;
+	}
+
+	int topBit = 63 - __builtin_clzll(nanos);
+	int shift = topBit - TREE_HISTOGRAM_SUB_BITS;
+
+	return (shift + 1) * TREE_HISTOGRAM_SUB_BUCKETS +
+		   (int)((nanos >> shift) & (TREE_HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+
+
+// ==== GetBucketStart ========================================================
+//
+// Returns the smallest latency that falls in a bucket; the inverse of
+// GetBucket.
+//
+// Input:
+//		bucket	[IN] - the bucket index
+//
+// Output:
+//		unsigned long long  -  the latency in nanoseconds
+//
+// ============================================================================
+unsigned long long CInstrumentSnapshot::GetBucketStart(int bucket)
+{
+	if (bucket < TREE_HISTOGRAM_SUB_BUCKETS)
+	{
+		return (unsigned long long)bucket;
+	}
+
+	int shift = bucket / TREE_HISTOGRAM_SUB_BUCKETS - 1;
+	unsigned long long subBucket = bucket % TREE_HISTOGRAM_SUB_BUCKETS;
+
+	return (TREE_HISTOGRAM_SUB_BUCKETS + subBucket) << shift;
+}
+
+
+
+// ==== GetMeanLatency ========================================================
+//
+// Returns the mean latency of an operation, taking every timed call to have
+// lasted as long as the middle of its bucket.
+//
+// Input:
+//		operation	[IN] - the operation
+//
+// Output:
+//		double  -  the mean latency in nanoseconds, or 0 if no call was timed
+//
+// ============================================================================
+double CInstrumentSnapshot::GetMeanLatency(CTreeOperation operation) const
+{
+	double total = 0;
+	unsigned long long samples = 0;
+
+	for (int bucket = 0; bucket < TREE_HISTOGRAM_BUCKETS; ++bucket)
+	{
+		unsigned long long count = m_histograms[operation][bucket];
+		if (count == 0)
+		{
+			continue;
+		}
+
+		double start = (double)GetBucketStart(bucket);
+		double end = (bucket + 1 < TREE_HISTOGRAM_BUCKETS) ?
+					 (double)GetBucketStart(bucket + 1) : start;
+		total += count * (start + end) / 2;
+		samples += count;
+	}
+
+	return (samples == 0) ? 0 : total / samples;
+}
+
+
+
+// ==== GetLatencyPercentile ==================================================
+//
+// Returns a latency percentile of an operation.  The answer is the start of
+// the bucket the percentile falls in, so it is low by at most one bucket.
+//
+// Input:
+//		operation	[IN] - the operation
+//		percentile	[IN] - the percentile, from 0 to 100
+//
+// Output:
+//		double  -  the latency in nanoseconds, or 0 if no call was timed
+//
+// ============================================================================
+double CInstrumentSnapshot::GetLatencyPercentile(CTreeOperation operation,
+												 double percentile) const
+{
+	unsigned long long samples = 0;
+	for (int bucket = 0; bucket < TREE_HISTOGRAM_BUCKETS; ++bucket)
+	{
+		samples += m_histograms[operation][bucket];
+	}
+	if (samples == 0)
+	{
+		return 0;
+	}
+
+	//the rank of the percentile among the samples, counting from 1
+	double rank = percentile / 100 * samples;
+	unsigned long long seen = 0;
+	for (int bucket = 0; bucket < TREE_HISTOGRAM_BUCKETS; ++bucket)
+	{
+		seen += m_histograms[operation][bucket];
+		if (seen > 0 && seen >= rank)
+		{
+			return (double)GetBucketStart(bucket);
+		}
+	}
+
+	return 0;
+}
+
+
+
+// ==== ToText ================================================================
+//
+// Formats the counters, then the calls and sampled latencies of every
+// operation, one per line.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		string  -  the report
+//
+// ============================================================================
+string CInstrumentSnapshot::ToText() const
+{
+	string text;
+	char line[160];
+
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		snprintf(line, sizeof(line), "%-16s %20llu\n", COUNTER_NAMES[counter],
+				 m_counters[counter]);
+		text += line;
+	}
+
+	if (m_calls[TREE_OP_FIND] > 0)
+	{
+		snprintf(line, sizeof(line), "%-16s %20.2f\n", "nodes per find",
+				 (double)m_counters[TREE_NODES_VISITED] /
+				 m_calls[TREE_OP_FIND]);
+		text += line;
+	}
+
+	snprintf(line, sizeof(line), "%-8s %14s %10s %10s %10s %10s %10s\n",
+			 "op", "calls", "mean ns", "p50 ns", "p99 ns", "p99.9 ns",
+			 "max ns");
+	text += line;
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		CTreeOperation op = (CTreeOperation)operation;
+		snprintf(line, sizeof(line),
+				 "%-8s %14llu %10.0f %10.0f %10.0f %10.0f %10.0f\n",
+				 OPERATION_NAMES[operation], m_calls[operation],
+				 GetMeanLatency(op), GetLatencyPercentile(op, 50),
+				 GetLatencyPercentile(op, 99), GetLatencyPercentile(op, 99.9),
+				 GetLatencyPercentile(op, 100));
+		text += line;
+	}
+
+	return text;
+}
+
+
+
+#ifdef CBST_INSTRUMENT
+
+// The flushed counts of one thread.  Only the owning thread writes them,
+// with a relaxed load and store that compile to plain moves; the atomics
+// only make it safe for InstrumentSnapshot to read them meanwhile.
+struct CInstrumentBlock
+{
+	atomic<unsigned long long>	m_counters[TREE_COUNTER_COUNT];
+	atomic<unsigned long long>	m_calls[TREE_OP_COUNT];
+	atomic<unsigned long long>	m_histograms[TREE_OP_COUNT]
+											[TREE_HISTOGRAM_BUCKETS];
+};
+
+// The blocks of the running threads, and the counts of the exited ones.
+// Never destroyed, so threads may still exit during static destruction.
+struct CInstrumentRegistry
+{
+	mutex						m_mutex;
+	vector<CInstrumentBlock*>	m_blocks;
+	CInstrumentSnapshot			m_retired;
+};
+
+static CInstrumentRegistry& GetRegistry()
+{
+	static CInstrumentRegistry *registryPtr = new CInstrumentRegistry;
+	return *registryPtr;
+}
+
+// The calling thread's block, or nullptr until its first flush
+static thread_local CInstrumentBlock *t_instrumentBlock = nullptr;
+
+// Set once the thread's block has been retired.  A thread_local destroyed
+// after that may still count; its counts then go straight to the retired
+// counts rather than registering a block that nothing would retire.
+static thread_local bool t_instrumentRetired = false;
+
+
+
+// ==== AddCount ==============================================================
+//
+// Adds to a count of the calling thread's block.
+//
+// Input:
+//		counter	[IN/OUT] - the count
+//		amount	[IN] - the amount to add
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void AddCount(atomic<unsigned long long> &counter,
+					 unsigned long long amount)
+{
+	counter.store(counter.load(memory_order_relaxed) + amount,
+				  memory_order_relaxed);
+}
+
+
+
+// ==== AddBlock ==============================================================
+//
+// Adds the counts of a block to a snapshot.
+//
+// Input:
+//		block		[IN] - the block
+//		snapshot	[IN/OUT] - the snapshot to add to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void AddBlock(const CInstrumentBlock &block,
+					 CInstrumentSnapshot &snapshot)
+{
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		snapshot.m_counters[counter] +=
+						block.m_counters[counter].load(memory_order_relaxed);
+	}
+
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		snapshot.m_calls[operation] +=
+						block.m_calls[operation].load(memory_order_relaxed);
+		for (int bucket = 0; bucket < TREE_HISTOGRAM_BUCKETS; ++bucket)
+		{
+			snapshot.m_histograms[operation][bucket] +=
+				block.m_histograms[operation][bucket].load(
+													memory_order_relaxed);
+		}
+	}
+}
+
+
+
+// ==== ClearBlock ============================================================
+//
+// Sets every count of a block to zero.
+//
+// Input:
+//		block	[IN/OUT] - the block
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void ClearBlock(CInstrumentBlock &block)
+{
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		block.m_counters[counter].store(0, memory_order_relaxed);
+	}
+
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		block.m_calls[operation].store(0, memory_order_relaxed);
+		for (int bucket = 0; bucket < TREE_HISTOGRAM_BUCKETS; ++bucket)
+		{
+			block.m_histograms[operation][bucket].store(0,
+													memory_order_relaxed);
+		}
+	}
+}
+
+
+
+// ==== ClearPending ==========================================================
+//
+// Drops the calling thread's pending counts.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void ClearPending()
+{
+	CInstrumentPending &pending = t_instrumentPending;
+
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		pending.m_counters[counter] = 0;
+	}
+
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		pending.m_flushedCalls[operation] = pending.m_calls[operation];
+	}
+}
+
+
+
+// ==== FlushPending ==========================================================
+//
+// Moves the calling thread's pending counts into its block.
+//
+// Input:
+//		block	[IN/OUT] - the block of the calling thread
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void FlushPending(CInstrumentBlock &block)
+{
+	const CInstrumentPending &pending = t_instrumentPending;
+
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		AddCount(block.m_counters[counter], pending.m_counters[counter]);
+	}
+
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		AddCount(block.m_calls[operation], pending.m_calls[operation] -
+										   pending.m_flushedCalls[operation]);
+	}
+
+	ClearPending();
+}
+
+
+
+// ==== FlushPending ==========================================================
+//
+// Moves the calling thread's pending counts into a snapshot.
+//
+// Input:
+//		snapshot	[IN/OUT] - the snapshot to add to
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+static void FlushPending(CInstrumentSnapshot &snapshot)
+{
+	const CInstrumentPending &pending = t_instrumentPending;
+
+	for (int counter = 0; counter < TREE_COUNTER_COUNT; ++counter)
+	{
+		snapshot.m_counters[counter] += pending.m_counters[counter];
+	}
+
+	for (int operation = 0; operation < TREE_OP_COUNT; ++operation)
+	{
+		snapshot.m_calls[operation] += pending.m_calls[operation] -
+									   pending.m_flushedCalls[operation];
+	}
+
+	ClearPending();
+}
+
+
+
+// Retires the block of its thread when the thread exits
+struct CInstrumentBlockOwner
+{
+	~CInstrumentBlockOwner()
+	{
+		CInstrumentRegistry &registry = GetRegistry();
+		lock_guard<mutex> lock(registry.m_mutex);
+		FlushPending(registry.m_retired);
+		t_instrumentRetired = true;
+		if (t_instrumentBlock == nullptr)
+		{
+			return;
+		}
+
+		AddBlock(*t_instrumentBlock, registry.m_retired);
+		registry.m_blocks.erase(find(registry.m_blocks.begin(),
+									 registry.m_blocks.end(),
+									 t_instrumentBlock));
+		delete t_instrumentBlock;
+		t_instrumentBlock = nullptr;
+	}
+};
+
+
+
+// ==== RegisterThread ========================================================
+//
+// Creates the block of the calling thread and adds it to the registry.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CInstrumentBlock*  -  the block
+//
+// ============================================================================
+static CInstrumentBlock* RegisterThread()
+{
+	static thread_local CInstrumentBlockOwner owner;
+
+	CInstrumentBlock *blockPtr = new CInstrumentBlock;
+	ClearBlock(*blockPtr);
+
+	CInstrumentRegistry &registry = GetRegistry();
+	lock_guard<mutex> lock(registry.m_mutex);
+	registry.m_blocks.push_back(blockPtr);
+	t_instrumentBlock = blockPtr;
+
+	//odr-use owner so that its destructor runs when the thread exits
+	(void)&owner;
+
+	return blockPtr;
+}
+
+
+
+// ==== InstrumentFlush =======================================================
+//
+// Adds the calling thread's pending counts to its block, creating the block
+// on first use, or to the retired counts once the block has been retired.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void InstrumentFlush()
+{
+	if (t_instrumentRetired)
+	{
+		CInstrumentRegistry &registry = GetRegistry();
+		lock_guard<mutex> lock(registry.m_mutex);
+		FlushPending(registry.m_retired);
+		return;
+	}
+
+	CInstrumentBlock *blockPtr = t_instrumentBlock;
+	if (blockPtr == nullptr)
+	{
+		blockPtr = RegisterThread();
+	}
+	FlushPending(*blockPtr);
+}
+
+
+
+// ==== InstrumentStartSample ================================================
+//
+// Flushes the calling thread's counts and starts timing a sampled call.
+// Once the thread's block has been retired, the call is counted but not
+// timed.
+//
+// Input:
+//		operation	[IN] - the operation called
+//
+// Output:
+//		bool  -  True if the call is being timed
+//
+// ============================================================================
+bool InstrumentStartSample(CTreeOperation operation)
+{
+	InstrumentFlush();
+	if (t_instrumentBlock == nullptr)
+	{
+		return false;
+	}
+
+	chrono::nanoseconds now = chrono::steady_clock::now().time_since_epoch();
+	t_instrumentPending.m_sampleStart[operation] = now.count();
+
+	return true;
+}
+
+
+
+// ==== InstrumentStopSample ==================================================
+//
+// Adds the time since InstrumentStartSample to the histogram of the
+// operation.
+//
+// Input:
+//		operation	[IN] - the operation called
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void InstrumentStopSample(CTreeOperation operation)
+{
+	chrono::nanoseconds now = chrono::steady_clock::now().time_since_epoch();
+	long long elapsed = now.count() -
+						t_instrumentPending.m_sampleStart[operation];
+
+	if (t_instrumentBlock != nullptr && elapsed >= 0)
+	{
+		AddCount(t_instrumentBlock->m_histograms[operation][
+					CInstrumentSnapshot::GetBucket(elapsed)], 1);
+	}
+}
+
+
+
+// ==== InstrumentSnapshot ====================================================
+//
+// Adds up the counts of the exited threads and of every running one, after
+// flushing those of the calling thread.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CInstrumentSnapshot  -  the snapshot
+//
+// ============================================================================
+CInstrumentSnapshot InstrumentSnapshot()
+{
+	InstrumentFlush();
+
+	CInstrumentRegistry &registry = GetRegistry();
+	lock_guard<mutex> lock(registry.m_mutex);
+
+	CInstrumentSnapshot snapshot = registry.m_retired;
+	for (size_t index = 0; index < registry.m_blocks.size(); ++index)
+	{
+		AddBlock(*registry.m_blocks[index], snapshot);
+	}
+
+	return snapshot;
+}
+
+
+
+// ==== InstrumentReset =======================================================
+//
+// Sets the counts of the exited threads and of every running one to zero,
+// and drops the calling thread's pending counts.  Other threads' pending
+// counts survive the reset.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void InstrumentReset()
+{
+	ClearPending();
+
+	CInstrumentRegistry &registry = GetRegistry();
+	lock_guard<mutex> lock(registry.m_mutex);
+
+	registry.m_retired = CInstrumentSnapshot();
+	for (size_t index = 0; index < registry.m_blocks.size(); ++index)
+	{
+		ClearBlock(*registry.m_blocks[index]);
+	}
+}
+
+#endif  // CBST_INSTRUMENT
@@ -0,0 +1,226 @@
+// ============================================================================
+// File: CTreeInstrument.h
+// ============================================================================
+// Header file for the tree instrumentation layer.  The trees count the work
+// they do (comparisons, nodes visited by lookups, rebuilds, nodes allocated
+// and freed, rotations) and record how long their operations take, so a slow
+// tree can be told apart from a tree that is simply asked to do a lot.
+//
+// Instrumentation is compiled in only when CBST_INSTRUMENT is defined (the
+// CMake option of the same name).  Otherwise BST_COUNT and BST_TIME expand
+// to nothing and the trees are exactly as they are without this file.  The
+// macro changes the layout of nothing, but it must still be defined the same
+// way for every file of a program, or some trees will go uncounted.
+//
+// Every thread counts into plain thread-local integers, so counting needs
+// no locks and no atomics; they are flushed into a per-thread block on the
+// sampled calls, and InstrumentSnapshot adds the blocks up.  One in every
+// TREE_LATENCY_SAMPLE_EVERY calls of an operation is timed, into a
+// log-linear histogram (the layout HdrHistogram uses) whose buckets are
+// within 1/TREE_HISTOGRAM_SUB_BUCKETS of each other.
+// ============================================================================
+
+#ifndef CTREEINSTRUMENT_HEADER
+#define CTREEINSTRUMENT_HEADER
+
+#include <string>
+
+// =========================================================================
+//      Instrumentation constants
+// =========================================================================
+
+// What the trees count
+enum CTreeCounter
+{
+   TREE_COMPARISONS,          // Nodes an item was compared at while adding
+                              // or removing it; a three-way test counts once
+   TREE_NODES_VISITED,        // Nodes an item was compared at while looking
+                              // it up
+   TREE_REBUILDS,             // Whole-tree rebuilds (ArrayToTree)
+   TREE_NODES_ALLOCATED,      // CBinaryNode objects allocated
+   TREE_NODES_FREED,          // CBinaryNode objects freed
+   TREE_ROTATIONS,            // Rotations made by self-adjusting trees
+   TREE_COUNTER_COUNT
+};
+
+// The operations whose calls are counted and whose latency is sampled
+enum CTreeOperation
+{
+   TREE_OP_ADD,
+   TREE_OP_REMOVE,
+   TREE_OP_FIND,              // FindOrNull, and so Contains and GetEntry
+   TREE_OP_REBUILD,           // ArrayToTree
+   TREE_OP_COUNT
+};
+
+// One call of an operation in this many is timed; a power of two.  Reading
+// the clock costs more than a lookup in a small tree, so it is done rarely.
+const unsigned int   TREE_LATENCY_SAMPLE_EVERY = 1024;
+
+// Buckets per power of two in a latency histogram; a power of two
+const int            TREE_HISTOGRAM_SUB_BUCKETS = 16;
+const int            TREE_HISTOGRAM_SUB_BITS = 4;
+
+// Enough buckets for any 64-bit number of nanoseconds
+const int            TREE_HISTOGRAM_BUCKETS = (64 - TREE_HISTOGRAM_SUB_BITS) *
+                                              TREE_HISTOGRAM_SUB_BUCKETS +
+                                              TREE_HISTOGRAM_SUB_BUCKETS;
+
+// =========================================================================
+//      Instrumentation snapshot
+// =========================================================================
+
+/** The counters and latency histograms of every thread, added up. */
+struct CInstrumentSnapshot
+{
+   /** Sets every count to zero. */
+   CInstrumentSnapshot();
+
+   /** Returns the mean latency of an operation over the timed calls.
+    @param operation: The operation.
+    @return  The mean latency in nanoseconds, or 0 if no call was timed. */
+   double GetMeanLatency(CTreeOperation operation) const;
+
+   /** Returns a latency percentile of an operation over the timed calls.
+    @param operation: The operation.
+    @param percentile: The percentile, from 0 to 100.
+    @return  The latency in nanoseconds that the given percent of the timed
+             calls did not exceed, or 0 if no call was timed. */
+   double GetLatencyPercentile(CTreeOperation operation,
+                               double percentile) const;
+
+   /** Formats the counters and a latency summary of every operation.
+    @param Nothing.
+    @return  The report, one line per counter and per operation. */
+   std::string ToText() const;
+
+   /** Returns the histogram bucket a latency falls in.
+    @param nanos: The latency in nanoseconds.
+    @return  The bucket index, from 0 to TREE_HISTOGRAM_BUCKETS - 1. */
+   static int GetBucket(unsigned long long nanos);
+
+   /** Returns the smallest latency that falls in a bucket.
+    @param bucket: The bucket index.
+    @return  The latency in nanoseconds. */
+   static unsigned long long GetBucketStart(int bucket);
+
+   unsigned long long   m_counters[TREE_COUNTER_COUNT];
+   unsigned long long   m_calls[TREE_OP_COUNT];
+   unsigned long long   m_histograms[TREE_OP_COUNT][TREE_HISTOGRAM_BUCKETS];
+}; // end CInstrumentSnapshot
+
+#ifdef CBST_INSTRUMENT
+
+// =========================================================================
+//      Instrumentation functions
+// =========================================================================
+
+/** Adds up the counters and histograms of every thread, including threads
+    that have exited.  The calling thread's counts are exact; each other
+    running thread's may lag by up to TREE_LATENCY_SAMPLE_EVERY calls of
+    each operation, and by the counts made since its last such call.
+    Counts made while the snapshot is taken may or may not be included.
+    @param Nothing.
+    @return  The snapshot. */
+CInstrumentSnapshot InstrumentSnapshot();
+
+/** Sets every counter and histogram of every thread back to zero.  Counts
+    made while the reset runs, and those other running threads have not
+    flushed yet, may survive it.
+    @param Nothing.
+    @return  Nothing. */
+void InstrumentReset();
+
+// The counts of one thread not yet added to the registry.  Only the owning
+// thread touches them, so counting is a plain add to thread-local memory:
+// no call, no atomic and no test of a pointer on the hot path.  They are
+// flushed on every sampled call, when InstrumentSnapshot runs on the
+// thread and when the thread exits.  A thread_local destroyed after that
+// may still count; its counts go straight to the exited threads' totals on
+// its sampled calls, and those after its last sampled call are lost.
+struct CInstrumentPending
+{
+   unsigned long long   m_counters[TREE_COUNTER_COUNT];  // Since last flush
+   unsigned long long   m_calls[TREE_OP_COUNT];          // Since thread start
+   unsigned long long   m_flushedCalls[TREE_OP_COUNT];   // m_calls at flush
+   long long            m_sampleStart[TREE_OP_COUNT];    // Clock at the start
+                                                         // of a sampled call
+};
+
+// Constant-initialized and trivially destructible, so it is reached
+// directly rather than through a TLS wrapper call, and stays usable while
+// other thread_local objects are being destroyed.
+inline thread_local CInstrumentPending t_instrumentPending = {};
+
+/** Adds the calling thread's pending counts to the registry.
+    @param Nothing.
+    @return  Nothing. */
+void InstrumentFlush();
+
+/** Flushes the calling thread's counts and starts timing a sampled call.
+    @param operation: The operation called.
+    @return  True if the call is being timed. */
+bool InstrumentStartSample(CTreeOperation operation);
+
+/** Adds the time since InstrumentStartSample to the operation's histogram.
+    @param operation: The operation called.
+    @return  Nothing. */
+void InstrumentStopSample(CTreeOperation operation);
+
+/** Adds to a counter of the calling thread. */
+inline void InstrumentCount(CTreeCounter counter, unsigned long long amount)
+{
+   t_instrumentPending.m_counters[counter] += amount;
+}
+
+// Counts a call of an operation and, for one call in every
+// TREE_LATENCY_SAMPLE_EVERY, flushes the thread's counts and records how
+// long the object lived.  Only the count is inline, and the object is
+// small enough to live in registers; the rest is out of line since it is
+// rare.  The start of a sampled call is kept per thread and operation, so
+// a sampled call nested in another of the same operation would cut the
+// outer one's time short; it takes TREE_LATENCY_SAMPLE_EVERY nested calls.
+class CInstrumentTimer
+{
+public:
+   explicit CInstrumentTimer(CTreeOperation operation) :
+                                    m_operation(operation), m_sampled(false)
+   {
+      unsigned long long count = t_instrumentPending.m_calls[operation]++;
+      if ((count & (TREE_LATENCY_SAMPLE_EVERY - 1)) == 0)
+      {
+         m_sampled = InstrumentStartSample(operation);
+      }
+   }
+
+   ~CInstrumentTimer()
+   {
+      if (m_sampled)
+      {
+         InstrumentStopSample(m_operation);
+      }
+   }
+
+   CInstrumentTimer(const CInstrumentTimer&) = delete;
+   CInstrumentTimer& operator=(const CInstrumentTimer&) = delete;
+
+private:
+   CTreeOperation   m_operation;
+   bool             m_sampled;
+}; // end CInstrumentTimer
+
+/** Adds amount to a CTreeCounter. */
+#define BST_COUNT(counter, amount)  InstrumentCount((counter), (amount))
+
+/** Counts a call of a CTreeOperation and samples its latency until the end
+    of the enclosing block. */
+#define BST_TIME(operation)   CInstrumentTimer instrumentTimer(operation)
+
+#else
+
+#define BST_COUNT(counter, amount)  ((void)(amount))
+#define BST_TIME(operation)         ((void)0)
+
+#endif  // CBST_INSTRUMENT
+
+#endif  // CTREEINSTRUMENT_HEADER
@@ -0,0 +1,158 @@
+// ============================================================================
+// File: CTreeStats.cpp
+// ============================================================================
+// Implimentation file for the struct CTreeStats and the non-templated memory
+// accounting functions
+// ============================================================================
+
+#include <cstdio>
+#include <string>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+using namespace std;
+#include "CTreeStats.h"
+
+
+
+// ==== CTreeStats ============================================================
+//
+// Describes an empty tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CTreeStats::CTreeStats() : m_nodeCount(0), m_height(0),
+						   m_averagePathLength(0), m_worstPathLength(0),
+						   m_nodeBytes(0), m_payloadBytes(0),
+						   m_payloadHeapBytes(0), m_allocatedBytes(0),
+						   m_fragmentation(0)
+{
+
+}
+
+
+
+// ==== ToText ================================================================
+//
+// Formats the report, one figure per line, followed by the number of nodes
+// at every depth and with every balance factor.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		string  -  the report
+//
+// ============================================================================
+string CTreeStats::ToText() const
+{
+	string text;
+	char line[128];
+
+	snprintf(line, sizeof(line), "%-24s %16lld\n", "nodes", m_nodeCount);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16d\n", "height", m_height);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16.2f\n", "average search path",
+			 m_averagePathLength);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16d\n", "worst search path",
+			 m_worstPathLength);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16zu\n", "node bytes", m_nodeBytes);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16zu\n", "  payload bytes",
+			 m_payloadBytes);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16zu\n", "  link bytes",
+			 m_nodeBytes - m_payloadBytes);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16zu\n", "payload heap bytes",
+			 m_payloadHeapBytes);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %16zu\n", "allocated node bytes",
+			 m_allocatedBytes);
+	text += line;
+	snprintf(line, sizeof(line), "%-24s %15.1f%%\n", "fragmentation",
+			 m_fragmentation * 100);
+	text += line;
+
+	text += "depth            nodes\n";
+	for (size_t depth = 0; depth < m_depthHistogram.size(); ++depth)
+	{
+		snprintf(line, sizeof(line), "%5zu %15lld\n", depth,
+				 m_depthHistogram[depth]);
+		text += line;
+	}
+
+	text += "balance          nodes\n";
+	for (map<int, long long>::const_iterator factor = m_balanceFactors.begin();
+		 factor != m_balanceFactors.end(); ++factor)
+	{
+		snprintf(line, sizeof(line), "%+5d %15lld\n", factor->first,
+				 factor->second);
+		text += line;
+	}
+
+	return text;
+}
+
+
+
+// ==== HeapBytes =============================================================
+//
+// Returns the heap memory a string owns.  A short string keeps its
+// characters inside the string object, which is told apart by where its
+// characters are.
+//
+// Input:
+//		value	[IN] - the string
+//
+// Output:
+//		size_t  -  the number of bytes
+//
+// ============================================================================
+size_t HeapBytes(const string &value)
+{
+	const char *objectStart = reinterpret_cast<const char*>(&value);
+	const char *objectEnd = objectStart + sizeof(value);
+
+	if (value.data() >= objectStart && value.data() < objectEnd)
+	{
+		return 0;
+	}
+
+	return value.capacity() + 1;
+}
+
+
+
+// ==== AllocatedBytes ========================================================
+//
+// Returns what the allocator set aside for a block.  glibc reports the
+// usable size of a block, which is at least the size asked for, and keeps
+// one size_t header in front of it.
+//
+// Input:
+//		blockPtr	[IN] - the block
+//		size		[IN] - the size that was asked for
+//
+// Output:
+//		size_t  -  the number of bytes
+//
+// ============================================================================
+size_t AllocatedBytes(const void *blockPtr, size_t size)
+{
+#if defined(__GLIBC__)
+	(void)size;
+	return malloc_usable_size(const_cast<void*>(blockPtr)) + sizeof(size_t);
+#else
+	(void)blockPtr;
+	return size;
+#endif
+}
@@ -0,0 +1,95 @@
+// ============================================================================
+// File: CTreeStats.h
+// ============================================================================
+// Header file for the struct CTreeStats, the shape and memory report that
+// Stats() returns (see CBinaryNodeTree), and for the HeapBytes functions it
+// uses to find the memory an item owns outside the node.
+//
+// A class that owns heap memory provides its own HeapBytes overload next to
+// its declaration (see CPersonInfo.h); every other item counts as owning
+// none.
+// ============================================================================
+
+#ifndef CTREESTATS_HEADER
+#define CTREESTATS_HEADER
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/** The shape of a tree and the memory its nodes use. */
+struct CTreeStats
+{
+   /** Describes an empty tree. */
+   CTreeStats();
+
+   /** Formats the report, one figure per line, followed by the depth and
+       balance factor histograms.
+    @param Nothing.
+    @return  The report. */
+   std::string ToText() const;
+
+   // =========================================================================
+   //      Shape
+   // =========================================================================
+
+   long long               m_nodeCount;
+   int                     m_height;
+
+   // m_depthHistogram[d] is the number of nodes at depth d (the root is at
+   // depth 0), so it has m_height entries
+   std::vector<long long>  m_depthHistogram;
+
+   // Nodes compared by a search that finds an item, averaged over the items
+   // and at worst; the worst is the height
+   double                  m_averagePathLength;
+   int                     m_worstPathLength;
+
+   // Number of nodes with each balance factor (height of the left subtree
+   // minus height of the right subtree)
+   std::map<int, long long>   m_balanceFactors;
+
+   // =========================================================================
+   //      Memory
+   // =========================================================================
+
+   size_t   m_nodeBytes;         // Node objects, items included
+   size_t   m_payloadBytes;      // The items inside the node objects
+   size_t   m_payloadHeapBytes;  // Heap memory the items own (HeapBytes)
+   size_t   m_allocatedBytes;    // What the allocator set aside for nodes
+
+   // Share of m_allocatedBytes not holding node objects: the allocator's
+   // headers and the rounding of every node up to its size classes
+   double   m_fragmentation;
+}; // end CTreeStats
+
+// =========================================================================
+//      Memory accounting functions
+// =========================================================================
+
+/** Returns the heap memory an item owns outside of itself.  Overloaded by
+    classes that own any; every other item owns none.
+    @param item: The item.
+    @return  The number of bytes. */
+template<class ItemType>
+size_t HeapBytes(const ItemType &)
+{
+   return 0;
+}
+
+/** Returns the heap memory a string owns: none while its characters fit
+    inside the string object, otherwise its capacity.
+    @param value: The string.
+    @return  The number of bytes. */
+size_t HeapBytes(const std::string &value);
+
+/** Returns what the allocator set aside for a block from operator new,
+    including its own header.  Without a way to ask the allocator (outside
+    glibc) this is just the size asked for.
+    @param blockPtr: The block.
+    @param size: The size that was asked for.
+    @return  The number of bytes. */
+size_t AllocatedBytes(const void *blockPtr, size_t size);
+
+#endif  // CTREESTATS_HEADER
@@ -0,0 +1,184 @@
+// ============================================================================
+// File: CWalBST.h
+// ============================================================================
+// Header file for the class CWalBST (CBST made durable by a write-ahead log)
+// ============================================================================
+
+#ifndef CWALBST_HEADER
+#define CWALBST_HEADER
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CBST.h"
+
+// =========================================================================
+//      Write-ahead log settings
+// =========================================================================
+
+/** When queued log records are written.  With the defaults every mutation
+    is durable before it returns.  With grouping, a mutation is applied to
+    the tree (and seen by readers) as soon as its record is queued, and is
+    durable once its group is written: when m_groupRecords records have
+    queued up, or m_groupMillis after the oldest of them was queued (a
+    background thread writes an idle log), or on Sync, Compact or Close.  A
+    crash before then loses the queued mutations. */
+struct CWalPolicy
+{
+   /** Defaults to making every mutation durable before it returns. */
+   CWalPolicy(int groupRecords = 1, int groupMillis = 0, bool sync = true)
+      : m_groupRecords(groupRecords), m_groupMillis(groupMillis),
+        m_sync(sync)
+   {
+   }
+
+   int    m_groupRecords;   // Write the log once this many records queue up
+   int    m_groupMillis;    // ...or the oldest is this old (0 = no limit)
+   bool   m_sync;           // Call fdatasync after each write of the log
+};
+
+template<class ItemType>
+class CWalBST
+{
+public:
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Creates a log-backed tree that is not attached to any files yet. */
+   CWalBST(const CWalPolicy &policy = CWalPolicy());
+
+   /** Destructor.  Writes any queued records and closes the log. */
+   ~CWalBST();
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Recovers the tree: loads the snapshot (a missing snapshot is an empty
+       tree), then replays the log on top of it.  A torn record at the end of
+       the log, left by a crash in the middle of a write, is cut off.
+    @param snapshotPath: The snapshot written by Compact.
+    @param walPath: The log file.  It is created if it does not exist.
+    @return  True if the tree was recovered, or false if a file could not be
+             opened or the snapshot is corrupt. */
+   bool Open(const std::string &snapshotPath, const std::string &walPath);
+
+   /** Writes any queued records and closes the log.
+    @param Nothing.
+    @return  Nothing. */
+   void Close();
+
+   /** Logs an Add record and then adds the item to the tree.
+    @param newEntry: The item to add.
+    @return  True if the item was logged and added, or false if the log
+             could not be written. */
+   bool Add(const ItemType &newEntry);
+
+   /** Logs a Remove record and then removes the item from the tree.  Nothing
+       is logged if the item is not in the tree.
+    @param anEntry: The item to remove.
+    @return  True if the item was removed, or false if it was not in the tree
+             or the log could not be written. */
+   bool Remove(const ItemType &anEntry);
+
+   /** Writes and syncs every queued record, regardless of the policy.
+    @param Nothing.
+    @return  True if the log was written, or false if it could not be. */
+   bool Sync();
+
+   /** Folds the log into a new snapshot and starts an empty log.
+    @param Nothing.
+    @return  True if the snapshot was written, or false if it could not be. */
+   bool Compact();
+
+   /** Gives read access to the recovered tree.
+    @param Nothing.
+    @return  A const reference to the tree. */
+   const CBST<ItemType>& GetTree() const;
+
+   /** Returns the number of records written to the log since it was last
+       compacted.
+    @param Nothing.
+    @return  The number of records in the log. */
+   long long GetLogRecords() const;
+
+private:
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** Queues a record and writes the queue when the policy says so.
+    @param op: WAL_OP_ADD or WAL_OP_REMOVE.
+    @param item: The item the record is about.
+    @return  True if the record was queued (and written if required). */
+   bool AppendRecord(unsigned char op, const ItemType &item);
+
+   /** Writes the queued records with one write call and syncs them.
+    @param Nothing.
+    @return  True if the log was written, or false if it could not be. */
+   bool WritePending();
+
+   /** Runs on the flusher thread: writes the queue once its oldest record is
+       m_groupMillis old, so an idle log still becomes durable.
+    @param Nothing.
+    @return  Nothing. */
+   void FlushLoop();
+
+   /** Replays the records of a log file into the tree.
+    @param buffer: The contents of the log file.
+    @param validBytes: Receives the size of the valid prefix of the log.
+    @return  True if the log belongs to the loaded snapshot. */
+   bool Replay(const std::string &buffer, size_t &validBytes);
+
+   /** Applies a run of consecutive records of one kind to the tree with a
+       single AddBatch or RemoveBatch.
+    @param op: WAL_OP_ADD or WAL_OP_REMOVE.
+    @param run: The items of the records.  It is emptied.
+    @return  Nothing. */
+   void ApplyRun(unsigned char op, std::vector<ItemType> &run);
+
+   /** Replaces the log with an empty one whose header names the current
+       snapshot.
+    @param Nothing.
+    @return  True if the log was replaced, or false if it could not be. */
+   bool ResetLog();
+
+   /** Reads the checksum stored at the end of a snapshot file.
+    @param path: The snapshot file.
+    @param checksum: Receives the checksum (that of an empty tree if the
+                     file does not exist).
+    @return  True if the checksum was read or the file does not exist. */
+   static bool ReadSnapshotChecksum(const std::string &path,
+                                    unsigned long long &checksum);
+
+   /** Copying would share the log file; disallow it. */
+   CWalBST(const CWalBST<ItemType> &tree);
+   CWalBST<ItemType>& operator=(const CWalBST<ItemType> &rhs);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   CBST<ItemType>          m_tree;           // The in-memory tree
+   CWalPolicy              m_policy;         // When to write and sync
+   std::string             m_snapshotPath;
+   std::string             m_walPath;
+   int                     m_walFd;          // Log file, opened for append
+   unsigned long long      m_baseChecksum;   // Snapshot the log applies to
+   std::string             m_pending;        // Encoded records not written
+   int                     m_pendingRecords;
+   std::chrono::steady_clock::time_point m_pendingSince;
+   long long               m_logRecords;
+   mutable std::mutex      m_mutex;
+   std::condition_variable m_flushWake;      // Records queued, or stopping
+   std::thread             m_flusher;        // Writes groups past their age
+   bool                    m_stopFlusher;
+}; // end CWalBST
+
+#include "CWalBST.tpp"
+
+#endif  // CWALBST_HEADER
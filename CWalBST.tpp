@@ -0,0 +1,687 @@
+// ============================================================================
+// File: CWalBST.tpp
+// ============================================================================
+// This is the implementation file for the class CWalBST which impliments a
+// CBST whose mutations are recorded in an append-only log before they are
+// applied.  The log file layout is:
+//
+//		header	magic "CBSTWAL1" | snapshot checksum (u64)
+//		record	length (u32) | op (u8) | item | checksum of op + item (u64)
+//
+// The header names the snapshot the log applies to (by the checksum stored
+// at the end of the snapshot file).  Compact writes the new snapshot first
+// and then replaces the log, so if it is interrupted between the two steps,
+// recovery sees a log that belongs to an older snapshot and drops it instead
+// of applying its records twice.
+// ============================================================================
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "CWalBST.h"
+
+const char           WAL_MAGIC[] = "CBSTWAL1";
+const size_t         WAL_MAGIC_SIZE = 8;
+const size_t         WAL_HEADER_SIZE = 16;
+const unsigned char  WAL_OP_ADD = 1;
+const unsigned char  WAL_OP_REMOVE = 2;
+
+
+
+// ==== Type Constructor ======================================================
+//
+// Creates a log-backed tree that is not attached to any files yet.
+//
+// Input:
+//		policy	[IN] - when queued records are written and synced
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CWalBST<ItemType>::CWalBST(const CWalPolicy &policy) : m_policy(policy),
+							m_walFd(-1), m_baseChecksum(0),
+							m_pendingRecords(0), m_logRecords(0),
+							m_stopFlusher(false)
+{
+	if (m_policy.m_groupRecords < 1)
+	{
+		m_policy.m_groupRecords = 1;
+	}
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Writes any queued records and closes the log.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+CWalBST<ItemType>::~CWalBST()
+{
+	Close();
+}
+
+
+
+// ==== Open ==================================================================
+//
+// Recovers the tree from the snapshot and the log.
+//
+// Input:
+//		snapshotPath	[IN] - the snapshot written by Compact
+//		walPath			[IN] - the log file; created if missing
+//
+// Output:
+//		bool  -  True if the tree was recovered, false if a file could not be
+//				 opened or the snapshot is corrupt
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Open(const std::string &snapshotPath,
+							 const std::string &walPath)
+{
+	Close();
+
+	//groups of one record are written as they are queued; larger groups
+	//need a thread to write them once they age past m_groupMillis
+	if (m_policy.m_groupRecords > 1 && m_policy.m_groupMillis > 0)
+	{
+		m_stopFlusher = false;
+		m_flusher = std::thread(&CWalBST<ItemType>::FlushLoop, this);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_snapshotPath = snapshotPath;
+	m_walPath = walPath;
+	m_logRecords = 0;
+
+	//load the snapshot; a missing one is an empty tree
+	if (!ReadSnapshotChecksum(snapshotPath, m_baseChecksum))
+	{
+		return false;
+	}
+	if (access(snapshotPath.c_str(), F_OK) == 0)
+	{
+		if (!m_tree.Load(snapshotPath))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		m_tree.Clear();
+	}
+
+	//replay the log and cut off anything after the last whole record
+	std::string buffer;
+	size_t validBytes = 0;
+	bool haveLog = SnapshotReadFile(walPath, buffer);
+	if (!haveLog || !Replay(buffer, validBytes))
+	{
+		return ResetLog();
+	}
+
+	m_walFd = open(walPath.c_str(), O_WRONLY | O_APPEND);
+	if (m_walFd < 0)
+	{
+		return false;
+	}
+	if (validBytes < buffer.size())
+	{
+		if (ftruncate(m_walFd, (off_t)validBytes) != 0 ||
+			fsync(m_walFd) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+// ==== Close =================================================================
+//
+// Stops the flusher thread, writes any queued records and closes the log.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CWalBST<ItemType>::Close()
+{
+	if (m_flusher.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopFlusher = true;
+		}
+		m_flushWake.notify_one();
+		m_flusher.join();
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_walFd >= 0)
+	{
+		WritePending();
+		close(m_walFd);
+		m_walFd = -1;
+	}
+}
+
+
+
+// ==== Add ===================================================================
+//
+// Logs an Add record and then adds the item to the tree.
+//
+// Input:
+//		newEntry	[IN] - the item to add
+//
+// Output:
+//		bool  -  True if the item was logged and added, false if the log could
+//				 not be written
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Add(const ItemType &newEntry)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!AppendRecord(WAL_OP_ADD, newEntry))
+	{
+		return false;
+	}
+
+	return m_tree.Add(newEntry);
+}
+
+
+
+// ==== Remove ================================================================
+//
+// Logs a Remove record and then removes the item from the tree.
+//
+// Input:
+//		anEntry	[IN] - the item to remove
+//
+// Output:
+//		bool  -  True if the item was removed, false if it was not in the
+//				 tree or the log could not be written
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Remove(const ItemType &anEntry)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_tree.Contains(anEntry) || !AppendRecord(WAL_OP_REMOVE, anEntry))
+	{
+		return false;
+	}
+
+	return m_tree.Remove(anEntry);
+}
+
+
+
+// ==== Sync ==================================================================
+//
+// Writes and syncs every queued record, regardless of the policy.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if the log was written, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Sync()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!WritePending())
+	{
+		return false;
+	}
+
+	return m_policy.m_sync || m_walFd < 0 || fdatasync(m_walFd) == 0;
+}
+
+
+
+// ==== Compact ===============================================================
+//
+// Folds the log into a new snapshot and starts an empty log.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if the snapshot was written, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Compact()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_walFd < 0 || !WritePending())
+	{
+		return false;
+	}
+
+	if (!m_tree.Save(m_snapshotPath) ||
+		!ReadSnapshotChecksum(m_snapshotPath, m_baseChecksum))
+	{
+		return false;
+	}
+
+	close(m_walFd);
+	m_walFd = -1;
+
+	return ResetLog();
+}
+
+
+
+// ==== GetTree ===============================================================
+//
+// Gives read access to the recovered tree.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CBST  -  a const reference to the tree
+//
+// ============================================================================
+template<class ItemType>
+const CBST<ItemType>& CWalBST<ItemType>::GetTree() const
+{
+	return m_tree;
+}
+
+
+
+// ==== GetLogRecords =========================================================
+//
+// Returns the number of records written to the log since it was last
+// compacted.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		long long  -  the number of records in the log
+//
+// ============================================================================
+template<class ItemType>
+long long CWalBST<ItemType>::GetLogRecords() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_logRecords + m_pendingRecords;
+}
+
+
+
+// ==== AppendRecord ==========================================================
+//
+// Queues a record and writes the queue once it holds m_groupRecords records
+// or its oldest record is m_groupMillis old, so several mutations share one
+// write and one sync (group commit).  The first record of a group wakes the
+// flusher thread, which writes the group if nothing else comes along.
+//
+// Input:
+//		op		[IN] - WAL_OP_ADD or WAL_OP_REMOVE
+//		item	[IN] - the item the record is about
+//
+// Output:
+//		bool  -  True if the record was queued (and written if required)
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::AppendRecord(unsigned char op, const ItemType &item)
+{
+	if (m_walFd < 0)
+	{
+		return false;
+	}
+
+	std::string body;
+	body.push_back((char)op);
+	SnapshotWrite(body, item);
+
+	SnapshotWrite(m_pending, (unsigned int)(body.size() - 1));
+	m_pending.append(body);
+	SnapshotWrite(m_pending, SnapshotChecksum(body.data(), body.size()));
+
+	if (m_pendingRecords == 0)
+	{
+		m_pendingSince = std::chrono::steady_clock::now();
+		m_flushWake.notify_one();
+	}
+	++m_pendingRecords;
+
+	if (m_pendingRecords >= m_policy.m_groupRecords ||
+		(m_policy.m_groupMillis > 0 &&
+		 std::chrono::steady_clock::now() - m_pendingSince >=
+			std::chrono::milliseconds(m_policy.m_groupMillis)))
+	{
+		return WritePending();
+	}
+
+	return true;
+}
+
+
+
+// ==== WritePending ==========================================================
+//
+// Writes the queued records with one write call and syncs them if the policy
+// asks for it.  If the log cannot be written it is closed, the queued records
+// are dropped and every later mutation fails until the tree is reopened, so
+// nothing is ever applied without being logged.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if the log was written, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::WritePending()
+{
+	if (m_pendingRecords == 0)
+	{
+		return true;
+	}
+	if (m_walFd < 0)
+	{
+		return false;
+	}
+
+	const char *pos = m_pending.data();
+	size_t left = m_pending.size();
+	while (left > 0)
+	{
+		ssize_t written = write(m_walFd, pos, left);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+		pos += written;
+		left -= (size_t)written;
+	}
+
+	if (left > 0 || (m_policy.m_sync && fdatasync(m_walFd) != 0))
+	{
+		close(m_walFd);
+		m_walFd = -1;
+		m_pending.clear();
+		m_pendingRecords = 0;
+		return false;
+	}
+
+	m_logRecords += m_pendingRecords;
+	m_pending.clear();
+	m_pendingRecords = 0;
+
+	return true;
+}
+
+
+
+// ==== FlushLoop =============================================================
+//
+// Runs on the flusher thread until Close.  Sleeps while the queue is empty,
+// and otherwise until the oldest queued record is m_groupMillis old, then
+// writes the queue if AppendRecord has not already done so.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CWalBST<ItemType>::FlushLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (!m_stopFlusher)
+	{
+		if (m_pendingRecords == 0)
+		{
+			m_flushWake.wait(lock);
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point deadline = m_pendingSince +
+						std::chrono::milliseconds(m_policy.m_groupMillis);
+		if (std::chrono::steady_clock::now() < deadline)
+		{
+			m_flushWake.wait_until(lock, deadline);
+			continue;
+		}
+
+		//a failed write closes the log, so the queue is empty either way
+		WritePending();
+	}
+}
+
+
+
+// ==== Replay ================================================================
+//
+// Replays the records of a log file into the tree, stopping at the first
+// record that is short or fails its checksum.
+//
+// Input:
+//		buffer		[IN] - the contents of the log file
+//		validBytes	[OUT] - receives the size of the valid prefix of the log
+//
+// Output:
+//		bool  -  True if the log belongs to the loaded snapshot
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::Replay(const std::string &buffer, size_t &validBytes)
+{
+	const char *start = buffer.data();
+	const char *pos = start;
+	const char *end = start + buffer.size();
+	unsigned long long base;
+
+	validBytes = 0;
+	if (buffer.size() < WAL_HEADER_SIZE ||
+		memcmp(pos, WAL_MAGIC, WAL_MAGIC_SIZE) != 0)
+	{
+		return false;
+	}
+	pos += WAL_MAGIC_SIZE;
+	if (!SnapshotRead(pos, end, base) || base != m_baseChecksum)
+	{
+		return false;
+	}
+	validBytes = WAL_HEADER_SIZE;
+
+	//consecutive records of one kind are applied together with one rebuild
+	std::vector<ItemType> run;
+	unsigned char runOp = WAL_OP_ADD;
+
+	for (;;)
+	{
+		unsigned int length;
+		unsigned long long checksum;
+		if (!SnapshotRead(pos, end, length) ||
+			(size_t)(end - pos) < (size_t)length + 1 + sizeof(checksum))
+		{
+			break;
+		}
+
+		const char *body = pos;
+		pos += length + 1;
+		if (!SnapshotRead(pos, end, checksum) ||
+			checksum != SnapshotChecksum(body, (size_t)length + 1))
+		{
+			break;
+		}
+
+		ItemType item;
+		const char *itemPos = body + 1;
+		if (!SnapshotRead(itemPos, body + 1 + length, item))
+		{
+			break;
+		}
+
+		unsigned char op = (unsigned char)body[0];
+		if (op != WAL_OP_ADD && op != WAL_OP_REMOVE)
+		{
+			break;
+		}
+
+		if (op != runOp)
+		{
+			ApplyRun(runOp, run);
+			runOp = op;
+		}
+		run.push_back(item);
+
+		++m_logRecords;
+		validBytes = (size_t)(pos - start);
+	}
+	ApplyRun(runOp, run);
+
+	return true;
+}
+
+
+
+// ==== ApplyRun ==============================================================
+//
+// Applies a run of consecutive log records of one kind to the tree with a
+// single AddBatch or RemoveBatch, which is what replaying them one at a
+// time amounts to, and empties the run.
+//
+// Input:
+//		op	[IN] - WAL_OP_ADD or WAL_OP_REMOVE
+//		run	[IN/OUT] - the items of the records; emptied
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void CWalBST<ItemType>::ApplyRun(unsigned char op, std::vector<ItemType> &run)
+{
+	if (run.empty())
+	{
+		return;
+	}
+
+	if (op == WAL_OP_ADD)
+	{
+		m_tree.AddBatch(&run[0], (int)run.size());
+	}
+	else
+	{
+		m_tree.RemoveBatch(&run[0], (int)run.size());
+	}
+	run.clear();
+}
+
+
+
+// ==== ResetLog ==============================================================
+//
+// Replaces the log with an empty one whose header names the current snapshot
+// and opens it for appending.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if the log was replaced, false if it could not be
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::ResetLog()
+{
+	std::string header(WAL_MAGIC, WAL_MAGIC_SIZE);
+	SnapshotWrite(header, m_baseChecksum);
+
+	if (!SnapshotWriteFile(m_walPath, header))
+	{
+		return false;
+	}
+
+	m_logRecords = 0;
+	m_walFd = open(m_walPath.c_str(), O_WRONLY | O_APPEND);
+
+	return m_walFd >= 0;
+}
+
+
+
+// ==== ReadSnapshotChecksum ==================================================
+//
+// Reads the checksum stored in the last 8 bytes of a snapshot file.
+//
+// Input:
+//		path		[IN] - the snapshot file
+//		checksum	[OUT] - receives the checksum (that of an empty tree if
+//							the file does not exist)
+//
+// Output:
+//		bool  -  True if the checksum was read or the file does not exist
+//
+// ============================================================================
+template<class ItemType>
+bool CWalBST<ItemType>::ReadSnapshotChecksum(const std::string &path,
+											 unsigned long long &checksum)
+{
+	if (access(path.c_str(), F_OK) != 0)
+	{
+		checksum = SnapshotChecksum(nullptr, 0);
+		return errno == ENOENT;
+	}
+
+	std::ifstream inFile(path.c_str(), std::ios::in | std::ios::binary);
+
+	char bytes[sizeof(checksum)];
+	inFile.seekg(-(std::streamoff)sizeof(checksum), std::ios::end);
+	inFile.read(bytes, sizeof(checksum));
+	if (inFile.fail())
+	{
+		return false;
+	}
+
+	memcpy(&checksum, bytes, sizeof(checksum));
+
+	return true;
+}
@@ -0,0 +1,339 @@
+// ============================================================================
+// File: CWorkPool.cpp
+// ============================================================================
+// Implimentation file for the class CWorkPool
+// ============================================================================
+
+#include <algorithm>
+#include <thread>
+using namespace std;
+#include "CWorkPool.h"
+
+
+
+// ==== Constructor ===========================================================
+//
+// Starts the worker threads.  Worker 0 is whichever thread calls Run, so
+// one thread fewer than the number of workers is started.
+//
+// Input:
+//		workerCount	[IN] - the number of workers, 0 for one per hardware
+//						   thread
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CWorkPool::CWorkPool(int workerCount)
+	: m_workerCount(workerCount > 0 ? workerCount :
+					(int)max(1u, thread::hardware_concurrency())),
+	  m_queues(new CWorkerQueue[m_workerCount]), m_pending(0), m_queued(0),
+	  m_idle(0), m_generation(0), m_stopping(false)
+{
+	for (int worker = 1; worker < m_workerCount; ++worker)
+	{
+		m_threads.push_back(thread(&CWorkPool::WorkerLoop, this, worker));
+	}
+}
+
+
+
+// ==== Destructor ============================================================
+//
+// Stops and joins the worker threads.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+CWorkPool::~CWorkPool()
+{
+	{
+		lock_guard<mutex> lock(m_wakeLock);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for (size_t index = 0; index < m_threads.size(); ++index)
+	{
+		m_threads[index].join();
+	}
+}
+
+
+
+// ==== Run ===================================================================
+//
+// Runs a task, and every task it spawns, on the workers, the calling thread
+// among them, and returns once all of them have finished.
+//
+// Input:
+//		task	[IN] - the first task
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CWorkPool::Run(const TaskType &task)
+{
+	lock_guard<mutex> runLock(m_runLock);
+
+	m_pending.store(1, memory_order_relaxed);
+	m_queued.fetch_add(1, memory_order_relaxed);
+	{
+		lock_guard<mutex> lock(m_queues[0].m_lock);
+		m_queues[0].m_tasks.push_back(task);
+	}
+	{
+		lock_guard<mutex> lock(m_wakeLock);
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	WorkUntilDone(0);
+
+	exception_ptr error;
+	{
+		lock_guard<mutex> lock(m_errorLock);
+		error = m_error;
+		m_error = nullptr;
+	}
+	if (error)
+	{
+		rethrow_exception(error);
+	}
+}
+
+
+
+// ==== Spawn =================================================================
+//
+// Queues a task on a worker's deque.
+//
+// Input:
+//		worker	[IN] - the index of the worker spawning the task
+//		task	[IN] - the task
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CWorkPool::Spawn(int worker, TaskType task)
+{
+	//counted before it is queued, so m_pending cannot reach 0 while it waits
+	m_pending.fetch_add(1, memory_order_relaxed);
+	m_queued.fetch_add(1, memory_order_relaxed);
+
+	lock_guard<mutex> lock(m_queues[worker].m_lock);
+	m_queues[worker].m_tasks.push_back(std::move(task));
+}
+
+
+
+// ==== HasIdleWorkers ========================================================
+//
+// Reports whether more workers are searching for work than there are
+// queued tasks for them to find.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		bool  -  True if splitting off a task would put a worker to use
+//
+// ============================================================================
+bool CWorkPool::HasIdleWorkers() const
+{
+	return m_idle.load(memory_order_relaxed) >
+		   m_queued.load(memory_order_relaxed);
+}
+
+
+
+// ==== GetWorkerCount ========================================================
+//
+// Returns the number of workers.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		int  -  the number of workers, counting the thread that calls Run
+//
+// ============================================================================
+int CWorkPool::GetWorkerCount() const
+{
+	return m_workerCount;
+}
+
+
+
+// ==== WorkerLoop ============================================================
+//
+// The loop of a pooled thread: sleeps until a Run starts or the pool
+// stops, and works on each Run until it is done.
+//
+// Input:
+//		worker	[IN] - the index of the worker
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CWorkPool::WorkerLoop(int worker)
+{
+	unsigned long long seenGeneration = 0;
+
+	for (;;)
+	{
+		{
+			unique_lock<mutex> lock(m_wakeLock);
+			m_wake.wait(lock, [this, seenGeneration]()
+			{
+				return m_stopping || m_generation != seenGeneration;
+			});
+			if (m_stopping)
+			{
+				return;
+			}
+			seenGeneration = m_generation;
+		}
+
+		WorkUntilDone(worker);
+	}
+}
+
+
+
+// ==== WorkUntilDone =========================================================
+//
+// Runs tasks until every task of the current Run has finished, yielding
+// while there is none to take.  A task that throws is counted as finished;
+// the first exception is kept for Run to rethrow.
+//
+// Input:
+//		worker	[IN] - the index of the worker
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void CWorkPool::WorkUntilDone(int worker)
+{
+	TaskType task;
+	bool idle = false;
+
+	while (m_pending.load(memory_order_acquire) > 0)
+	{
+		if (!TakeTask(worker, task))
+		{
+			if (!idle)
+			{
+				m_idle.fetch_add(1, memory_order_relaxed);
+				idle = true;
+			}
+			this_thread::yield();
+			continue;
+		}
+
+		if (idle)
+		{
+			m_idle.fetch_sub(1, memory_order_relaxed);
+			idle = false;
+		}
+		try
+		{
+			task(worker);
+		}
+		catch (...)
+		{
+			lock_guard<mutex> lock(m_errorLock);
+			if (!m_error)
+			{
+				m_error = current_exception();
+			}
+		}
+		task = nullptr;
+
+		//publishes what the task wrote to whoever sees m_pending reach 0
+		m_pending.fetch_sub(1, memory_order_acq_rel);
+	}
+
+	if (idle)
+	{
+		m_idle.fetch_sub(1, memory_order_relaxed);
+	}
+}
+
+
+
+// ==== TakeTask ==============================================================
+//
+// Takes the newest task of the worker's own deque, or else the oldest task
+// of the first other worker's deque that has one.
+//
+// Input:
+//		worker	[IN] - the index of the worker
+//		task	[OUT] - receives the task
+//
+// Output:
+//		bool  -  True if a task was found
+//
+// ============================================================================
+bool CWorkPool::TakeTask(int worker, TaskType &task)
+{
+	{
+		CWorkerQueue &own = m_queues[worker];
+		lock_guard<mutex> lock(own.m_lock);
+		if (!own.m_tasks.empty())
+		{
+			task = std::move(own.m_tasks.back());
+			own.m_tasks.pop_back();
+			m_queued.fetch_sub(1, memory_order_relaxed);
+			return true;
+		}
+	}
+
+	for (int offset = 1; offset < m_workerCount; ++offset)
+	{
+		CWorkerQueue &victim = m_queues[(worker + offset) % m_workerCount];
+		lock_guard<mutex> lock(victim.m_lock);
+		if (!victim.m_tasks.empty())
+		{
+			task = std::move(victim.m_tasks.front());
+			victim.m_tasks.pop_front();
+			m_queued.fetch_sub(1, memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+// =========================================================================
+//      Shared pool
+// =========================================================================
+
+// ==== DefaultWorkPool =======================================================
+//
+// Returns the pool the parallel traversals use unless told otherwise.  It
+// is never destroyed, so its threads are not joined while static objects
+// are being destroyed.
+//
+// Input:
+//		nothing
+//
+// Output:
+//		CWorkPool&  -  the pool
+//
+// ============================================================================
+CWorkPool& DefaultWorkPool()
+{
+	static CWorkPool *poolPtr = new CWorkPool;
+	return *poolPtr;
+}
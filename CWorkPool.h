@@ -0,0 +1,142 @@
+// ============================================================================
+// File: CWorkPool.h
+// ============================================================================
+// Header file for the class CWorkPool, the work-stealing thread pool behind
+// the parallel traversals (CBST::ParallelForEach and ParallelReduce).
+//
+// Every worker, the thread that calls Run among them, owns a deque of
+// tasks.  A worker takes the newest task from its own deque and, when that
+// is empty, steals the oldest task from another worker's, so the big tasks
+// split off early in a traversal are the ones that move between threads.
+// Tasks split off more work with Spawn while HasIdleWorkers says another
+// worker would take it.  The deques are guarded by a lock each; the tree
+// being walked is not locked at all.
+// ============================================================================
+
+#ifndef CWORKPOOL_HEADER
+#define CWORKPOOL_HEADER
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Items a parallel traversal task visits before it offers to split off
+// work, unless the caller asks for another grain size
+const int            PARALLEL_GRAIN_SIZE = 1024;
+
+class CWorkPool
+{
+public:
+   // A task receives the index of the worker running it, from 0 to
+   // GetWorkerCount() - 1, so it can keep results per worker without locks
+   typedef std::function<void(int worker)> TaskType;
+
+   // =========================================================================
+   //      Constructors and Destructor
+   // =========================================================================
+
+   /** Starts the worker threads.
+    @param workerCount: The number of workers, counting the thread that
+                        calls Run; 0 for one per hardware thread. */
+   explicit CWorkPool(int workerCount = 0);
+
+   /** Stops and joins the worker threads. */
+   ~CWorkPool();
+
+   CWorkPool(const CWorkPool &other) = delete;
+   CWorkPool& operator=(const CWorkPool &rhs) = delete;
+
+   // =========================================================================
+   //      Member Functions
+   // =========================================================================
+
+   /** Runs a task, and every task it spawns, on the workers; the calling
+       thread works as worker 0.  Runs on one pool do not overlap, and a
+       task must not call Run on its own pool.
+    @param task: The first task.
+    @return  Nothing.
+    @throw   Whatever the first task to throw threw, once every task has
+             finished. */
+   void Run(const TaskType &task);
+
+   /** Queues a task on a worker's deque; for use by running tasks.
+    @param worker: The index of the worker spawning the task.
+    @param task: The task.
+    @return  Nothing. */
+   void Spawn(int worker, TaskType task);
+
+   /** Reports whether a worker is looking for work that no queued task
+       will give it; a cheap test for tasks deciding whether to split.
+    @param Nothing.
+    @return  True if splitting off a task would put a worker to use. */
+   bool HasIdleWorkers() const;
+
+   /** Returns the number of workers, counting the thread that calls Run.
+    @param Nothing.
+    @return  The number of workers. */
+   int GetWorkerCount() const;
+
+private:
+   // The deque of one worker, padded so workers do not share cache lines
+   struct alignas(64) CWorkerQueue
+   {
+      std::mutex              m_lock;
+      std::deque<TaskType>    m_tasks;
+   };
+
+   // =========================================================================
+   //      Private Member Functions
+   // =========================================================================
+
+   /** The loop of a pooled thread: waits for a Run, works on it, repeats.
+    @param worker: The index of the worker, 1 or more.
+    @return  Nothing. */
+   void WorkerLoop(int worker);
+
+   /** Runs tasks until every task of the current Run has finished.
+    @param worker: The index of the worker.
+    @return  Nothing. */
+   void WorkUntilDone(int worker);
+
+   /** Takes the newest task of the worker's own deque, or else steals the
+       oldest of another worker's.
+    @param worker: The index of the worker.
+    @param task: Receives the task.
+    @return  True if a task was found. */
+   bool TakeTask(int worker, TaskType &task);
+
+   // =========================================================================
+   //      Data Members
+   // =========================================================================
+
+   int                                       m_workerCount;
+   std::unique_ptr<CWorkerQueue[]>           m_queues;
+   std::vector<std::thread>                  m_threads;
+
+   std::atomic<long long>                    m_pending;  // Unfinished tasks
+   std::atomic<int>                          m_queued;   // Tasks not taken
+   std::atomic<int>                          m_idle;     // Workers searching
+
+   std::mutex                                m_runLock;  // One Run at a time
+   std::mutex                                m_wakeLock;
+   std::condition_variable                   m_wake;
+   unsigned long long                        m_generation;  // Runs started
+   bool                                      m_stopping;
+
+   std::mutex                                m_errorLock;
+   std::exception_ptr                        m_error;
+}; // end CWorkPool
+
+/** Returns the pool the parallel traversals use unless told otherwise, one
+    worker per hardware thread, started on first use.
+    @param Nothing.
+    @return  The shared pool. */
+CWorkPool& DefaultWorkPool();
+
+#endif  // CWORKPOOL_HEADER
@@ -0,0 +1,83 @@
+// ============================================================================
+// File: BatchLookupBench.cpp
+// ============================================================================
+// Compares one-at-a-time CBST::Contains with CBST::ContainsBatch on a tree
+// much larger than the last level cache, looking up random keys of which
+// about half are in the tree.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/BatchLookupBench.cpp CSnapshotIO.cpp
+//			NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of items in the tree (default 8M)
+//		argv[2]	[IN] - number of lookups (default 4M)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (8 << 20);
+	int lookupCount = (argc > 2) ? atoi(argv[2]) : (4 << 20);
+
+	//even keys are in the tree, odd keys are not
+	vector<int> items(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		items[index] = 2 * index;
+	}
+	CBST<int> tree;
+	tree.BuildFromSortedArray(&items[0], itemCount);
+
+	mt19937 generator(12345);
+	uniform_int_distribution<int> distribution(0, 2 * itemCount - 1);
+	vector<int> keys(lookupCount);
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		keys[index] = distribution(generator);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long serialHits = 0;
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		serialHits += tree.Contains(keys[index]) ? 1 : 0;
+	}
+	chrono::duration<double> serial = chrono::steady_clock::now() - start;
+
+	bool *results = new bool[lookupCount];
+	start = chrono::steady_clock::now();
+	tree.ContainsBatch(&keys[0], lookupCount, results);
+	chrono::duration<double> batched = chrono::steady_clock::now() - start;
+
+	long long batchHits = 0;
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		batchHits += results[index] ? 1 : 0;
+	}
+	delete [] results;
+
+	cout << "items: " << itemCount << ", lookups: " << lookupCount << endl;
+	cout << "Contains:      " << lookupCount / serial.count() / 1e6
+		 << " M lookups/s (" << serialHits << " hits)" << endl;
+	cout << "ContainsBatch: " << lookupCount / batched.count() / 1e6
+		 << " M lookups/s (" << batchHits << " hits)" << endl;
+	cout << "speedup:       " << serial.count() / batched.count() << "x"
+		 << endl;
+
+	return (serialHits == batchHits) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
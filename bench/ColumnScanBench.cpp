@@ -0,0 +1,166 @@
+// ============================================================================
+// File: ColumnScanBench.cpp
+// ============================================================================
+// Times the report "total savings of everyone older than 65" over a
+// CBST<CPersonInfo> three ways: an InorderTraverse whose visitor adds up the
+// balances, an ExportColumns followed by a scan of the columns, and the
+// scan alone, as when the columns are exported once for many reports.  A
+// plain loop over the columns is timed as well, to show what the scan
+// kernels add over reading the columns in order.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/ColumnScanBench.cpp CColumnScan.cpp
+//			CPersonColumns.cpp CPersonInfo.cpp CSnapshotIO.cpp
+//			CStringArena.cpp CTreeStats.cpp NotFoundException.cpp
+//			PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+#include "CPersonColumns.h"
+#include "CPersonInfo.h"
+
+// The report: savings of the people aged REPORT_LOW_AGE or older
+const int   REPORT_LOW_AGE = 66;
+const int   REPORT_HIGH_AGE = 1 << 30;
+
+// Receives every total so the reports cannot be optimized away
+volatile double g_sink;
+
+// The running total of the traversal visitor
+double g_visitTotal;
+
+// ==== AddSavings ============================================================
+//
+// The traversal visitor: adds a person's savings to g_visitTotal if the
+// person is in the report.
+//
+// Input:
+//		person	[IN] - the person visited
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void AddSavings(CPersonInfo &person)
+{
+	if (person.GetAge() >= REPORT_LOW_AGE)
+	{
+		g_visitTotal += person.GetSavings();
+	}
+}
+
+// ==== MillisPerRun ==========================================================
+//
+// Times a report, best of several runs.
+//
+// Input:
+//		runs	[IN] - the number of runs
+//		Report	[IN] - runs the report and returns its total
+//
+// Output:
+//		double  -  milliseconds of the fastest run
+//
+// ============================================================================
+template<class ReportType>
+double MillisPerRun(int runs, ReportType Report)
+{
+	double best = 0;
+	for (int run = 0; run < runs; ++run)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		g_sink = Report();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() -
+												  start;
+		if (run == 0 || elapsed.count() < best)
+		{
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of people in the tree (default 1M)
+//		argv[2]	[IN] - number of runs of each report (default 5)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (1 << 20);
+	int runs = (argc > 2) ? atoi(argv[2]) : 5;
+
+	mt19937 generator(1);
+	uniform_int_distribution<int> pickAge(0, 99);
+	uniform_int_distribution<int> pickCents(0, 10000000);
+	vector<CPersonInfo> people;
+	people.reserve(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		people.push_back(CPersonInfo("First" + to_string(index),
+									 "Last" + to_string(index),
+									 pickAge(generator),
+									 pickCents(generator) / 100.0,
+									 pickCents(generator) / 100.0));
+	}
+	sort(people.begin(), people.end());
+	CBST<CPersonInfo> tree;
+	tree.BuildFromSortedArray(&people[0], itemCount);
+	people.clear();
+	people.shrink_to_fit();
+
+	CPersonColumns columns;
+	auto traverse = [&tree]() -> double
+	{
+		g_visitTotal = 0;
+		tree.InorderTraverse(AddSavings);
+		return g_visitTotal;
+	};
+	auto exportAndScan = [&tree, &columns]() -> double
+	{
+		tree.ExportColumns(columns);
+		return columns.AggregateSavings(REPORT_LOW_AGE,
+										REPORT_HIGH_AGE).m_sum;
+	};
+	auto scan = [&columns]() -> double
+	{
+		return columns.AggregateSavings(REPORT_LOW_AGE,
+										REPORT_HIGH_AGE).m_sum;
+	};
+	auto loop = [&columns]() -> double
+	{
+		double total = 0;
+		for (size_t row = 0; row < columns.GetCount(); ++row)
+		{
+			if (columns.m_ages[row] >= REPORT_LOW_AGE)
+			{
+				total += columns.m_savings[row];
+			}
+		}
+		return total;
+	};
+
+	cout << "people: " << itemCount << ", best of " << runs
+		 << " runs (ms), scans use " << ScanInstructionSet() << endl;
+	cout << "InorderTraverse     " << MillisPerRun(runs, traverse) << endl;
+	cout << "ExportColumns+scan  " << MillisPerRun(runs, exportAndScan)
+		 << endl;
+	cout << "scan                " << MillisPerRun(runs, scan) << endl;
+	cout << "loop over columns   " << MillisPerRun(runs, loop) << endl;
+
+	return EXIT_SUCCESS;
+} // end of "main"
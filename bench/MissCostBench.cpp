@@ -0,0 +1,116 @@
+// ============================================================================
+// File: MissCostBench.cpp
+// ============================================================================
+// Measures the cost of a hit and of a miss through the throwing lookup
+// (GetEntry, which reports a miss with NotFoundException) and through the
+// non-throwing ones (TryGetEntry and FindOrNull).  The tree is small enough
+// to stay in cache, so the difference is the cost of the exception.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/MissCostBench.cpp CSnapshotIO.cpp
+//			NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+
+// Receives every lookup count so the lookups cannot be optimized away
+volatile long long g_sink;
+
+// ==== NanosPerLookup ========================================================
+//
+// Times a lookup function over a list of keys.
+//
+// Input:
+//		keys	[IN] - the keys to look up
+//		Lookup	[IN] - returns 1 if a key was found
+//
+// Output:
+//		double  -  nanoseconds per lookup
+//
+// ============================================================================
+template<class LookupType>
+double NanosPerLookup(const vector<int> &keys, LookupType Lookup)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long found = 0;
+	for (size_t index = 0; index < keys.size(); ++index)
+	{
+		found += Lookup(keys[index]);
+	}
+	chrono::duration<double, nano> elapsed = chrono::steady_clock::now() -
+											 start;
+	g_sink = found;
+
+	return elapsed.count() / keys.size();
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of items in the tree (default 1K)
+//		argv[2]	[IN] - number of lookups of each kind (default 1M)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : 1024;
+	int lookupCount = (argc > 2) ? atoi(argv[2]) : (1 << 20);
+
+	//even keys are in the tree, odd keys are not
+	vector<int> items(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		items[index] = 2 * index;
+	}
+	CBST<int> tree;
+	tree.BuildFromSortedArray(&items[0], itemCount);
+
+	vector<int> hits(lookupCount);
+	vector<int> misses(lookupCount);
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		hits[index] = 2 * (index % itemCount);
+		misses[index] = hits[index] + 1;
+	}
+
+	auto getEntry = [&tree](int key) -> int
+	{
+		try
+		{
+			return tree.GetEntry(key) == key;
+		}
+		catch (const NotFoundException &)
+		{
+			return 0;
+		}
+	};
+	auto tryGetEntry = [&tree](int key) -> int
+	{
+		return tree.TryGetEntry(key).has_value() ? 1 : 0;
+	};
+	auto findOrNull = [&tree](int key) -> int
+	{
+		return (tree.FindOrNull(key) != nullptr) ? 1 : 0;
+	};
+
+	cout << "items: " << itemCount << ", lookups: " << lookupCount
+		 << " (ns per lookup)" << endl;
+	cout << "              hit      miss" << endl;
+	cout << "GetEntry      " << NanosPerLookup(hits, getEntry) << "\t"
+		 << NanosPerLookup(misses, getEntry) << endl;
+	cout << "TryGetEntry   " << NanosPerLookup(hits, tryGetEntry) << "\t"
+		 << NanosPerLookup(misses, tryGetEntry) << endl;
+	cout << "FindOrNull    " << NanosPerLookup(hits, findOrNull) << "\t"
+		 << NanosPerLookup(misses, findOrNull) << endl;
+
+	return EXIT_SUCCESS;
+} // end of "main"
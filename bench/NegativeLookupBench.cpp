@@ -0,0 +1,152 @@
+// ============================================================================
+// File: NegativeLookupBench.cpp
+// ============================================================================
+// Compares CBST::Contains with CFilteredBST::Contains when most looked up
+// keys are not in the tree, as in deduplicating new accounts.  Then drains
+// both trees with PopMin, which must stay O(log n) per item on the filtered
+// tree too, checking that the items come out in order and that the keys
+// still in the tree are still found.  It exits with EXIT_FAILURE if any
+// check fails.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/NegativeLookupBench.cpp CSnapshotIO.cpp
+//			NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+
+#include "CFilteredBST.h"
+
+// ==== TimeLookups ===========================================================
+//
+// Looks up every key and prints the throughput.
+//
+// Input:
+//		name	[IN] - label printed with the result
+//		tree	[IN] - the tree to search
+//		keys	[IN] - the keys to look up
+//
+// Output:
+//		long long  -  the number of keys found
+//
+// ============================================================================
+long long TimeLookups(const char *name, const CBST<int> &tree,
+					  const vector<int> &keys)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long hits = 0;
+	for (size_t index = 0; index < keys.size(); ++index)
+	{
+		hits += tree.Contains(keys[index]) ? 1 : 0;
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << ": " << keys.size() / elapsed.count() / 1e6
+		 << " M lookups/s (" << hits << " hits)" << endl;
+
+	return hits;
+}
+
+// ==== TimeDrain =============================================================
+//
+// Empties a tree with PopMin and prints the time per item.  Every 1024th
+// pop, the next key is looked up to check that it is still found.
+//
+// Input:
+//		name	[IN] - label printed with the result
+//		tree	[IN/OUT] - the tree to drain; left empty
+//		items	[IN] - the items of the tree, sorted
+//
+// Output:
+//		bool  -  True if the items came out in order and were all found
+//
+// ============================================================================
+bool TimeDrain(const char *name, CBST<int> &tree, const vector<int> &items)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	bool good = true;
+	for (size_t index = 0; index < items.size(); ++index)
+	{
+		if (tree.PopMin() != items[index])
+		{
+			good = false;
+		}
+		if (index % 1024 == 0 && index + 1 < items.size() &&
+			!tree.Contains(items[index + 1]))
+		{
+			good = false;
+		}
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << " PopMin drain " << elapsed.count() * 1e3 << " ms, "
+		 << elapsed.count() * 1e9 / items.size() << " ns/item" << endl;
+
+	return good && tree.IsEmpty();
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of items in the tree (default 4M)
+//		argv[2]	[IN] - number of lookups (default 4M)
+//		argv[3]	[IN] - percentage of lookups for missing keys (default 90)
+//
+// Output:
+//		int  -  EXIT_SUCCESS if both trees found the same keys
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (4 << 20);
+	int lookupCount = (argc > 2) ? atoi(argv[2]) : (4 << 20);
+	int missPercent = (argc > 3) ? atoi(argv[3]) : 90;
+
+	//even keys are in the tree, odd keys are not
+	vector<int> items(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		items[index] = 2 * index;
+	}
+
+	mt19937 generator(12345);
+	uniform_int_distribution<int> distribution(0, itemCount - 1);
+	uniform_int_distribution<int> percent(0, 99);
+	vector<int> keys(lookupCount);
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		int miss = (percent(generator) < missPercent) ? 1 : 0;
+		keys[index] = 2 * distribution(generator) + miss;
+	}
+
+	cout << "items: " << itemCount << ", lookups: " << lookupCount << ", "
+		 << missPercent << "% missing" << endl;
+
+	CBST<int> plain;
+	plain.BuildFromSortedArray(&items[0], itemCount);
+	long long plainHits = TimeLookups("CBST                ", plain, keys);
+
+	long long filteredHits = 0;
+	bool drained = true;
+	const double rates[] = { 0.1, 0.01, 0.001 };
+	for (double rate : rates)
+	{
+		CFilteredBST<int> filtered(rate);
+		filtered.BuildFromSortedArray(&items[0], itemCount);
+		cout << "false positive rate " << rate << ", "
+			 << (double)filtered.GetFilterBytes() * 8 / itemCount
+			 << " bits/key" << endl;
+		filteredHits = TimeLookups("CFilteredBST        ", filtered, keys);
+		drained = TimeDrain("CFilteredBST        ", filtered, items) &&
+				  drained;
+	}
+	drained = TimeDrain("CBST                ", plain, items) && drained;
+
+	return (plainHits == filteredHits && drained) ? EXIT_SUCCESS :
+													EXIT_FAILURE;
+} // end of "main"
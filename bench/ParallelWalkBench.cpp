@@ -0,0 +1,136 @@
+// ============================================================================
+// File: ParallelWalkBench.cpp
+// ============================================================================
+// Times a daily interest accrual over every person of a CBST<CPersonInfo>
+// with ParallelForEach, and a sum of the balances with ParallelReduce, on
+// pools of 1, 2, 4 ... workers up to one per hardware thread.  The one
+// worker pool runs the walk on the calling thread alone and is the
+// baseline of the speedups.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -pthread -I. bench/ParallelWalkBench.cpp
+//			CDumpWriter.cpp CPersonInfo.cpp CSnapshotIO.cpp CStringArena.cpp
+//			CTreeStats.cpp CWorkPool.cpp NotFoundException.cpp
+//			PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+#include "CPersonInfo.h"
+#include "CWorkPool.h"
+
+// Receives every total so the reductions cannot be optimized away
+volatile double g_sink;
+
+// ==== MillisPerRun ==========================================================
+//
+// Times a pass, best of several runs.
+//
+// Input:
+//		runs	[IN] - the number of runs
+//		Pass	[IN] - runs the pass
+//
+// Output:
+//		double  -  milliseconds of the fastest run
+//
+// ============================================================================
+template<class PassType>
+double MillisPerRun(int runs, PassType Pass)
+{
+	double best = 0;
+	for (int run = 0; run < runs; ++run)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		Pass();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() -
+												  start;
+		if (run == 0 || elapsed.count() < best)
+		{
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of people in the tree (default 1M)
+//		argv[2]	[IN] - grain size (default PARALLEL_GRAIN_SIZE)
+//		argv[3]	[IN] - number of runs of each pass (default 5)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (1 << 20);
+	int grainSize = (argc > 2) ? atoi(argv[2]) : PARALLEL_GRAIN_SIZE;
+	int runs = (argc > 3) ? atoi(argv[3]) : 5;
+	int maxWorkers = (int)max(1u, thread::hardware_concurrency());
+
+	vector<CPersonInfo> people;
+	people.reserve(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		people.push_back(CPersonInfo("First" + to_string(index),
+									 "Last" + to_string(index), index,
+									 1000.0 + index % 997, 5000.0 + index));
+	}
+	CBST<CPersonInfo> tree;
+	tree.BuildFromSortedArray(&people[0], itemCount);
+	people.clear();
+	people.shrink_to_fit();
+
+	auto accrue = [](CPersonInfo &person)
+	{
+		person.SetSavings(person.GetSavings() * (1.0 + 0.04 / 365));
+	};
+	auto savings = [](const CPersonInfo &person) -> double
+	{
+		return person.GetSavings();
+	};
+	auto add = [](double lhs, double rhs) -> double
+	{
+		return lhs + rhs;
+	};
+
+	cout << "people: " << itemCount << ", grain: " << grainSize
+		 << ", best of " << runs << " runs (ms, speedup)" << endl;
+	cout << "workers   ParallelForEach       ParallelReduce" << endl;
+	double baseForEach = 0;
+	double baseReduce = 0;
+	for (int workers = 1; workers <= maxWorkers;
+		 workers = (workers == maxWorkers) ? workers + 1 :
+				   min(2 * workers, maxWorkers))
+	{
+		CWorkPool pool(workers);
+		double forEach = MillisPerRun(runs, [&]()
+		{
+			tree.ParallelForEach(accrue, grainSize, pool);
+		});
+		double reduce = MillisPerRun(runs, [&]()
+		{
+			g_sink = tree.ParallelReduce(savings, add, 0.0, grainSize, pool);
+		});
+		if (workers == 1)
+		{
+			baseForEach = forEach;
+			baseReduce = reduce;
+		}
+		cout << workers << "\t  " << forEach << "\t" << baseForEach / forEach
+			 << "\t\t" << reduce << "\t" << baseReduce / reduce << endl;
+	}
+
+	return EXIT_SUCCESS;
+} // end of "main"
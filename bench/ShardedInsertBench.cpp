@@ -0,0 +1,137 @@
+// ============================================================================
+// File: ShardedInsertBench.cpp
+// ============================================================================
+// Times inserting people into a CShardedBST<CPersonInfo> from 1, 2, 4 ...
+// threads up to one per hardware thread.  Each thread adds its own slice of
+// a shuffled list, so the writers spread over every shard; the single
+// thread run is the baseline of the speedups.  Every run starts from an
+// empty container, so the time includes the splits that build the shards.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -pthread -I. bench/ShardedInsertBench.cpp
+//			CDumpWriter.cpp CPersonInfo.cpp CSnapshotIO.cpp CStringArena.cpp
+//			CTreeStats.cpp CWorkPool.cpp NotFoundException.cpp
+//			PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "CPersonInfo.h"
+#include "CShardedBST.h"
+
+// ==== MillisPerRun ==========================================================
+//
+// Times a pass, best of several runs.
+//
+// Input:
+//		runs	[IN] - the number of runs
+//		Pass	[IN] - runs the pass
+//
+// Output:
+//		double  -  milliseconds of the fastest run
+//
+// ============================================================================
+template<class PassType>
+double MillisPerRun(int runs, PassType Pass)
+{
+	double best = 0;
+	for (int run = 0; run < runs; ++run)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		Pass();
+		chrono::duration<double, milli> elapsed = chrono::steady_clock::now() -
+												  start;
+		if (run == 0 || elapsed.count() < best)
+		{
+			best = elapsed.count();
+		}
+	}
+
+	return best;
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of people to insert (default 64K)
+//		argv[2]	[IN] - target number of shards (default 0, four per
+//					   hardware thread)
+//		argv[3]	[IN] - number of runs at each thread count (default 3)
+//
+// Output:
+//		int  -  EXIT_SUCCESS, or EXIT_FAILURE if an insert was lost
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (1 << 16);
+	int targetShards = (argc > 2) ? atoi(argv[2]) : 0;
+	int runs = (argc > 3) ? atoi(argv[3]) : 3;
+	int maxThreads = (int)max(1u, thread::hardware_concurrency());
+
+	vector<CPersonInfo> people;
+	people.reserve(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		people.push_back(CPersonInfo("First" + to_string(index),
+									 "Last" + to_string(index), index,
+									 1000.0 + index % 997, 5000.0 + index));
+	}
+	shuffle(people.begin(), people.end(), mt19937(12345));
+
+	cout << "people: " << itemCount << ", best of " << runs
+		 << " runs" << endl;
+	cout << "threads   ms\t  inserts/s\tspeedup\tshards" << endl;
+	double baseline = 0;
+	for (int threads = 1; threads <= maxThreads;
+		 threads = (threads == maxThreads) ? threads + 1 :
+				   min(2 * threads, maxThreads))
+	{
+		int shards = 0;
+		bool lost = false;
+		double millis = MillisPerRun(runs, [&]()
+		{
+			CShardedBST<CPersonInfo> tree(targetShards);
+			vector<thread> writers;
+			for (int writer = 0; writer < threads; ++writer)
+			{
+				writers.push_back(thread([&, writer]()
+				{
+					for (int index = writer; index < itemCount;
+						 index += threads)
+					{
+						tree.Add(people[index]);
+					}
+				}));
+			}
+			for (size_t writer = 0; writer < writers.size(); ++writer)
+			{
+				writers[writer].join();
+			}
+			shards = tree.GetShardCount();
+			lost = lost || (tree.GetNumberOfNodes() != itemCount);
+		});
+		if (lost)
+		{
+			cerr << "inserts were lost with " << threads << " threads" << endl;
+			return EXIT_FAILURE;
+		}
+		if (threads == 1)
+		{
+			baseline = millis;
+		}
+		cout << threads << "\t  " << millis << "\t  "
+			 << itemCount / (millis / 1000) << "\t" << baseline / millis
+			 << "\t" << shards << endl;
+	}
+
+	return EXIT_SUCCESS;
+} // end of "main"
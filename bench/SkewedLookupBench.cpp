@@ -0,0 +1,168 @@
+// ============================================================================
+// File: SkewedLookupBench.cpp
+// ============================================================================
+// Compares CBST::Contains with the trees meant for skewed access patterns:
+// CSplayBST, splaying on every access and only below a few levels, and
+// CCachedBST, with a small and a large lookup cache.  Lookups are drawn from
+// a Zipf distribution (a few keys take most of the accesses) and from a
+// uniform one.  The hot keys are scattered over the key range so they do
+// not share a subtree.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/SkewedLookupBench.cpp CSnapshotIO.cpp
+//			NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+using namespace std;
+
+#include "CCachedBST.h"
+#include "CSplayBST.h"
+
+// ==== MakeLookups ===========================================================
+//
+// Draws lookup keys.  With skew > 0 the i-th most popular key is drawn with
+// probability proportional to 1 / i^skew; with skew == 0 all are equal.
+//
+// Input:
+//		size	[IN] - keys are 0 .. size - 1
+//		count	[IN] - the number of lookups
+//		skew	[IN] - the Zipf exponent
+//
+// Output:
+//		vector<int>  -  the keys to look up
+//
+// ============================================================================
+vector<int> MakeLookups(int size, int count, double skew)
+{
+	mt19937 random(12345);
+	vector<int> byRank(size);
+	for (int index = 0; index < size; ++index)
+	{
+		byRank[index] = index;
+	}
+	shuffle(byRank.begin(), byRank.end(), random);
+
+	vector<double> cumulative(size);
+	double total = 0;
+	for (int rank = 0; rank < size; ++rank)
+	{
+		total += 1.0 / pow(rank + 1.0, skew);
+		cumulative[rank] = total;
+	}
+
+	uniform_real_distribution<double> draw(0, total);
+	vector<int> keys(count);
+	for (int index = 0; index < count; ++index)
+	{
+		int rank = (int)(lower_bound(cumulative.begin(), cumulative.end(),
+									 draw(random)) - cumulative.begin());
+		keys[index] = byRank[min(rank, size - 1)];
+	}
+
+	return keys;
+}
+
+// ==== TimeLookups ===========================================================
+//
+// Looks up every key and prints the throughput.
+//
+// Input:
+//		name	[IN] - label printed with the result
+//		tree	[IN] - the tree to search
+//		keys	[IN] - the keys to look up
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void TimeLookups(const char *name, const CBST<int> &tree,
+				 const vector<int> &keys)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int found = 0;
+	for (size_t index = 0; index < keys.size(); ++index)
+	{
+		found += tree.Contains(keys[index]);
+	}
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << ": " << keys.size() / elapsed.count() / 1e6
+		 << " M lookups/s (" << found << " found)" << endl;
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of items in the tree (default 1M)
+//		argv[2]	[IN] - number of lookups (default 4M)
+//		argv[3]	[IN] - Zipf exponent (default 0.99)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int size = 1 << 20;
+	int count = 1 << 22;
+	double skew = 0.99;
+	if (argc > 1)
+	{
+		size = atoi(argv[1]);
+	}
+	if (argc > 2)
+	{
+		count = atoi(argv[2]);
+	}
+	if (argc > 3)
+	{
+		skew = atof(argv[3]);
+	}
+
+	vector<int> items(size);
+	for (int index = 0; index < size; ++index)
+	{
+		items[index] = index;
+	}
+
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		double passSkew = (pass == 0) ? skew : 0;
+		vector<int> keys = MakeLookups(size, count, passSkew);
+		cout << "skew " << passSkew << ", " << size << " items, " << count
+			 << " lookups" << endl;
+
+		CBST<int> balanced;
+		balanced.BuildFromSortedArray(items.data(), size);
+		TimeLookups("  CBST (balanced)       ", balanced, keys);
+
+		CSplayBST<int> splay;
+		splay.BuildFromSortedArray(items.data(), size);
+		TimeLookups("  CSplayBST             ", splay, keys);
+
+		CSplayBST<int> semiSplay(8);
+		semiSplay.BuildFromSortedArray(items.data(), size);
+		TimeLookups("  CSplayBST (depth > 8) ", semiSplay, keys);
+
+		CCachedBST<int> smallCache;
+		smallCache.BuildFromSortedArray(items.data(), size);
+		TimeLookups("  CCachedBST (1K slots) ", smallCache, keys);
+		cout << "    hit rate " << 100.0 * smallCache.GetCacheHits() / count
+			 << "%" << endl;
+
+		CCachedBST<int> largeCache(1 << 16);
+		largeCache.BuildFromSortedArray(items.data(), size);
+		TimeLookups("  CCachedBST (64K slots)", largeCache, keys);
+		cout << "    hit rate " << 100.0 * largeCache.GetCacheHits() / count
+			 << "%" << endl;
+	}
+
+	return EXIT_SUCCESS;
+} // end of "main"
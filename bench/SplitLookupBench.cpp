@@ -0,0 +1,143 @@
+// ============================================================================
+// File: SplitLookupBench.cpp
+// ============================================================================
+// Compares a CBST<CPersonInfo>, whose nodes hold whole records, with a
+// CSplitBST<CPersonInfo>, whose nodes hold only the age and a record
+// number.  Both trees hold the same people, one per age, and are searched
+// for the same randomly chosen people; FindKey searches the split tree by
+// age alone.  Add is timed as well, since every add rebuilds the tree and
+// the split tree copies handles where the other copies records.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -I. bench/SplitLookupBench.cpp CPersonInfo.cpp
+//			CSnapshotIO.cpp CStringArena.cpp CTreeStats.cpp
+//			NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+#include "CSplitBST.h"
+#include "CPersonInfo.h"
+
+// Receives every lookup count so the lookups cannot be optimized away
+volatile long long g_sink;
+
+// ==== NanosPerCall ==========================================================
+//
+// Times a function over a list of people.
+//
+// Input:
+//		people	[IN] - the people to pass to Call
+//		Call	[IN] - returns 1 if a person was found
+//
+// Output:
+//		double  -  nanoseconds per call
+//
+// ============================================================================
+template<class CallType>
+double NanosPerCall(const vector<CPersonInfo> &people, CallType Call)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long found = 0;
+	for (size_t index = 0; index < people.size(); ++index)
+	{
+		found += Call(people[index]);
+	}
+	chrono::duration<double, nano> elapsed = chrono::steady_clock::now() -
+											 start;
+	g_sink = found;
+
+	return elapsed.count() / people.size();
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv[1]	[IN] - number of people in the trees (default 1M)
+//		argv[2]	[IN] - number of lookups of each kind (default 1M)
+//		argv[3]	[IN] - number of adds (default 20)
+//
+// Output:
+//		int  -  EXIT_SUCCESS
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int itemCount = (argc > 1) ? atoi(argv[1]) : (1 << 20);
+	int lookupCount = (argc > 2) ? atoi(argv[2]) : (1 << 20);
+	int addCount = (argc > 3) ? atoi(argv[3]) : 20;
+
+	//even ages are in the trees, so the adds can use odd ones
+	vector<CPersonInfo> people;
+	people.reserve(itemCount);
+	for (int index = 0; index < itemCount; ++index)
+	{
+		people.push_back(CPersonInfo("First" + to_string(index),
+									 "Last" + to_string(index), 2 * index,
+									 index, index));
+	}
+
+	CBST<CPersonInfo> wholeTree;
+	wholeTree.BuildFromSortedArray(&people[0], itemCount);
+	CSplitBST<CPersonInfo> splitTree;
+	splitTree.BuildFromSortedArray(&people[0], itemCount);
+
+	mt19937 generator(1);
+	uniform_int_distribution<int> pick(0, itemCount - 1);
+	vector<CPersonInfo> lookups;
+	lookups.reserve(lookupCount);
+	for (int index = 0; index < lookupCount; ++index)
+	{
+		lookups.push_back(people[pick(generator)]);
+	}
+	vector<CPersonInfo> adds;
+	for (int index = 0; index < addCount; ++index)
+	{
+		adds.push_back(CPersonInfo("New", "Person",
+								   2 * pick(generator) + 1));
+	}
+	people.clear();
+	people.shrink_to_fit();
+
+	auto wholeContains = [&wholeTree](const CPersonInfo &person) -> int
+	{
+		return wholeTree.Contains(person) ? 1 : 0;
+	};
+	auto splitContains = [&splitTree](const CPersonInfo &person) -> int
+	{
+		return splitTree.Contains(person) ? 1 : 0;
+	};
+	auto splitFindKey = [&splitTree](const CPersonInfo &person) -> int
+	{
+		return (splitTree.FindKey(person.GetAge()) != nullptr) ? 1 : 0;
+	};
+	auto wholeAdd = [&wholeTree](const CPersonInfo &person) -> int
+	{
+		return wholeTree.Add(person) ? 1 : 0;
+	};
+	auto splitAdd = [&splitTree](const CPersonInfo &person) -> int
+	{
+		return splitTree.Add(person) ? 1 : 0;
+	};
+
+	cout << "people: " << itemCount << ", lookups: " << lookupCount
+		 << ", adds: " << addCount << " (ns per call)" << endl;
+	cout << "                    CBST      CSplitBST" << endl;
+	cout << "Contains            " << NanosPerCall(lookups, wholeContains)
+		 << "\t" << NanosPerCall(lookups, splitContains) << endl;
+	cout << "FindKey                       "
+		 << NanosPerCall(lookups, splitFindKey) << endl;
+	cout << "Add                 " << NanosPerCall(adds, wholeAdd) << "\t"
+		 << NanosPerCall(adds, splitAdd) << endl;
+	cout << "node bytes          " << wholeTree.Stats().m_nodeBytes << "\t"
+		 << splitTree.Stats().m_nodeBytes << endl;
+
+	return EXIT_SUCCESS;
+} // end of "main"
@@ -0,0 +1,689 @@
+// ============================================================================
+// File: TreeOpsBench.cpp
+// ============================================================================
+// The benchmark suite behind the "bench" build target.  Measures every tree
+// operation (Add, Remove, Contains, the three traversals, copying,
+// ArrayToTree, GetHeight and GetNumberOfNodes) for CBST<int>,
+// CBST<CPersonInfo> and CBinaryNodeTree<int>, at sizes from 1e3 up to
+// --max-size, with keys that are sorted, uniformly random or Zipf
+// distributed.  Every operation is repeated until it has run for at least
+// --min-time seconds, the way Google Benchmark does, and the results are
+// printed as a table and, with --json, written in Google Benchmark's JSON
+// layout so existing tools can compare two runs.
+//
+// Distributions:
+//		sorted	the tree holds 0 .. n - 1; lookups walk the keys in order
+//		random	the tree holds n keys drawn uniformly from [0, 2n); lookups
+//				are drawn the same way, so about half of them miss
+//		zipf	the tree holds 0 .. n - 1; lookups follow a Zipf law
+//				(s = 0.99) over the keys, the most popular ones scattered
+//
+// Options:
+//		--max-size=N	largest tree size (default 1000000; 10000000 covers
+//						every size)
+//		--min-time=S	seconds to run each operation for (default 0.1)
+//		--json=PATH		also write the results to PATH
+//		--filter=TEXT	only run benchmarks whose name contains TEXT
+//
+// Built by the CMake project; "cmake --build <dir> --target bench" runs it.
+// Built with CBST_INSTRUMENT, it also prints the instrumentation report.
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "CBST.h"
+#include "CBinaryNodeTree.h"
+#include "CPersonInfo.h"
+
+// Number of keys in a lookup stream; lookups cycle through it
+const int BENCH_STREAM_SIZE = 1 << 16;
+
+// A run also stops once it has taken this many times --min-time in all
+const double BENCH_WALL_FACTOR = 5;
+
+// One measured operation
+struct CBenchResult
+{
+	string		m_name;
+	string		m_tree;
+	string		m_operation;
+	string		m_distribution;
+	int			m_size;
+	long long	m_iterations;
+	double		m_nanos;		// Per iteration
+};
+
+// Command line options
+struct CBenchOptions
+{
+	int		m_maxSize;
+	double	m_minTime;
+	string	m_jsonPath;
+	string	m_filter;
+};
+
+vector<CBenchResult>	g_results;
+CBenchOptions			g_options;
+
+// Receives every visit so the traversals cannot be optimized away
+volatile long long g_visits;
+
+// ==== MakeItem ==============================================================
+//
+// Makes the item with a given key.  CPersonInfo is keyed by age; the names
+// are derived from the key so equal keys make equal items.
+//
+// Input:
+//		key	[IN] - the key of the item
+//
+// Output:
+//		ItemType  -  the item
+//
+// ============================================================================
+template<class ItemType>
+ItemType MakeItem(int key);
+
+template<>
+int MakeItem<int>(int key)
+{
+	return key;
+}
+
+template<>
+CPersonInfo MakeItem<CPersonInfo>(int key)
+{
+	return CPersonInfo("First" + to_string(key), "Last" + to_string(key),
+					   key, key * 1.5, key * 0.5);
+}
+
+// ==== Visit =================================================================
+//
+// Counts a visited item.
+//
+// Input:
+//		item	[IN] - the visited item, which is not read
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void Visit(ItemType &)
+{
+	g_visits = g_visits + 1;
+}
+
+// ==== MakeKeys ==============================================================
+//
+// Makes the keys a tree of the given size holds and the stream of keys that
+// lookups, adds and removes use.
+//
+// Input:
+//		distribution	[IN]  - "sorted", "random" or "zipf"
+//		size			[IN]  - the number of keys in the tree
+//		contents		[OUT] - the keys in the tree, sorted
+//		stream			[OUT] - the keys to operate on
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void MakeKeys(const string &distribution, int size, vector<int> &contents,
+			  vector<int> &stream)
+{
+	mt19937 generator(12345);
+	contents.resize(size);
+	stream.resize(BENCH_STREAM_SIZE);
+
+	if (distribution == "random")
+	{
+		uniform_int_distribution<int> draw(0, 2 * size - 1);
+		for (int index = 0; index < size; ++index)
+		{
+			contents[index] = draw(generator);
+		}
+		sort(contents.begin(), contents.end());
+		for (int index = 0; index < BENCH_STREAM_SIZE; ++index)
+		{
+			stream[index] = draw(generator);
+		}
+		return;
+	}
+
+	for (int index = 0; index < size; ++index)
+	{
+		contents[index] = index;
+	}
+
+	if (distribution == "sorted")
+	{
+		for (int index = 0; index < BENCH_STREAM_SIZE; ++index)
+		{
+			stream[index] = (int)((long long)index * size /
+								  BENCH_STREAM_SIZE);
+		}
+		return;
+	}
+
+	//zipf: rank r is drawn with probability proportional to 1 / r^0.99
+	vector<int> byRank(contents);
+	shuffle(byRank.begin(), byRank.end(), generator);
+	vector<double> cumulative(size);
+	double total = 0;
+	for (int rank = 0; rank < size; ++rank)
+	{
+		total += 1.0 / pow(rank + 1.0, 0.99);
+		cumulative[rank] = total;
+	}
+	uniform_real_distribution<double> draw(0, total);
+	for (int index = 0; index < BENCH_STREAM_SIZE; ++index)
+	{
+		size_t rank = lower_bound(cumulative.begin(), cumulative.end(),
+								  draw(generator)) - cumulative.begin();
+		stream[index] = byRank[min(rank, (size_t)size - 1)];
+	}
+}
+
+// ==== BuildTree =============================================================
+//
+// Builds a tree holding the given items.  CBST is built balanced from the
+// sorted items in O(n).  CBinaryNodeTree::Add costs O(n) per item, so it
+// is built by joining balanced halves with the three-argument constructor
+// instead, which gives it the same shape Add would.
+//
+// Input:
+//		items	[IN] - the sorted items
+//
+// Output:
+//		unique_ptr  -  the tree
+//
+// ============================================================================
+template<class ItemType>
+void BuildTree(vector<ItemType> &items, unique_ptr<CBST<ItemType> > &tree)
+{
+	tree.reset(new CBST<ItemType>);
+	if (!items.empty())
+	{
+		tree->BuildFromSortedArray(&items[0], (int)items.size());
+	}
+}
+
+template<class ItemType>
+CBinaryNodeTree<ItemType>* BuildNodeTree(const vector<ItemType> &items,
+										 int first, int last)
+{
+	if (first > last)
+	{
+		return new CBinaryNodeTree<ItemType>;
+	}
+
+	int mid = first + (last - first) / 2;
+	unique_ptr<CBinaryNodeTree<ItemType> > left(BuildNodeTree(items, first,
+															  mid - 1));
+	unique_ptr<CBinaryNodeTree<ItemType> > right(BuildNodeTree(items,
+															   mid + 1,
+															   last));
+
+	return new CBinaryNodeTree<ItemType>(items[mid], left.get(),
+										 right.get());
+}
+
+template<class ItemType>
+void BuildTree(vector<ItemType> &items,
+			   unique_ptr<CBinaryNodeTree<ItemType> > &tree)
+{
+	tree.reset(BuildNodeTree(items, 0, (int)items.size() - 1));
+}
+
+// ==== Measure ===============================================================
+//
+// Runs an operation with a growing number of iterations until one run
+// takes at least --min-time seconds, then records the time per iteration.
+// Untimed work is bounded by BENCH_WALL_FACTOR.
+//
+// Input:
+//		tree			[IN] - the tree's name
+//		operation		[IN] - the operation's name
+//		distribution	[IN] - the distribution's name
+//		size			[IN] - the size of the tree
+//		Run				[IN] - runs the operation a given number of times and
+//							   returns the seconds it took
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class RunType>
+void Measure(const string &tree, const string &operation,
+			 const string &distribution, int size, RunType Run)
+{
+	CBenchResult result;
+	result.m_tree = tree;
+	result.m_operation = operation;
+	result.m_distribution = distribution;
+	result.m_size = size;
+	result.m_name = tree + "/" + operation + "/" + distribution + "/" +
+					to_string(size);
+	if (result.m_name.find(g_options.m_filter) == string::npos)
+	{
+		return;
+	}
+
+	//untimed work (putting back a removed item, say) counts against a
+	//wall clock limit so that it cannot stretch a run out indefinitely
+	long long iterations = 1;
+	double seconds;
+	for (;;)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		seconds = Run(iterations);
+		double wall = chrono::duration<double>(chrono::steady_clock::now() -
+											   start).count();
+		if (seconds >= g_options.m_minTime ||
+			wall >= BENCH_WALL_FACTOR * g_options.m_minTime ||
+			iterations >= 1000000000)
+		{
+			break;
+		}
+
+		//aim 40% past the target, growing at least 2x and at most 10x
+		double scale = 10;
+		if (seconds > 0)
+		{
+			scale = min(10.0, max(2.0, 1.4 * g_options.m_minTime / seconds));
+		}
+		if (wall > 0)
+		{
+			scale = min(scale, max(2.0, 1.4 * BENCH_WALL_FACTOR *
+										g_options.m_minTime / wall));
+		}
+		iterations = (long long)(iterations * scale);
+	}
+
+	result.m_iterations = iterations;
+	result.m_nanos = seconds * 1e9 / iterations;
+	g_results.push_back(result);
+
+	cout << left;
+	cout.width(48);
+	cout << result.m_name;
+	cout.width(12);
+	cout << right << result.m_iterations;
+	cout.width(16);
+	cout << result.m_nanos << " ns" << endl;
+}
+
+// ==== MeasureArrayToTree ====================================================
+//
+// Measures ArrayToTree, which only CBST has.
+//
+// Input:
+//		name, distribution, size	[IN] - as for Measure
+//		tree						[IN] - the tree to rebuild
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class ItemType>
+void MeasureArrayToTree(const string &name, const string &distribution,
+						int size, CBST<ItemType> &tree)
+{
+	Measure(name, "ArrayToTree", distribution, size,
+			[&tree](long long iterations)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (long long index = 0; index < iterations; ++index)
+		{
+			tree.ArrayToTree();
+		}
+		return chrono::duration<double>(chrono::steady_clock::now() -
+										start).count();
+	});
+}
+
+template<class ItemType>
+void MeasureArrayToTree(const string &, const string &, int,
+						CBinaryNodeTree<ItemType> &)
+{
+	//CBinaryNodeTree is not a search tree and has no ArrayToTree
+}
+
+// ==== RunSuite ==============================================================
+//
+// Measures every operation on one kind of tree for every distribution and
+// size up to --max-size.
+//
+// Input:
+//		name	[IN] - the tree's name in the results
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+template<class TreeType, class ItemType>
+void RunSuite(const string &name)
+{
+	const char *distributions[] = { "sorted", "random", "zipf" };
+
+	for (const char *distribution : distributions)
+	{
+		for (long long size = 1000; size <= g_options.m_maxSize; size *= 10)
+		{
+			vector<int> contents;
+			vector<int> keys;
+			MakeKeys(distribution, (int)size, contents, keys);
+
+			vector<ItemType> items;
+			items.reserve(contents.size());
+			for (size_t index = 0; index < contents.size(); ++index)
+			{
+				items.push_back(MakeItem<ItemType>(contents[index]));
+			}
+			vector<ItemType> stream;
+			stream.reserve(keys.size());
+			for (size_t index = 0; index < keys.size(); ++index)
+			{
+				stream.push_back(MakeItem<ItemType>(keys[index]));
+			}
+
+			unique_ptr<TreeType> tree;
+			BuildTree(items, tree);
+			items.clear();
+			items.shrink_to_fit();
+
+			Measure(name, "Contains", distribution, (int)size,
+					[&tree, &stream](long long iterations)
+			{
+				chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+				long long found = 0;
+				for (long long index = 0; index < iterations; ++index)
+				{
+					found += tree->Contains(stream[index % BENCH_STREAM_SIZE]);
+				}
+				g_visits = found;
+				return chrono::duration<double>(chrono::steady_clock::now() -
+												start).count();
+			});
+
+			//each item added is removed again (untimed) right away and each
+			//item removed is put back (untimed), so the size holds steady
+			const char *changes[] = { "Add", "Remove" };
+			for (int change = 0; change < 2; ++change)
+			{
+				Measure(name, changes[change], distribution, (int)size,
+						[&tree, &stream, change](long long iterations)
+				{
+					double seconds = 0;
+					for (long long index = 0; index < iterations; ++index)
+					{
+						const ItemType &item = stream[index % BENCH_STREAM_SIZE];
+						if (change == 1)
+						{
+							tree->Add(item);
+						}
+						chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+						if (change == 0)
+						{
+							tree->Add(item);
+						}
+						else
+						{
+							tree->Remove(item);
+						}
+						seconds += chrono::duration<double>(
+										chrono::steady_clock::now() -
+										start).count();
+						if (change == 0)
+						{
+							tree->Remove(item);
+						}
+					}
+					return seconds;
+				});
+			}
+
+			const char *traversals[] = { "PreorderTraverse",
+										 "InorderTraverse",
+										 "PostorderTraverse" };
+			for (int order = 0; order < 3; ++order)
+			{
+				Measure(name, traversals[order], distribution, (int)size,
+						[&tree, order](long long iterations)
+				{
+					chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+					for (long long index = 0; index < iterations; ++index)
+					{
+						if (order == 0)
+						{
+							tree->PreorderTraverse(Visit<ItemType>);
+						}
+						else if (order == 1)
+						{
+							tree->InorderTraverse(Visit<ItemType>);
+						}
+						else
+						{
+							tree->PostorderTraverse(Visit<ItemType>);
+						}
+					}
+					return chrono::duration<double>(
+									chrono::steady_clock::now() -
+									start).count();
+				});
+			}
+
+			//the copy constructor is CopyTree; the copies are freed untimed
+			Measure(name, "CopyTree", distribution, (int)size,
+					[&tree](long long iterations)
+			{
+				double seconds = 0;
+				for (long long index = 0; index < iterations; ++index)
+				{
+					chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+					unique_ptr<TreeType> copy(new TreeType(*tree));
+					seconds += chrono::duration<double>(
+									chrono::steady_clock::now() -
+									start).count();
+				}
+				return seconds;
+			});
+
+			MeasureArrayToTree(name, distribution, (int)size, *tree);
+
+			Measure(name, "GetHeight", distribution, (int)size,
+					[&tree](long long iterations)
+			{
+				chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+				long long total = 0;
+				for (long long index = 0; index < iterations; ++index)
+				{
+					total += tree->GetHeight();
+				}
+				g_visits = total;
+				return chrono::duration<double>(chrono::steady_clock::now() -
+												start).count();
+			});
+
+			Measure(name, "GetNumberOfNodes", distribution, (int)size,
+					[&tree](long long iterations)
+			{
+				chrono::steady_clock::time_point start =
+												chrono::steady_clock::now();
+				long long total = 0;
+				for (long long index = 0; index < iterations; ++index)
+				{
+					total += tree->GetNumberOfNodes();
+				}
+				g_visits = total;
+				return chrono::duration<double>(chrono::steady_clock::now() -
+												start).count();
+			});
+		}
+	}
+}
+
+// ==== WriteJson =============================================================
+//
+// Writes the results in Google Benchmark's JSON layout, with the tree,
+// operation, distribution and size as extra fields of every benchmark.
+//
+// Input:
+//		path	[IN] - the file to write
+//
+// Output:
+//		bool  -  True if the file was written
+//
+// ============================================================================
+bool WriteJson(const string &path)
+{
+	ofstream out(path.c_str());
+	if (!out)
+	{
+		return false;
+	}
+
+	char date[32];
+	time_t now = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	out << "{\n";
+	out << "  \"context\": {\n";
+	out << "    \"date\": \"" << date << "\",\n";
+	out << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n";
+#ifdef __VERSION__
+	out << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+#ifdef NDEBUG
+	out << "    \"library_build_type\": \"release\",\n";
+#else
+	out << "    \"library_build_type\": \"debug\",\n";
+#endif
+	out << "    \"max_size\": " << g_options.m_maxSize << ",\n";
+	out << "    \"min_time\": " << g_options.m_minTime << "\n";
+	out << "  },\n";
+	out << "  \"benchmarks\": [";
+
+	for (size_t index = 0; index < g_results.size(); ++index)
+	{
+		const CBenchResult &result = g_results[index];
+		out << ((index == 0) ? "\n" : ",\n");
+		out << "    {\n";
+		out << "      \"name\": \"" << result.m_name << "\",\n";
+		out << "      \"run_type\": \"iteration\",\n";
+		out << "      \"tree\": \"" << result.m_tree << "\",\n";
+		out << "      \"operation\": \"" << result.m_operation << "\",\n";
+		out << "      \"distribution\": \"" << result.m_distribution
+			<< "\",\n";
+		out << "      \"size\": " << result.m_size << ",\n";
+		out << "      \"iterations\": " << result.m_iterations << ",\n";
+		out << "      \"real_time\": " << result.m_nanos << ",\n";
+		out << "      \"time_unit\": \"ns\"\n";
+		out << "    }";
+	}
+
+	out << "\n  ]\n}\n";
+
+	return (bool)out;
+}
+
+// ==== ParseOptions ==========================================================
+//
+// Reads the command line options into g_options.
+//
+// Input:
+//		argc, argv	[IN] - the command line
+//
+// Output:
+//		bool  -  False if an option is not recognized
+//
+// ============================================================================
+bool ParseOptions(int argc, char *argv[])
+{
+	g_options.m_maxSize = 1000000;
+	g_options.m_minTime = 0.1;
+
+	for (int index = 1; index < argc; ++index)
+	{
+		string option(argv[index]);
+		string value = option.substr(option.find('=') + 1);
+
+		if (option.compare(0, 11, "--max-size=") == 0)
+		{
+			g_options.m_maxSize = atoi(value.c_str());
+		}
+		else if (option.compare(0, 11, "--min-time=") == 0)
+		{
+			g_options.m_minTime = atof(value.c_str());
+		}
+		else if (option.compare(0, 7, "--json=") == 0)
+		{
+			g_options.m_jsonPath = value;
+		}
+		else if (option.compare(0, 9, "--filter=") == 0)
+		{
+			g_options.m_filter = value;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ==== main ==================================================================
+//
+// Input:
+//		argv	[IN] - the options described at the top of the file
+//
+// Output:
+//		int  -  EXIT_SUCCESS, or EXIT_FAILURE on a bad option or if the JSON
+//				file could not be written
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	if (!ParseOptions(argc, argv))
+	{
+		cerr << "Usage: " << argv[0] << " [--max-size=N] [--min-time=S]"
+			 << " [--json=PATH] [--filter=TEXT]" << endl;
+		return EXIT_FAILURE;
+	}
+
+	RunSuite<CBST<int>, int>("CBST<int>");
+	RunSuite<CBST<CPersonInfo>, CPersonInfo>("CBST<CPersonInfo>");
+	RunSuite<CBinaryNodeTree<int>, int>("CBinaryNodeTree<int>");
+
+#ifdef CBST_INSTRUMENT
+	cout << endl << InstrumentSnapshot().ToText();
+#endif
+
+	if (!g_options.m_jsonPath.empty() && !WriteJson(g_options.m_jsonPath))
+	{
+		cerr << "Error writing " << g_options.m_jsonPath << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+} // end of "main"
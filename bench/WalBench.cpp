@@ -0,0 +1,79 @@
+// ============================================================================
+// File: WalBench.cpp
+// ============================================================================
+// Measures CWalBST Add throughput under different write/sync policies.  Each
+// policy starts from an empty snapshot and log in the current directory.
+//
+// The CMake project builds it; to build it by hand from the repository root:
+//		g++ -std=c++17 -O2 -pthread -I. bench/WalBench.cpp CSnapshotIO.cpp
+//			CPersonInfo.cpp NotFoundException.cpp PrecondViolatedExcept.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+#include "CWalBST.h"
+
+// ==== RunPolicy =============================================================
+//
+// Adds count ints to a fresh log-backed tree and prints the throughput.
+//
+// Input:
+//		name	[IN] - label printed with the result
+//		policy	[IN] - the write/sync policy to measure
+//		count	[IN] - the number of Add calls
+//
+// Output:
+//		nothing
+//
+// ============================================================================
+void RunPolicy(const char *name, const CWalPolicy &policy, int count)
+{
+	remove("walbench.snap");
+	remove("walbench.wal");
+
+	CWalBST<int> tree(policy);
+	if (!tree.Open("walbench.snap", "walbench.wal"))
+	{
+		cerr << "Error opening walbench files\n";
+		exit(EXIT_FAILURE);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int index = 0; index < count; ++index)
+	{
+		tree.Add(index);
+	}
+	tree.Sync();
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << ": " << count << " adds in " << elapsed.count()
+		 << " s (" << count / elapsed.count() << " adds/s)" << endl;
+
+	tree.Close();
+	remove("walbench.snap");
+	remove("walbench.wal");
+}
+
+// ==== main ==================================================================
+//
+// ============================================================================
+int main(int argc, char *argv[])
+{
+	int count = 2000;
+	if (argc > 1)
+	{
+		count = atoi(argv[1]);
+	}
+
+	RunPolicy("fsync every record  ", CWalPolicy(1, 0, true), count);
+	RunPolicy("fsync every 16      ", CWalPolicy(16, 0, true), count);
+	RunPolicy("fsync every 256     ", CWalPolicy(256, 0, true), count);
+	RunPolicy("fsync every 5 ms    ", CWalPolicy(1 << 30, 5, true), count);
+	RunPolicy("write only, no fsync", CWalPolicy(1, 0, false), count);
+
+	return 0;
+} // end of "main"
@@ -14,12 +14,13 @@
 // ============================================================================
 
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
+#include <vector>
 using namespace std;
 
 #include "CBST.h"
 #include "CPersonInfo.h"
+#include "CPersonLoader.h"
 
 // global constants
 const int MAX_ITEMS = 30;
@@ -39,8 +40,8 @@ int main()
 
 	CBST<CPersonInfo> treeList;	   // create a tree list
 	CPersonInfo people[MAX_ITEMS]; // allocate an array of CPersonInfo
-	ifstream inFile("PersonBankInfo.txt");
-	char header[256];
+	CPersonLoader loader;		   // reader/parser pipeline for the file
+	vector<CPersonInfo> loaded;
 	int index;
 
 	treeExample.Add(1);
@@ -91,19 +92,17 @@ int main()
 	cout << "Check if it contians 4: ";
 	cout << treeExample.Contains(4) << endl;
 
-	if (inFile.fail())
+	// Read all the items in the file, skipping the header line ("First",
+	// "Last", ... , "Savings"), and store them in a CPersonInfo array
+	if (!loader.LoadFile("PersonBankInfo.txt", loaded))
 	{
 		cerr << "Error opening \"PersonBankInfo.txt\"...\n\n";
 		exit(EXIT_FAILURE);
 	}
 
-	// Get rid of the header in the file ("First", "Last", ... , "Savings")
-	inFile.getline(header, 256);
-
-	// Read all the items in the file and store in a CPersonInfo array
-	for (index = 0; index < MAX_ITEMS; ++index)
+	for (index = 0; index < MAX_ITEMS && index < (int)loaded.size(); ++index)
 	{
-		inFile >> people[index]; // usage of overloaded stream operator
+		people[index] = loaded[index];
 	}
 
 	// Add 20 items (CPersonInfo) to the treeList and remove them to test it.
@@ -169,7 +168,7 @@ int main()
 // ============================================================================
 void Visit(CPersonInfo &item)
 {
-	cout << item << endl; // usage of overloaded stream operator
+	cout << item << '\n'; // usage of overloaded stream operator
 }
 
 // ==== VisitInt ==============================================================
@@ -185,5 +184,5 @@ void Visit(CPersonInfo &item)
 // ============================================================================
 void VisitInt(int &item)
 {
-	cout << item << endl; // usage of overloaded stream operator
+	cout << item << '\n'; // usage of overloaded stream operator
 }